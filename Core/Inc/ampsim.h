@@ -0,0 +1,53 @@
+#ifndef AMPSIM_H
+#define AMPSIM_H
+
+#include <stdint.h>
+#include "arm_math.h"
+
+/*Amp simulator: a cascade of preamp gain stages followed by a passive three band
+tone stack. Each stage is an interstage band limit (coupling cap high-pass and
+Miller capacitance low-pass, one biquad), a gain and a biased tanh, which clips
+the two half waves differently; stages invert like a common cathode triode.
+The tone stack is the Fender/Marshall TMB network (Yeh & Smith), a third order
+filter turned digital with the bilinear transform and split into two biquads.
+Coefficients are only recomputed when a parameter changes, filtering runs per
+block through the CMSIS biquad cascades.*/
+
+#define AMP_MAX_STAGES 6
+
+typedef struct AmpStage_t{
+    float gain;
+    float bias;           // tanh operating point, sets the asymmetry
+    float offset;         // tanh(bias), removes the DC of the operating point
+    float coeffs[5];
+    float state[2];
+    arm_biquad_cascade_df2T_instance_f32 filt;
+}AmpStage_t;
+
+typedef struct AmpSim_t{
+    float sample_rate;
+    uint32_t stages;
+    AmpStage_t stage[AMP_MAX_STAGES];
+
+    float toneCoeffs[2 * 5];
+    float toneState[2 * 2];
+    arm_biquad_cascade_df2T_instance_f32 tone;
+
+    // Cached parameters, a setter only redesigns when its value changes
+    float gain;
+    float bass, mid, treble;
+    float output;
+}AmpSim_t;
+
+// stages: 1..AMP_MAX_STAGES
+void AmpSim_Init(AmpSim_t* amp, float sample_rate, uint32_t stages);
+// Total preamp gain (linear, >= 1), spread evenly over the stages
+void AmpSim_SetGain(AmpSim_t* amp, float gain);
+// Pot positions 0..1 (bass has the audio taper of the real pot)
+void AmpSim_SetTone(AmpSim_t* amp, float bass, float mid, float treble);
+void AmpSim_SetOutput(AmpSim_t* amp, float output);
+
+// n <= BLOCK_SIZE_FLOAT, in and out may alias
+void AmpSim_ProcessBlock(AmpSim_t* amp, const float* in, float* out, uint32_t n);
+
+#endif // AMPSIM_H
@@ -2,6 +2,9 @@
 #define AUDIO_PROCESSING_H
 
 #include <stdint.h>
+#include "dsp_configuration.h"
+#include "looper.h"
+#include "eq.h"
 
 typedef enum I2S_DMA_Callback_State_t {
   I2S_DMA_CALLBACK_IDLE = 0,
@@ -10,10 +13,18 @@ typedef enum I2S_DMA_Callback_State_t {
 } I2S_DMA_Callback_State_t;
 
 extern void processAudio(void);
+extern void audio_Background(void);
 
 extern uint16_t* audio_getTxBuf(void);
 extern uint16_t* audio_getRxBuf(void);
 extern void audio_SetCallbackState(I2S_DMA_Callback_State_t state);
 extern void audio_InitFX(void);
+#ifdef LOOPER_ENABLE
+extern Looper_t* audio_getLooper(void);
+#endif
+#ifdef EQ_ENABLE
+// Setters may be called from the main loop, the bands change at the next block
+extern EQ_t* audio_getEQ(void);
+#endif
 
 #endif // AUDIO_PROCESSING_H
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef AUTOWAH_H
+#define AUTOWAH_H
+
+#include <stdint.h>
+#include "tpt.h"
+
+/*Envelope controlled wah: a resonant band pass per channel on the TPT state-variable
+kernel, its centre swept exponentially between two corners by a position that comes in
+once per block, normally the input envelope through the modulation matrix. The band pass
+has unity gain at the peak, mix blends it over the dry signal.*/
+
+typedef struct AutoWah_t{
+    float sample_rate;
+    float minHz, octaves;
+    float q;
+    float mix;
+    TPT_SVF_t left, right;
+}AutoWah_t;
+
+void AutoWah_Init(AutoWah_t* aw, float sample_rate, float min_hz, float max_hz, float q, float mix);
+
+// Stereo in place, position 0..1 for the block
+void AutoWah_ProcessBlock(AutoWah_t* aw, float* l, float* r, uint32_t n, float pos);
+
+#endif // AUTOWAH_H
@@ -0,0 +1,71 @@
+#ifndef CABSIM_H
+#define CABSIM_H
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "dsp_configuration.h"
+
+/*Speaker cabinet simulation: uniformly partitioned FFT convolution (overlap-save).
+The impulse response is cut into partitions of P taps, each stored as the 2P point
+spectrum of the zero padded partition. Every P input samples one FFT of the last 2P
+inputs enters the frequency-domain delay line (FDL) and the output frame is the IFFT of
+sum(X[j-m] * H[m]). P is a multiple of the audio block: the FDL products of the older
+frames are spread over the P/BLOCK_SIZE_FLOAT blocks, only partition 0 and the two FFTs
+run in the block that completes a frame. Latency is P - BLOCK_SIZE_FLOAT samples.
+
+Background instances only collect input and play results in the audio path. The frame
+work (FFT, one item per partition, IFFT) is run item by item by CabSim_BackgroundStep
+from idle time and has one frame period to finish, latency is 2P - BLOCK_SIZE_FLOAT.*/
+
+#define CAB_MIN_PARTITION 32   // 2P must be an arm_rfft_fast_f32 length with generated tables
+#define CAB_MAX_PARTITION 1024 // sizes the shared FFT work buffer
+
+// Floats for the shared IR spectra and for each channel (FDL + time domain buffers)
+#define CAB_PARTITIONS(taps, part) (((taps) + (part) - 1) / (part))
+#define CAB_IR_SIZE(taps, part) (CAB_PARTITIONS(taps, part) * 2 * (part))
+#define CAB_CHANNEL_SIZE(taps, part) (CAB_IR_SIZE(taps, part) + 5 * (part))
+#define CAB_BACKGROUND_SIZE(taps, part) (CAB_IR_SIZE(taps, part) + 8 * (part))
+
+typedef struct CabIR_t{
+    float* spectra;       // partitions * 2P, arm_rfft_fast_f32 packed format
+    uint32_t partSize;
+    uint32_t partitions;
+    arm_rfft_fast_instance_f32 fft;
+}CabIR_t;
+
+typedef struct CabSim_t{
+    const CabIR_t* ir;
+    float* fdl;           // spectra of the last 'partitions' input frames
+    float* frame;         // previous + current input frame (2P)
+    float* acc;           // output spectrum being accumulated (2P)
+    float* out;           // last output frame (P)
+    uint32_t head;        // FDL slot of the newest frame
+    uint32_t fill;        // samples of the current frame received
+    uint32_t nextPart;    // next FDL partition to accumulate for this frame
+
+    uint8_t background;
+    float* next;          // result of the frame in flight (P)
+    float* job;           // input snapshot, then FFT scratch (2P)
+    uint32_t jobStep;     // next work item of the frame in flight, 0 when done
+    uint32_t overruns;    // frames the audio path had to finish itself
+}CabSim_t;
+
+// IR from an array of taps (gain applied while loading), spectra holds CAB_IR_SIZE floats.
+// Returns 0 if the partition size is not supported.
+uint8_t CabIR_Init(CabIR_t* ir, float* spectra, uint32_t partSize, const float* taps, uint32_t len, float gain);
+// Built-in closed back 4x12 style response, normalised to 0 dB peak
+uint8_t CabIR_InitDefault(CabIR_t* ir, float* spectra, uint32_t partSize, uint32_t len);
+
+// One instance per channel, the IR can be shared. mem holds CAB_CHANNEL_SIZE floats.
+void CabSim_Init(CabSim_t* cab, const CabIR_t* ir, float* mem);
+void CabSim_Reset(CabSim_t* cab);
+
+// Work runs in CabSim_BackgroundStep, mem holds CAB_BACKGROUND_SIZE floats
+void CabSim_InitBackground(CabSim_t* cab, const CabIR_t* ir, float* mem);
+
+// n == BLOCK_SIZE_FLOAT and a divisor of the partition size, in and out may alias
+void CabSim_ProcessBlock(CabSim_t* cab, const float* in, float* out, uint32_t n);
+// Runs one work item of a background instance, returns 0 when there is nothing to do
+uint8_t CabSim_BackgroundStep(CabSim_t* cab);
+
+#endif // CABSIM_H
@@ -0,0 +1,69 @@
+#ifndef COMPRESSOR_H
+#define COMPRESSOR_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+
+/*Stereo-linked feed-forward compressor / limiter with look-ahead. Per block, the detector
+runs over the whole block with CMSIS vector ops: the peak of |l| and |r| per sample, or
+for RMS the mean square of the block (arm_power_f32) smoothed over COMP_RMS_MS of blocks.
+The level goes to the log2 domain (Fast_Log2), through a soft knee gain computer and
+attack/release smoothing of the gain reduction, and back with Fast_Exp2.
+
+With look-ahead the audio is delayed by L samples. The reduction is held at its minimum
+over the last L + 1 samples before the smoothing and averaged over L samples after it,
+so the gain ramps down over the look-ahead and is fully down when the peak arrives. With
+a zero attack time that makes a brickwall: the gain at a sample is never above what the
+gain computer asked for it (up to the log2/exp2 error, 0.007 dB).*/
+
+#define COMP_MAX_LOOKAHEAD 128   // samples, 2.7 ms at 48 kHz
+#define COMP_RATIO_INF 0.0f      // ratio for a limiter
+#define COMP_RMS_MS 10.0f
+
+typedef enum {
+    COMP_PEAK,
+    COMP_RMS
+} Comp_Detector_t;
+
+typedef struct Compressor_t{
+    float sample_rate;
+    Comp_Detector_t detector;
+    uint32_t lookahead;
+
+    // Gain computer and ballistics, levels in log2 units (6.02 dB)
+    float threshold, knee, slope;
+    float makeup;
+    float attackCoeff, releaseCoeff;
+    float rmsCoeff;                 // per block
+    float ms;                       // smoothed mean square
+    float env;                      // smoothed reduction, <= 0
+
+    // Look-ahead: audio delay, running minimum (monotonic deque) and average
+    uint32_t pos;                   // write position of delayL/R and avg
+    uint32_t count;                 // samples seen, indexes the deque
+    float delayL[COMP_MAX_LOOKAHEAD];
+    float delayR[COMP_MAX_LOOKAHEAD];
+    float minVal[COMP_MAX_LOOKAHEAD + 2];
+    uint32_t minIdx[COMP_MAX_LOOKAHEAD + 2];
+    uint32_t head, tail;            // deque front and one past the back, mod L + 2
+    float avg[COMP_MAX_LOOKAHEAD];
+
+    float level[BLOCK_SIZE_FLOAT];
+    float scratch[BLOCK_SIZE_FLOAT];
+}Compressor_t;
+
+// lookahead_ms up to COMP_MAX_LOOKAHEAD samples; starts at unity gain, no compression
+void Compressor_Init(Compressor_t* c, float sample_rate, float lookahead_ms, Comp_Detector_t detector);
+/*ratio >= 1 or COMP_RATIO_INF, knee width in dB (0: hard), attack 0 for an instant one
+(with look-ahead: brickwall)*/
+void Compressor_SetParams(Compressor_t* c, float threshold_dB, float ratio, float knee_dB,
+                          float attack_ms, float release_ms, float makeup_dB);
+// Frames the look-ahead delays the signal by
+uint32_t Compressor_Latency(const Compressor_t* c);
+// Current gain reduction (>= 0)
+float Compressor_Reduction_dB(const Compressor_t* c);
+
+// Stereo in place, n <= BLOCK_SIZE_FLOAT
+void Compressor_ProcessBlock(Compressor_t* c, float* l, float* r, uint32_t n);
+
+#endif // COMPRESSOR_H
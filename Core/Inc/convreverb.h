@@ -0,0 +1,47 @@
+#ifndef CONVREVERB_H
+#define CONVREVERB_H
+
+#include <stdint.h>
+#include "cabsim.h"
+#include "dsp_configuration.h"
+
+/*Convolution reverb with non-uniform partitions (Gardner style).
+Level 0 uses partitions of one audio block, processed in the audio path with zero latency.
+Levels 1 and 2 use partitions of CONVREV_P1 / CONVREV_P2 as background convolvers: their
+frame work is spread over the idle time between blocks by ConvReverb_Background.
+A background level has a latency of 2P - BLOCK_SIZE_FLOAT, so it starts at that IR offset
+and the previous level covers everything before it.*/
+
+#define CONVREV_LEVELS 3
+#define CONVREV_P1 256
+#define CONVREV_P2 1024  // one item (rfft of 2*P2) must fit in the idle time of a block
+
+// Upper bound of the level memory in floats: spectra + FDL round each level up by a partition
+#define CONVREV_MEM_SIZE(taps) (4 * (taps) + 9 * BLOCK_SIZE_FLOAT + 12 * (CONVREV_P1 + CONVREV_P2))
+
+typedef struct ConvReverb_t{
+    CabIR_t ir[CONVREV_LEVELS];
+    CabSim_t level[CONVREV_LEVELS];
+    uint32_t levels;      // levels holding part of the IR
+    float mix;
+    float mono[BLOCK_SIZE_FLOAT];
+    float wet[BLOCK_SIZE_FLOAT];
+    float tmp[BLOCK_SIZE_FLOAT];
+}ConvReverb_t;
+
+// Decaying noise tail, darker as it decays; normalised to 0.5 energy
+void ConvReverb_GenerateIR(float* taps, uint32_t len, float rt60_s, float damping);
+
+// taps are only read during init. Returns 0 if mem (memSize floats) is too small.
+uint8_t ConvReverb_Init(ConvReverb_t* cr, float* mem, uint32_t memSize, const float* taps, uint32_t len, float mix);
+void ConvReverb_SetMix(ConvReverb_t* cr, float mix);
+
+// Mono reverb of (l+r)/2 mixed into both channels in place, n == BLOCK_SIZE_FLOAT
+void ConvReverb_ProcessBlock(ConvReverb_t* cr, float* l, float* r, uint32_t n);
+// One work item of the most urgent background level, call from the idle loop.
+// Returns 0 when all levels are up to date.
+uint8_t ConvReverb_Background(ConvReverb_t* cr);
+// Frames the audio path had to complete because the background fell behind
+uint32_t ConvReverb_Overruns(const ConvReverb_t* cr);
+
+#endif // CONVREVERB_H
@@ -3,9 +3,27 @@
 
 #include <stdint.h>
 #include "dsp_configuration.h"
+#include "distortion.h"
 
 #define DELAY_MAX_LENGTH SAMPLE_RATE/2 // 0.5 second at any sample rate
 
+/*Optional "tape" section inside the feedback loop: HPF -> LPF -> soft saturation,
+plus wow/flutter modulation of the read head. No transcendental calls per sample.
+Filter state is per channel ([0] left / mono, [1] right); the LFOs step once per frame.*/
+typedef struct FX_DelayTape_t{
+    uint8_t enabled;
+    OnePoleHPF hpf[2];
+    OnePoleLPF lpf[2];
+
+    float drive;        // saturator input gain
+    float driveInv;     // makeup so small signals pass at unity
+
+    float wowDepth;     // samples
+    float flutterDepth; // samples
+    uint32_t wowPhase, wowInc;         // Q32 phase accumulators
+    uint32_t flutterPhase, flutterInc;
+}FX_DelayTape_t;
+
 typedef struct FX_Delay_t{
     float mix;
     float feedback;
@@ -14,11 +32,30 @@ typedef struct FX_Delay_t{
 
     uint32_t delayLength; // delay time == delay line length / sample rate
 
+    FX_DelayTape_t tape;
+
     float out;
 }FX_Delay_t;
 
+/*Linear interpolated read of a circular line, offs (>= 0) samples on from index pos.
+With pos the write index the read is len - offs samples old.*/
+static inline float Delay_ReadFrac(const float* line, uint32_t len, uint32_t pos, float offs) {
+    uint32_t o = (uint32_t)offs;
+    float frac = offs - (float)o;
+    uint32_t i0 = pos + o;
+    if (i0 >= len) i0 -= len;
+    uint32_t i1 = i0 + 1;
+    if (i1 >= len) i1 = 0;
+    return line[i0] + frac * (line[i1] - line[i0]);
+}
+
 void    FX_Delay_Init(FX_Delay_t* dly, uint32_t delayTime_ms, float mix, float feedback);
 float   FX_Do_Delay(FX_Delay_t* dly, float inSample);
+/*Stereo frame on the same line, the channels interleaved in it: each gets every other
+sample, half the line length of delay. Use one of the two entry points per instance.*/
+void    FX_Do_DelayStereo(FX_Delay_t* dly, float* l, float* r);
 void    FX_Delay_SetLength(FX_Delay_t* dly, uint32_t delayTime_ms);
+void    FX_Delay_SetTape(FX_Delay_t* dly, float lpf_hz, float hpf_hz, float drive, float wow_ms, float flutter_ms);
+void    FX_Delay_EnableTape(FX_Delay_t* dly, uint8_t enable);
 
-#endif // DELAY_H
\ No newline at end of file
+#endif // DELAY_H
@@ -1,10 +1,16 @@
 #ifndef DS1_H
 #define DS1_H
 
+#include <stdint.h>
+#include "halfband.h"
+#include "waveshaper.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define DS1_MAX_OVERSAMPLE 8 // 3 cascaded half-band stages
+
 typedef struct {
     float a0, b1, z1;
 } OnePoleLPF;
@@ -16,7 +22,15 @@ typedef struct {
 typedef enum {
     CLIP_HARD,
     CLIP_TANH,
-    CLIP_ASYM
+    CLIP_ASYM,
+    // Antiderivative anti-aliased variants (1st order: +0.5 sample delay, 2nd order: +1 sample)
+    CLIP_HARD_ADAA1,
+    CLIP_TANH_ADAA1,
+    CLIP_ASYM_ADAA1,
+    CLIP_HARD_ADAA2,
+    CLIP_TANH_ADAA2,
+    CLIP_ASYM_ADAA2,
+    CLIP_SHAPER         // table waveshaper selected with DS1_SetShaper
 } ClipType;
 
 typedef struct DS1 {
@@ -26,12 +40,43 @@ typedef struct DS1 {
     OnePoleLPF tone;
     OnePoleHPF hpf;
     float sample_rate;
+
+    // ADAA history: previous inputs, antiderivative at x1, previous divided difference
+    float adaa_x1, adaa_x2;
+    float adaa_Fx1;
+    float adaa_D;
+
+    Waveshaper_t shaper;
+
+    uint32_t os_stages;   // oversampling factor = 1 << os_stages
+    HalfBand_t up[3];
+    HalfBand_t down[3];
 } DS1;
 
 
+// One-pole filters, shared with other effects (e.g. delay feedback path)
+void OnePoleLPF_Init(OnePoleLPF *f);
+void OnePoleLPF_Set(OnePoleLPF *f, float sample_rate, float cutoff_hz);
+void OnePoleHPF_Init(OnePoleHPF *f);
+void OnePoleHPF_Set(OnePoleHPF *f, float sample_rate, float cutoff_hz);
+
+static inline float OnePoleLPF_Process(OnePoleLPF *f, float x){
+    f->z1 = f->a0*x + f->b1*f->z1;
+    return f->z1;
+}
+
+static inline float OnePoleHPF_Process(OnePoleHPF *f, float x){
+    float y = f->a0 * (x - f->z1) + f->b1 * f->z1;
+    f->z1 = x;
+    return y;
+}
+
 void DS1_Init(DS1 *fx, float sample_rate);
 void DS1_SetParams(DS1 *fx, float drive, float output, float tone_hz, float hpf_hz, ClipType type);
-float DS1_ProcessSample(DS1 *fx, float in);
+void DS1_SetOversampling(DS1 *fx, uint32_t factor); // 1, 2, 4 or 8
+void DS1_SetShaper(DS1 *fx, WS_Curve_t curve, WS_Interp_t interp);
+float DS1_ProcessSample(DS1 *fx, float in);         // no oversampling
+void DS1_ProcessBlock(DS1 *fx, const float *in, float *out, uint32_t n); // n <= BLOCK_SIZE_FLOAT
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,41 @@
+#ifndef DSP_BENCH_H
+#define DSP_BENCH_H
+
+#include <stdint.h>
+#include "SEGGER_SYSVIEW.h"
+
+/*Cycle counter micro benchmarks (DWT CYCCNT, already enabled by SystemView).
+Run once from audio_InitFX before the I2S DMA starts when DSP_BENCH_ENABLE is set,
+results are printed to the host over SystemView.*/
+
+#define DSP_BENCH_BLOCKS 256 // blocks of BLOCK_SIZE_FLOAT frames per measurement
+
+#define DSP_Bench_Start() ((uint32_t)SEGGER_SYSVIEW_GET_TIMESTAMP())
+
+// Fill a buffer with a deterministic guitar-like test signal (decaying saw + noise)
+void DSP_Bench_FillInput(float* buf, uint32_t len);
+
+// Print "name: cycles/frame" for a measurement that started at 'start' and covered 'frames'
+uint32_t DSP_Bench_Report(const char* name, uint32_t start, uint32_t frames);
+
+// Single-bin DFT for level measurements on coherently sampled test tones
+typedef struct DSP_Goertzel_t{
+    float coeff;
+    float s1, s2;
+}DSP_Goertzel_t;
+
+void DSP_Goertzel_Init(DSP_Goertzel_t* g, float freq_hz);
+void DSP_Goertzel_Push(DSP_Goertzel_t* g, const float* buf, uint32_t n);
+float DSP_Goertzel_Power(const DSP_Goertzel_t* g);
+
+// Stereo in place, the shape of the effects' ProcessBlock
+typedef void (*DSP_Bench_Process_t)(void* fx, float* l, float* r, uint32_t n);
+
+/*Tone fixture: a sine of 'amp' at 'hz' on both channels through 'process', block by block.
+After 'settle' samples, 'measure' more (both whole blocks) go into the Goertzel filters:
+the input into 'in', the left output into each of out[0..bins - 1], 'in' may be NULL.
+Returns the mean square of the measured left output.*/
+float DSP_Bench_Tone(DSP_Bench_Process_t process, void* fx, float hz, float amp, uint32_t settle, uint32_t measure,
+                     DSP_Goertzel_t* in, DSP_Goertzel_t* out, uint32_t bins);
+
+#endif // DSP_BENCH_H
@@ -3,13 +3,46 @@
 
 /*Main Audio engine settings*/
 #define BLOCK_SIZE_U16 128
-#define BLOCK_SIZE_FLOAT BLOCK_SIZE_U16 / 4
+#define BLOCK_SIZE_FLOAT (BLOCK_SIZE_U16 / 4)
 #define SAMPLE_RATE 48000
 
 /*Effects compile settings*/
+//#define GATE_ENABLE // noise gate at the chain head, skips the chain while closed and silent
 #define REVERB_ENABLE
 #define DELAY_ENABLE
 #define OVERDRIVE_ENABLE
+//#define NEURAL_AMP_ENABLE // GRU amp model in place of the DS1 stage, left input to both channels; model and weight bits are the NEURAL_AMP_MODEL / NEURAL_AMP_WEIGHT_BITS CMake options
+//#define AMPSIM_ENABLE
+#define CAB_ENABLE
+//#define EQ_ENABLE
+//#define COMP_ENABLE
+//#define MOD_ENABLE // tremolo and auto-pan from the control-rate modulation matrix, ahead of the delay
+//#define PHASER_ENABLE // stereo phaser swept by modulation LFOs 2 and 3, after the tremolo
+//#define AUTOWAH_ENABLE // band pass swept by the input envelope, ahead of the drive
+//#define HARMONIZER_ENABLE // pitch shifted voices over the dry signal, ahead of the delay
+//#define LIMITER_ENABLE
+#define TRUEPEAK_ENABLE // true-peak limiting output converter in place of the hard clamps
+//#define LOOPER_ENABLE
+//#define CONVREV_ENABLE
+//#define TUNER_ENABLE // pitch detection on the left input from the idle loop, notes over RTT
+//#define FDN_ENABLE // with REVERB_ENABLE: FDN reverb in place of the Schroeder one
+//#define PLATE_ENABLE // with REVERB_ENABLE: Dattorro plate in place of the Schroeder one
+//#define SHIMMER_ENABLE // with REVERB_ENABLE: pitch shifter in a feedback loop around the reverb
+
+/*Cycle benchmarks run once at init, results over SystemView/RTT*/
+//#define DSP_BENCH_ENABLE
+
+/*Noise gate on the converter input, block RMS of both channels. The PCM1808 floor sits
+near -95 dBFS, played notes decay through the gap between the open and close levels.
+The chain is skipped once the output has been under GATE_SILENCE_DB for GATE_TAIL_MS:
+keep that above the delay time (DELAY_MAX_LENGTH is 0.5 s) so repeats are not cut*/
+#define GATE_OPEN_DB -62.0f
+#define GATE_HYSTERESIS_DB 8.0f
+#define GATE_HOLD_MS 60.0f
+#define GATE_ATTACK_MS 0.5f
+#define GATE_RELEASE_MS 120.0f
+#define GATE_SILENCE_DB -100.0f
+#define GATE_TAIL_MS 600.0f
 
 #define OD_GAIN_MIN 1.0f
 #define OD_GAIN_SCALE 50.0f
@@ -21,5 +54,152 @@
 #define OD_LPF_CUTOFF_MAX 2500.0f
 #define OD_LPF_CUTOFF_SCALE 7500.0f
 #define OD_LPF_DAMP 1.0f
+#define OD_OVERSAMPLE 4 // clipper oversampling: 1, 2, 4 or 8
+
+/*Amp simulator (preamp stages + tone stack) in place of the DS1 stage, per channel*/
+#define AMP_STAGES 4 // 1..AMP_MAX_STAGES
+#define AMP_GAIN 60.0f
+
+/*Cabinet IR convolution after the drive stage. RAM: 8 bytes per tap for the IR spectra
+plus 8 bytes per tap and channel for the frequency-domain delay line*/
+#define CAB_IR_TAPS 1024   // 1024..4096
+#define CAB_PARTITION 128  // power of two, multiple of BLOCK_SIZE_FLOAT, 64..512; latency CAB_PARTITION - BLOCK_SIZE_FLOAT
+
+/*Parametric EQ after the cab, four of its EQ_MAX_BANDS bands set here. Shelves and the
+peak at 0 dB are left out of the cascade and cost nothing*/
+#define EQ_HPF_HZ 40.0f
+#define EQ_LOW_HZ 120.0f
+#define EQ_LOW_DB 0.0f
+#define EQ_MID_HZ 800.0f
+#define EQ_MID_Q 0.8f
+#define EQ_MID_DB 0.0f
+#define EQ_HIGH_HZ 5000.0f
+#define EQ_HIGH_DB 0.0f
+
+/*Compressor after the EQ, ahead of the delay and reverbs. The look-ahead delays the dry
+path too (up to COMP_MAX_LOOKAHEAD samples), both latencies are printed at init*/
+#define COMP_DETECTOR COMP_RMS  // COMP_RMS (block mean square) or COMP_PEAK
+#define COMP_THRESHOLD_DB -24.0f
+#define COMP_RATIO 3.0f
+#define COMP_KNEE_DB 6.0f
+#define COMP_ATTACK_MS 10.0f
+#define COMP_RELEASE_MS 150.0f
+#define COMP_MAKEUP_DB 6.0f
+#define COMP_LOOKAHEAD_MS 0.0f
+
+/*Tremolo on LFO 0, depth 0..1 of the level; auto-pan on LFO 1, depth 0..1 of the sweep.
+The input envelope is source MOD_SRC_ENV(0), followed with the times below*/
+#define MOD_TREMOLO_HZ 5.0f
+#define MOD_TREMOLO_DEPTH 0.5f
+#define MOD_PAN_HZ 0.25f
+#define MOD_PAN_DEPTH 0.8f
+#define MOD_SMOOTH_MS 5.0f
+#define MOD_ENV_ATTACK_MS 5.0f
+#define MOD_ENV_RELEASE_MS 150.0f
+#define MOD_ENV_FLOOR_DB -60.0f   // RMS that reads as 0, 0 dBFS reads as 1
+
+/*Phaser: 4..12 stages give 2..6 notches swept between the corners, the right channel's
+LFO runs PHASER_STEREO_PHASE of a cycle ahead*/
+#define PHASER_STAGES 6
+#define PHASER_MIN_HZ 200.0f
+#define PHASER_MAX_HZ 2500.0f
+#define PHASER_FEEDBACK 0.5f
+#define PHASER_RATE_HZ 0.4f
+#define PHASER_STEREO_PHASE 0.25f
+
+/*Auto-wah: at sensitivity 1 the sweep tops out at 0 dBFS RMS, at 1.5 two thirds of the way
+up from MOD_ENV_FLOOR_DB (-20 dBFS)*/
+#define AUTOWAH_MIN_HZ 350.0f
+#define AUTOWAH_MAX_HZ 2200.0f
+#define AUTOWAH_Q 4.0f
+#define AUTOWAH_MIX 0.9f
+#define AUTOWAH_SENSITIVITY 1.5f
+
+/*Harmonizer voices, semitones -12..12: a third under the left, a fifth under the right*/
+#define HARM_DRY 1.0f
+#define HARM_VOICE1_SEMITONES 4.0f
+#define HARM_VOICE1_LEVEL 0.5f
+#define HARM_VOICE1_PAN -0.5f
+#define HARM_VOICE2_SEMITONES 7.0f
+#define HARM_VOICE2_LEVEL 0.5f
+#define HARM_VOICE2_PAN 0.5f
+
+/*Brickwall limiter at the output: peak detector, zero attack over the look-ahead*/
+#define LIMITER_CEILING_DB -0.5f
+#define LIMITER_RELEASE_MS 60.0f
+#define LIMITER_LOOKAHEAD_MS 1.0f
+
+/*True-peak output stage. Latency TP_TAPS / 2 + TP_LOOKAHEAD frames, a safety net that
+only acts on overs: the limiter above does the shaping. Host cost in units of the plain
+clamp: 1.2 while blocks peak 4.1 dB or more under the ceiling, 2.8 while the detector has
+to run, 3.5 while limiting (a sample-peak limiter plus the clamp: 2.9)*/
+#define TP_CEILING_DB -0.3f   // dBTP
+#define TP_RELEASE_MS 50.0f
+#define TP_LOOKAHEAD 8        // frames, 0..TP_MAX_LOOKAHEAD
+
+/*Tuner reference pitch and the input RMS under which it reports no note*/
+#define TUNER_A4 440.0f
+#define TUNER_MIN_DB -60.0f
+
+/*Convolution reverb before the looper. About 16 bytes per IR tap, a 1 s IR needs external RAM:
+set CONVREV_POOL_SECTION to the linker section placed there. The tail levels run from the idle loop*/
+#define CONVREV_IR_TAPS SAMPLE_RATE
+#define CONVREV_RT60 2.0f
+#define CONVREV_MIX 0.25f
+//#define CONVREV_POOL_SECTION ".sdram"
+
+/*Schroeder reverb (stereo), delay lines in CCM RAM. Q15 lines take half the pool, which
+buys twice Schroeder's delays: 15399 floats either way (float at size 1, Q15 at size 2).
+They cost about 2.6x the float lines on the host, a conversion per load and per store*/
+#define REVERB_POOL_SIZE 15872 // floats
+#define REVERB_POOL_SECTION ".ccmram"
+#define REVERB_Q15             // comb and allpass lines stored as Q15
+#define REVERB_SIZE 2.0f       // line lengths relative to Schroeder's
+#define REVERB_RT60 1.8f
+#define REVERB_WET 0.25f
+/*The selected reverb runs at SAMPLE_RATE / REVERB_DECIMATION behind a decimate/interpolate
+wrapper: 2 keeps the tail up to ~10 kHz, 3 up to ~6.5 kHz, and the lines shrink by the
+factor. Cycles only drop when the network costs more per frame than the resamplers add
+(about 10 ns/frame at 2, 14 at 3 on the host): Schroeder went 37.3 -> 28.7 -> 27.9
+ns/frame at 1/2/3, the cheaper FDN 13.9 -> 16.6 -> 18.5 (see the reverb benches)*/
+#define REVERB_DECIMATION 1  // 1, 2 or 3
+
+/*FDN reverb, same decay and mix. Its lines fill the CCM pool above first (13285 floats),
+the remainder comes from an SRAM pool*/
+#define FDN_SRAM_POOL_SIZE 3072 // floats, FDN_PoolSize(FDN_DefaultLengths, SAMPLE_RATE) is 16118
+#define FDN_HF_RATIO 0.5f       // decay time at Nyquist relative to REVERB_RT60
+
+/*Dattorro plate, same mix. Per instance Plate_PoolSize(SAMPLE_RATE, size) floats: 36333 (145 KB) at size 1,
+18195 (73 KB) at 0.5, of which 15644 go into the CCM pool and the rest into SRAM*/
+#define PLATE_SIZE 0.5f
+#define PLATE_DECAY 0.7f     // tank gain, 0..0.99
+#define PLATE_DAMPING 0.0005f
+#define PLATE_SRAM_POOL_SIZE 3072 // floats
+
+/*Shimmer around whichever reverb is selected, at its rate. The shifter line has a pool of
+its own in SRAM, SHIMMER_POOL_SIZE(): 1922 floats at 48 kHz, 962 at REVERB_DECIMATION 2.
+The feedback must stay under the bound where the tail starts to grow, measured at 48 kHz
+with the +12 semitones here: Schroeder 0.13 at REVERB_SIZE 1 and 0.25 at 2 (REVERB_RT60
+1.8 s, float or Q15), FDN 0.84 (same RT60), plate 0.66 (PLATE_DECAY 0.7). Reduced rates
+move them by a few percent, except Q15 Schroeder whose truncation lets 0.3..0.4 through*/
+#define SHIMMER_SEMITONES 12.0f
+#define SHIMMER_FEEDBACK 0.2f
+
+/*Spring reverb after the delay: SPRING_COUNT dispersive springs at SAMPLE_RATE / 2,
+SPRING_SECTIONS stretched allpasses each (50..100 for a clear chirp)*/
+#define SPRING_COUNT 3     // 1..SPRING_MAX
+#define SPRING_SECTIONS 100
+#define SPRING_RT60 2.0f
+#define SPRING_MIX 0.3f
+
+/*Delay tape feedback section (LPF/HPF, saturation, wow/flutter)*/
+//#define DELAY_TAPE_ENABLE
+#define DELAY_TAPE_WOW_HZ 0.6f
+#define DELAY_TAPE_FLUTTER_HZ 7.0f
+
+/*Looper pool: loop + undo layer. Tens of seconds need external RAM,
+set LOOPER_POOL_SECTION to the linker section placed there*/
+#define LOOPER_POOL_SAMPLES (SAMPLE_RATE * 20 * 2)
+//#define LOOPER_POOL_SECTION ".sdram"
 
 #endif // DSP_CFG_H
\ No newline at end of file
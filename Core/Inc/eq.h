@@ -0,0 +1,71 @@
+#ifndef EQ_H
+#define EQ_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+#include "arm_math.h"
+
+/*Parametric EQ: up to EQ_MAX_BANDS peaking, shelving, notch or pass bands run as one
+CMSIS biquad cascade per channel over the block. Band coefficients come from the RBJ
+cookbook formulas and are designed by the setters, in the control context, into the
+spare one of two packed coefficient sets; the audio side swaps sets at the next block.
+Only the enabled bands go into the packed set, and a peak or shelf at 0 dB counts as
+disabled, so a bypassed band costs nothing: the cascade is as long as the active bands.
+A band keeps its filter state while the others are switched, so changing one band does
+not click the rest.*/
+
+#define EQ_MAX_BANDS 8
+
+typedef enum {
+    EQ_PEAK,
+    EQ_LOW_SHELF,   // shelf slope S = 1 at Q = 1/sqrt(2)
+    EQ_HIGH_SHELF,
+    EQ_NOTCH,
+    EQ_LOW_PASS,
+    EQ_HIGH_PASS
+} EQ_Type_t;
+
+typedef struct EQ_Band_t{
+    EQ_Type_t type;
+    float freq;           // Hz
+    float q;
+    float gain_dB;        // peak and shelves only
+    uint8_t enabled;
+    float coeffs[5];      // designed when the band changes, copied into the packed set
+}EQ_Band_t;
+
+typedef struct EQ_Set_t{
+    uint32_t stages;
+    uint8_t band[EQ_MAX_BANDS];   // band behind each packed section
+    float coeffs[5 * EQ_MAX_BANDS];
+}EQ_Set_t;
+
+typedef struct EQ_t{
+    float sample_rate;
+    EQ_Band_t band[EQ_MAX_BANDS];
+
+    EQ_Set_t set[2];
+    uint32_t live;                // set the cascades run
+    volatile uint8_t pending;     // the other set is newer
+
+    float stateL[2 * EQ_MAX_BANDS];
+    float stateR[2 * EQ_MAX_BANDS];
+    arm_biquad_cascade_df2T_instance_f32 left, right;
+}EQ_t;
+
+// RBJ biquad in CMSIS order {b0, b1, b2, -a1, -a2}, also the designer of the other effects' fixed filters
+void EQ_Design(float* coeffs, EQ_Type_t type, float freq, float q, float gain_dB, float sample_rate);
+
+// All bands disabled
+void EQ_Init(EQ_t* eq, float sample_rate);
+// Sets and enables a band, returns 0 for a band index out of range
+uint8_t EQ_SetBand(EQ_t* eq, uint32_t band, EQ_Type_t type, float freq, float q, float gain_dB);
+void EQ_SetGain(EQ_t* eq, uint32_t band, float gain_dB);
+void EQ_EnableBand(EQ_t* eq, uint32_t band, uint8_t enable);
+// Biquads in the cascade once the pending set is taken up
+uint32_t EQ_ActiveBands(const EQ_t* eq);
+
+// Stereo in place, n <= BLOCK_SIZE_FLOAT
+void EQ_ProcessBlock(EQ_t* eq, float* l, float* r, uint32_t n);
+
+#endif // EQ_H
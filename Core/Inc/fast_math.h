@@ -0,0 +1,40 @@
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <stdint.h>
+
+/*log2 and exp2 for gain computation in the log domain. The exponent comes straight from
+the float's bits and a cubic covers the octave; both cubics are exact at the octave ends,
+so the curves have no steps. log2 is within 0.0011 (0.006 dB), exp2 within 1.1e-4
+relative (0.001 dB). tan is for filter prewarping.*/
+
+#define FAST_DB_PER_LOG2 6.0205999f   // 20 log10(2)
+
+// x > 0 and normal; denormals and 0 come out near -127
+static inline float Fast_Log2(float x) {
+    union { float f; uint32_t i; } v = { x };
+    float e = (float)((int32_t)(v.i >> 23) - 127);
+    v.i = (v.i & 0x007FFFFFu) | 0x3F800000u;
+    float t = v.f - 1.0f;
+    return e + t * (1.4208645f + t * (-0.5772507f + t * 0.1563861f));
+}
+
+// Flushes to 0 below 2^-126
+static inline float Fast_Exp2(float x) {
+    if (x < -126.0f) return 0.0f;
+    if (x > 127.0f) x = 127.0f;
+    int32_t i = (int32_t)x;
+    if ((float)i > x) i--;
+    float t = x - (float)i;
+    union { float f; uint32_t i; } v = { .i = (uint32_t)(i + 127) << 23 };
+    return v.f * (1.0f + t * (0.6955020f + t * (0.2262698f + t * 0.0782282f)));
+}
+
+// Pade [3/4] of tan, 0 <= x <= 1.45 (fc up to 0.46 fs): within 2e-5 relative up to 1,
+// 0.2% at the top
+static inline float Fast_Tan(float x) {
+    float x2 = x * x;
+    return x * (105.0f - 10.0f * x2) / (105.0f + x2 * (x2 - 45.0f));
+}
+
+#endif // FAST_MATH_H
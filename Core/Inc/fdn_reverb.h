@@ -0,0 +1,54 @@
+#ifndef FDN_REVERB_H
+#define FDN_REVERB_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+#include "reverb.h"
+
+/*Feedback delay network reverb (Jot): eight delay lines of mutually prime lengths
+whose outputs are damped and mixed back into all inputs through a Hadamard matrix.
+The matrix is orthogonal, so with unity line gains the loop neither grows nor decays;
+the per-line gains then set the decay and the damping filters make the highs die
+first. The 8x8 Hadamard product runs as three butterfly stages (24 adds) instead of
+64 multiply-adds, its 1/sqrt(8) scale folded into the line gains.
+
+Lines are taken from a list of pools in order, each line from the first pool that
+still has room, so a fast pool (CCM RAM) can hold most of the network and a second
+pool in SRAM the rest. Left and right are two orthogonal output taps of the same
+network, which decorrelates them without a second set of lines.*/
+
+#define FDN_LINES 8
+
+typedef struct FDN_t{
+    uint8_t ready;
+    float rate;
+    float* buf[FDN_LINES];
+    uint32_t len[FDN_LINES];
+    uint32_t pos[FDN_LINES];
+    float gain[FDN_LINES];   // g (1 - p) / sqrt(8)
+    float pole[FDN_LINES];   // damping low-pass pole p
+    float lp[FDN_LINES];     // damping filter states
+    float wet;
+}FDN_t;
+
+// Mutually prime line lengths (primes, 25..59 ms at 48 kHz)
+extern const uint32_t FDN_DefaultLengths[FDN_LINES];
+
+// Floats needed for a set of FDN_LINES lengths (given at SAMPLE_RATE) run at 'rate'
+uint32_t FDN_PoolSize(const uint32_t* len, float rate);
+
+/*Returns 0 if the pools cannot hold the lines. The lengths are given at SAMPLE_RATE and
+scaled to 'rate'. rt60_s is the decay at DC, hf_ratio the decay time at Nyquist
+relative to it (0 < hf_ratio <= 1, 1: no damping).*/
+uint8_t FDN_Init(FDN_t* fdn, Reverb_Pool_t* pools, uint32_t poolCount, const uint32_t* len, float rate,
+                 float rt60_s, float hf_ratio, float wet);
+void FDN_SetDecay(FDN_t* fdn, float rt60_s, float hf_ratio);
+void FDN_SetWet(FDN_t* fdn, float wet);
+
+// Stereo in place, the network is fed the mono sum
+void FDN_ProcessBlock(FDN_t* fdn, float* l, float* r, uint32_t n);
+
+// ReducedRate_t / Shimmer_t process hook
+static inline void FDN_Run(void* fx, float* l, float* r, uint32_t n) { FDN_ProcessBlock(fx, l, r, n); }
+
+#endif // FDN_REVERB_H
@@ -0,0 +1,91 @@
+#ifndef FX_BENCH_H
+#define FX_BENCH_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+#include "delay.h"
+#include "spring_verb.h"
+#include "reverb.h"
+#include "fdn_reverb.h"
+#include "plate_reverb.h"
+#include "reduced_rate.h"
+#include "shimmer.h"
+#include "distortion.h"
+#include "ampsim.h"
+#include "eq.h"
+#include "neural_amp.h"
+#include "cabsim.h"
+#include "convreverb.h"
+#include "tuner.h"
+#include "harmonizer.h"
+
+/*Effect benchmarks for DSP_BENCH_ENABLE, run by audio_processing.c before it sets the
+effects up for real. Each one runs on the live instance and memory it is handed; what a
+bench only compares against (a second reverb, a limiter) is its own. Cycles and accuracy
+figures are printed over SystemView as in dsp_bench.h.*/
+
+// Output converter: float pair to packed DMA words
+typedef void (*FX_Bench_Convert_t)(const float* l, const float* r, uint16_t* tx, uint32_t n);
+
+#ifdef REVERB_ENABLE
+// What the reverb benches borrow: the instances and the pools at their configured sizes
+typedef struct FX_Bench_Reverbs_t{
+    Reverb_t* schroeder;
+    const Reverb_Config_t* cfg;
+    ReducedRate_t* rr;
+    float* pool;                // REVERB_POOL_SIZE
+#ifdef FDN_ENABLE
+    FDN_t* fdn;
+    float* fdnSram;             // FDN_SRAM_POOL_SIZE
+#endif // FDN_ENABLE
+#ifdef PLATE_ENABLE
+    Plate_t* plate;
+    float* plateSram;           // PLATE_SRAM_POOL_SIZE
+#endif // PLATE_ENABLE
+#ifdef SHIMMER_ENABLE
+    Shimmer_t* shimmer;
+    float* shimmerPool;         // SHIMMER_POOL_SIZE(SAMPLE_RATE / REVERB_DECIMATION)
+#endif // SHIMMER_ENABLE
+}FX_Bench_Reverbs_t;
+
+void FX_Bench_Reverbs(const FX_Bench_Reverbs_t* rv);
+#endif // REVERB_ENABLE
+
+void FX_Bench_Delay(FX_Delay_t* dly);
+void FX_Bench_Spring(SpringReverb* spring, float* mem, uint32_t size);
+void FX_Bench_Shaper(void);
+void FX_Bench_DS1(DS1* ds1);
+void FX_Bench_Dynamics(void);
+// 'clamp' is the plain converter the true-peak stage replaces
+void FX_Bench_Output(FX_Bench_Convert_t clamp);
+#ifdef AMPSIM_ENABLE
+void FX_Bench_Amp(AmpSim_t* amp);
+#endif // AMPSIM_ENABLE
+#ifdef EQ_ENABLE
+void FX_Bench_EQ(EQ_t* eq);
+#endif // EQ_ENABLE
+#ifdef NEURAL_AMP_ENABLE
+void FX_Bench_NeuralAmp(NeuralAmp_t* nam);
+#endif // NEURAL_AMP_ENABLE
+#ifdef CAB_ENABLE
+// mem holds 'size' floats, partitions whose channel does not fit are skipped
+void FX_Bench_Cab(CabIR_t* ir, CabSim_t* cab, float* spectra, float* mem, uint32_t size);
+#endif // CAB_ENABLE
+#ifdef CONVREV_ENABLE
+// pool: CONVREV_MEM_SIZE(CONVREV_IR_TAPS) floats of levels, then the CONVREV_IR_TAPS taps
+void FX_Bench_ConvReverb(ConvReverb_t* cr, float* pool);
+#endif // CONVREV_ENABLE
+#ifdef TUNER_ENABLE
+void FX_Bench_Tuner(Tuner_t* tuner);
+#endif // TUNER_ENABLE
+#ifdef HARMONIZER_ENABLE
+void FX_Bench_Harmonizer(Harmonizer_t* harm);
+#endif // HARMONIZER_ENABLE
+#ifdef MOD_ENABLE
+void FX_Bench_ModMatrix(void);
+#endif // MOD_ENABLE
+#if defined(PHASER_ENABLE) || defined(AUTOWAH_ENABLE)
+void FX_Bench_Swept(void);
+#endif // PHASER_ENABLE || AUTOWAH_ENABLE
+
+#endif // FX_BENCH_H
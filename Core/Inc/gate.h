@@ -0,0 +1,51 @@
+#ifndef GATE_H
+#define GATE_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+
+/*Noise gate for the head of the chain. The detector is the mean square of the whole
+block over both channels (two arm_power_f32), compared in the power domain: the gate
+opens above the open level and only starts to close once the level stays under the
+open level minus the hysteresis for the hold time. The gain then ramps down linearly
+over the release time and up over the attack time, interpolated across each block.
+
+Once the gate is closed the chain only carries tails. Gate_WatchTail() is fed the
+chain's output and the gate reports idle once that output has stayed under the
+silence level for the tail window. The engine can then skip the chain until the gate
+opens again. The window has to outlast the longest gap in a tail, i.e. the delay time.*/
+
+typedef enum {
+    GATE_CLOSED,
+    GATE_OPEN,
+    GATE_HOLD,
+    GATE_RELEASE
+} Gate_State_t;
+
+typedef struct Gate_t{
+    Gate_State_t state;
+    float openLevel, closeLevel;    // block mean square
+    float attackStep, releaseStep;  // gain change per block
+    uint32_t holdBlocks, holdCount;
+    float gain;
+
+    float silenceLevel;             // output mean square
+    uint32_t tailBlocks, quietCount;
+    uint8_t idle;
+}Gate_t;
+
+void Gate_Init(Gate_t* g, float sample_rate, float open_dB, float hysteresis_dB,
+               float hold_ms, float attack_ms, float release_ms);
+// Output under silence_dB for tail_ms with the gate closed: idle. Never idle until set.
+void Gate_SetTail(Gate_t* g, float sample_rate, float silence_dB, float tail_ms);
+
+// Stereo in place, n <= BLOCK_SIZE_FLOAT
+void Gate_ProcessBlock(Gate_t* g, float* l, float* r, uint32_t n);
+// The chain's output for the block the gate just processed
+void Gate_WatchTail(Gate_t* g, const float* l, const float* r, uint32_t n);
+// Closed and the tails have died away: the chain may be skipped
+static inline uint8_t Gate_Idle(const Gate_t* g) {
+    return g->idle;
+}
+
+#endif // GATE_H
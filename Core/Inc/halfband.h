@@ -0,0 +1,30 @@
+#ifndef HALFBAND_H
+#define HALFBAND_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+
+/*Polyphase half-band FIR resamplers (2x up / 2x down).
+A half-band filter of 4K-1 taps has a centre tap of 0.5 and only K distinct
+non-zero odd taps per side, so each output costs K multiplies per phase.
+Cascade stages for 4x/8x; later stages can use a smaller K.*/
+
+#define HB_MAX_K 12
+#define HB_MAX_BLOCK (BLOCK_SIZE_FLOAT * 8) // largest input block of any stage
+
+typedef struct HalfBand_t{
+    uint32_t K;
+    float g[HB_MAX_K];          // odd taps, g[j] at +-(2j+1) from the centre
+    float hist[4 * HB_MAX_K];   // input history, oldest first
+}HalfBand_t;
+
+// Windowed-sinc (Kaiser) design, runs once at init
+void HalfBand_Init(HalfBand_t* hb, uint32_t K, float kaiser_beta);
+void HalfBand_Reset(HalfBand_t* hb);
+
+// n input samples -> 2n output samples (in and out may alias)
+void HalfBand_Up(HalfBand_t* hb, const float* in, float* out, uint32_t n);
+// 2n input samples -> n output samples (in and out may alias)
+void HalfBand_Down(HalfBand_t* hb, const float* in, float* out, uint32_t n);
+
+#endif // HALFBAND_H
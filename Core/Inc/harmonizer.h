@@ -0,0 +1,45 @@
+#ifndef HARMONIZER_H
+#define HARMONIZER_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+
+/*Harmonizer: up to HARM_MAX_VOICES pitch shifted copies of the mono input mixed over
+the dry signal. Each voice is the dual-head shifter of pitch_shift.h over a window of
+HARM_GRAIN_MS, all voices reading one shared line. The latency is half a grain on average.
+
+The block is written into the line once, then every voice runs over the whole block
+and accumulates into the stereo wet buffers, so the per voice cost is one table read,
+two interpolated line reads and the pan, whatever the interval.*/
+
+#define HARM_MAX_VOICES 4
+#define HARM_GRAIN_MS 15
+#define HARM_GRAIN (SAMPLE_RATE * HARM_GRAIN_MS / 1000)
+#define HARM_LINE (HARM_GRAIN + BLOCK_SIZE_FLOAT + 2)
+
+typedef struct Harmonizer_Voice_t{
+    uint32_t phase;         // Q32 position in the grain
+    int32_t inc;
+    float gainL, gainR;
+}Harmonizer_Voice_t;
+
+typedef struct Harmonizer_t{
+    float line[HARM_LINE];
+    uint32_t pos;           // next write
+    uint32_t voices;
+    Harmonizer_Voice_t voice[HARM_MAX_VOICES];
+    float dry;
+    float wetL[BLOCK_SIZE_FLOAT];
+    float wetR[BLOCK_SIZE_FLOAT];
+}Harmonizer_t;
+
+void Harmonizer_Init(Harmonizer_t* h, float dry);
+/*Voice v from 0; the voice count grows to cover it. semitones -12..12, level linear,
+pan -1 (left) .. 1 (right), equal power.*/
+void Harmonizer_SetVoice(Harmonizer_t* h, uint32_t v, float semitones, float level, float pan);
+void Harmonizer_SetVoices(Harmonizer_t* h, uint32_t voices);
+
+// Stereo in place, n <= BLOCK_SIZE_FLOAT
+void Harmonizer_ProcessBlock(Harmonizer_t* h, float* l, float* r, uint32_t n);
+
+#endif // HARMONIZER_H
@@ -0,0 +1,12 @@
+#ifndef KAISER_H
+#define KAISER_H
+
+/*Kaiser windowed sinc, the FIR design shared by the half-band, third-band, true-peak and
+tuner filters. For the designs at init, not for per sample use.*/
+
+/*Tap d samples from the centre of a low-pass with its cut-off at fc (fraction of
+Nyquist, 1 the full band): sin(pi fc d) / (pi fc d), 1 at the centre, times a Kaiser
+window of half width 'half' samples, at its end value from there on.*/
+float Kaiser_Sinc(float d, float fc, float half, float beta);
+
+#endif // KAISER_H
@@ -0,0 +1,39 @@
+#ifndef LFO_H
+#define LFO_H
+
+#include <stdint.h>
+
+/*Wavetable sine LFO: a Q32 phase accumulator indexes one cycle of sine with linear
+interpolation, so a modulated effect costs a table read per sample instead of sinf.
+The table is shared by all instances and filled once by LFO_InitTable().*/
+
+#define LFO_TABLE_BITS 8
+#define LFO_TABLE_SIZE (1u << LFO_TABLE_BITS)
+
+extern float lfo_sine_table[LFO_TABLE_SIZE + 1]; // one cycle plus the wrap point
+
+typedef struct LFO_t{
+    uint32_t phase;
+    uint32_t inc;
+}LFO_t;
+
+void LFO_InitTable(void);
+
+static inline void LFO_SetRate(LFO_t* lfo, float hz, float rate) {
+    lfo->inc = (uint32_t)(hz * (4294967296.0f / rate));
+}
+
+// sin(2 pi phase / 2^32)
+static inline float LFO_SineAt(uint32_t phase) {
+    uint32_t i = phase >> (32 - LFO_TABLE_BITS);
+    float frac = (float)(phase << LFO_TABLE_BITS) * (1.0f / 4294967296.0f);
+    return lfo_sine_table[i] + frac * (lfo_sine_table[i + 1] - lfo_sine_table[i]);
+}
+
+static inline float LFO_Next(LFO_t* lfo) {
+    float y = LFO_SineAt(lfo->phase);
+    lfo->phase += lfo->inc;
+    return y;
+}
+
+#endif // LFO_H
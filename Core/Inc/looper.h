@@ -0,0 +1,80 @@
+#ifndef LOOPER_H
+#define LOOPER_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+
+/*Phrase looper streaming to a (possibly slow) memory pool.
+The loop is handled in blocks of LOOPER_BLOCK samples: recording writes whole blocks,
+playback prefetches the next block while the current one is playing, so a DMA or
+external-RAM backed pool never has to complete a transfer within the same call.
+The pool holds two regions of equal size: the loop itself and the undo layer.*/
+
+#define LOOPER_BLOCK BLOCK_SIZE_FLOAT
+#define LOOPER_MIN_BLOCKS 2       // next-block prefetch needs at least two blocks
+#define LOOPER_RESTORE_BLOCKS 2   // undo restore bursts per processed block
+
+typedef struct Looper_Pool_t{
+    void (*read)(void* ctx, uint32_t offset, float* dst, uint32_t count);
+    void (*write)(void* ctx, uint32_t offset, const float* src, uint32_t count);
+    void* ctx;
+    uint32_t size; // in samples
+}Looper_Pool_t;
+
+typedef enum {
+    LOOPER_EMPTY,
+    LOOPER_RECORD,
+    LOOPER_PLAY,
+    LOOPER_OVERDUB,
+    LOOPER_STOP
+} Looper_State_t;
+
+typedef enum {
+    LOOPER_CMD_NONE,
+    LOOPER_CMD_RECORD,   // start first recording, or overdub on an existing loop
+    LOOPER_CMD_PLAY,     // close recording / stop overdub / restart playback
+    LOOPER_CMD_STOP,
+    LOOPER_CMD_UNDO,     // drop the last overdub layer
+    LOOPER_CMD_CLEAR
+} Looper_Cmd_t;
+
+typedef struct Looper_t{
+    Looper_Pool_t pool;
+    uint32_t maxBlocks;     // per region
+    uint32_t undoOffset;    // start of the undo region in samples
+
+    Looper_State_t state;
+    volatile Looper_Cmd_t pending;
+    uint8_t halfSpeed;
+    float level;
+
+    uint32_t loopBlocks;    // loop length, 0 while empty
+    uint32_t blockIdx;      // loop block being played/recorded
+    uint32_t pos;           // position in the block in half-sample steps
+    uint8_t dirty;          // acc holds new material to flush
+
+    uint32_t layerStart;    // blocks backed up for the current overdub layer
+    uint32_t layerLen;
+    uint32_t restoreStart;  // pending undo restore range
+    uint32_t restoreLen;
+    uint32_t restoreDone;
+
+    float* cur;
+    float* next;
+    float bufA[LOOPER_BLOCK];
+    float bufB[LOOPER_BLOCK];
+    float acc[LOOPER_BLOCK];
+    float scratch[LOOPER_BLOCK];
+}Looper_t;
+
+// Memory-mapped pool (internal RAM, FMC SDRAM, ...)
+void Looper_PoolFromMemory(Looper_Pool_t* pool, float* mem, uint32_t size);
+
+void Looper_Init(Looper_t* lp, const Looper_Pool_t* pool, float level);
+void Looper_Command(Looper_t* lp, Looper_Cmd_t cmd);
+void Looper_SetHalfSpeed(Looper_t* lp, uint8_t enable);
+
+// Mono loop: records (l+r)/2 and adds the loop to both channels in place, n == LOOPER_BLOCK
+void Looper_ProcessBlock(Looper_t* lp, float* l, float* r, uint32_t n);
+
+#endif // LOOPER_H
@@ -0,0 +1,96 @@
+#ifndef MODULATION_H
+#define MODULATION_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+
+/*Control-rate modulation. Sources are LFOs, evaluated once per block from a Q32 phase
+(sine from the LFO wavetable, triangle, saw and square from the phase itself), and
+envelope followers fed the block they follow. A route adds depth x source to a
+destination's base; the sum is clamped to the destination's range and smoothed by a
+one-pole at block rate, so steps in a source or a knob never reach the audio as clicks.
+
+Mod_Update() runs the whole matrix in one pass over flat arrays: sources, then the
+routes into the destination targets, then the smoothing. A destination that is read
+once per block takes Mod_Value(); one that needs a ramp reads Mod_Prev() as well and
+interpolates across the block itself.*/
+
+#define MOD_MAX_LFOS 4
+#define MOD_MAX_ENVS 2
+#define MOD_SOURCES (MOD_MAX_LFOS + MOD_MAX_ENVS)
+#define MOD_MAX_ROUTES 16
+#define MOD_MAX_DESTS 8
+
+#define MOD_SRC_LFO(k) (k)                      // bipolar, -1..1
+#define MOD_SRC_ENV(k) (MOD_MAX_LFOS + (k))     // unipolar, 0..1
+
+typedef enum {
+    MOD_SINE,
+    MOD_TRIANGLE,
+    MOD_SAW,
+    MOD_SQUARE
+} Mod_Shape_t;
+
+typedef struct Mod_LFO_t{
+    uint32_t phase;
+    uint32_t inc;           // per sample
+    Mod_Shape_t shape;
+}Mod_LFO_t;
+
+typedef struct Mod_Env_t{
+    float attack, release;  // per block coefficients
+    float floor;            // log2 of the power that maps to 0
+    float level;            // log2 power, smoothed
+}Mod_Env_t;
+
+typedef struct Mod_Route_t{
+    uint8_t src;
+    uint8_t dst;
+    float depth;            // destination units at full source
+}Mod_Route_t;
+
+typedef struct Mod_Dest_t{
+    float base;
+    float min, max;
+    float coeff;            // smoothing per block
+    float target;
+    float prev, value;      // block start, block end
+}Mod_Dest_t;
+
+typedef struct Mod_t{
+    float src[MOD_SOURCES];
+    Mod_LFO_t lfo[MOD_MAX_LFOS];
+    Mod_Env_t env[MOD_MAX_ENVS];
+    Mod_Route_t route[MOD_MAX_ROUTES];
+    uint32_t routes;
+    Mod_Dest_t dest[MOD_MAX_DESTS];
+    uint32_t dests;
+    float sample_rate;
+}Mod_t;
+
+void Mod_Init(Mod_t* m, float sample_rate);
+// phase 0..1 of a cycle, e.g. 0.25 for a quadrature pair
+void Mod_SetLFO(Mod_t* m, uint32_t k, Mod_Shape_t shape, float hz, float phase);
+// floor_dB RMS maps to 0, 0 dBFS to 1, log scale in between
+void Mod_SetEnvelope(Mod_t* m, uint32_t k, float attack_ms, float release_ms, float floor_dB);
+// The block the envelope follows, before Mod_Update
+void Mod_FeedEnvelope(Mod_t* m, uint32_t k, const float* l, const float* r, uint32_t n);
+
+// Destination d from 0, the count grows to cover it; starts settled on base
+void Mod_SetDest(Mod_t* m, uint32_t d, float base, float min, float max, float smooth_ms);
+void Mod_SetBase(Mod_t* m, uint32_t d, float base);
+// Adds the route or sets its depth if the pair exists; 0 if the table is full
+uint8_t Mod_Route(Mod_t* m, uint32_t src, uint32_t dst, float depth);
+
+// Once per block of n frames
+void Mod_Update(Mod_t* m, uint32_t n);
+
+static inline float Mod_Value(const Mod_t* m, uint32_t d) {
+    return m->dest[d].value;
+}
+
+static inline float Mod_Prev(const Mod_t* m, uint32_t d) {
+    return m->dest[d].prev;
+}
+
+#endif // MODULATION_H
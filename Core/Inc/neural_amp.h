@@ -0,0 +1,60 @@
+#ifndef NEURAL_AMP_H
+#define NEURAL_AMP_H
+
+#include <stdint.h>
+
+/*Neural amp model: single layer GRU (hidden 8..16) plus a linear output layer, run
+sample by sample in fixed point with the CMSIS-NN q15 kernels. The weights come from
+a flash blob written by tools/gen_neural_amp.py (int16 or int8, power-of-two scales).
+
+Per sample: one fully connected layer on [h, x] gives the r, z gate and candidate
+hidden pre-activations (Q12), a 1 column layer the candidate input part; sigmoid/tanh
+use the CMSIS-NN q15 tables. Audio, hidden state and gates are Q15.*/
+
+#define NEURAL_AMP_MAGIC 0x314D414Eu // "NAM1"
+#define NEURAL_AMP_MAX_HIDDEN 16
+
+// Blob layout: header, then recW[3H][H+1], recB[3H], inW[H], inB[H], outW[H], outB[1],
+// each array padded to 4 bytes. Shifts are the CMSIS-NN fully connected bias/out shifts.
+typedef struct NeuralAmp_Header_t{
+    uint32_t magic;
+    uint32_t size;        // whole blob in bytes
+    uint8_t hidden;
+    uint8_t weightBits;   // 16: q15 weights, 8: q7 weights
+    uint8_t actIntBits;   // integer bits of the pre-activations (3: +-8)
+    uint8_t skip;         // output adds the input
+    uint8_t recBiasShift, recOutShift;
+    uint8_t inBiasShift, inOutShift;
+    uint8_t outBiasShift, outOutShift;
+    uint8_t reserved[2];
+}NeuralAmp_Header_t;
+
+typedef struct NeuralAmp_t{
+    const NeuralAmp_Header_t* model;  // NULL: not loaded, the stage passes audio through
+    const void* recW;
+    const void* recB;
+    const void* inW;
+    const void* inB;
+    const void* outW;
+    const void* outB;
+    uint32_t hidden;
+
+    int16_t v[NEURAL_AMP_MAX_HIDDEN + 1];     // hidden state, then the input sample
+    int16_t gates[3 * NEURAL_AMP_MAX_HIDDEN]; // r, z, candidate hidden part
+    int16_t cand[NEURAL_AMP_MAX_HIDDEN];
+    int16_t tmp[NEURAL_AMP_MAX_HIDDEN];
+    float ref[NEURAL_AMP_MAX_HIDDEN];         // hidden state of NeuralAmp_ReferenceBlock
+}NeuralAmp_t;
+
+// blob must be 4-byte aligned and stay mapped (flash). Returns 0 if it is not a valid model.
+uint8_t NeuralAmp_Init(NeuralAmp_t* na, const uint8_t* blob, uint32_t size);
+void NeuralAmp_Reset(NeuralAmp_t* na);
+
+// Inputs are clamped to [-1, 1), in and out may alias
+void NeuralAmp_ProcessBlock(NeuralAmp_t* na, const float* in, float* out, uint32_t n);
+
+// Float evaluation of the same (dequantised) model, for checking the fixed point path
+void NeuralAmp_ReferenceBlock(NeuralAmp_t* na, const float* in, float* out, uint32_t n);
+uint32_t NeuralAmp_MacsPerSample(const NeuralAmp_t* na);
+
+#endif // NEURAL_AMP_H
@@ -0,0 +1,29 @@
+#ifndef PHASER_H
+#define PHASER_H
+
+#include <stdint.h>
+#include "tpt.h"
+
+/*Stereo phaser: 1..TPT_MAX_STAGES first order allpasses per channel on the shared TPT
+kernel, mixed with the dry signal. Each pair of stages adds a notch where their phase
+reaches 180 degrees; feedback deepens the notches. The sweep position comes in per block
+and per channel (from the modulation matrix), mapped exponentially between the two
+corner frequencies, so a linear LFO sweeps evenly in pitch.*/
+
+typedef struct Phaser_t{
+    uint32_t stages;
+    float sample_rate;
+    float minHz, octaves;
+    float feedback;         // -0.9..0.9
+    float mix;              // 0.5 for the deepest notches
+    float stateL[TPT_MAX_STAGES], stateR[TPT_MAX_STAGES];
+    float last[2];          // wet left, right
+}Phaser_t;
+
+void Phaser_Init(Phaser_t* ph, float sample_rate, uint32_t stages, float min_hz, float max_hz,
+                 float feedback, float mix);
+
+// Stereo in place, sweep positions 0..1 for the block
+void Phaser_ProcessBlock(Phaser_t* ph, float* l, float* r, uint32_t n, float posL, float posR);
+
+#endif // PHASER_H
@@ -0,0 +1,32 @@
+#ifndef PITCH_SHIFT_H
+#define PITCH_SHIFT_H
+
+#include <stdint.h>
+#include "delay.h"
+#include "lfo.h"
+
+/*Dual-head delay pitch shifter kernel, shared by the shimmer and the harmonizer.
+Two read heads sit d = window * phase and d + window / 2 samples behind the newest
+sample of a circular line; the phase moves by (1 - ratio) / window per sample, so the
+heads sweep the window at 1 - ratio samples per sample. They are crossfaded sin^2 /
+cos^2 from the LFO wavetable, each one silent where it jumps.*/
+
+// Q32 phase increment for a pitch ratio over a window of 'window' samples
+static inline int32_t PitchShift_Inc(float ratio, float window) {
+    return (int32_t)((1.0f - ratio) / window * 4294967296.0f);
+}
+
+/*One output sample. line/len/pos as in Delay_ReadFrac, newest the offset of the newest
+sample from pos, scale = window / 2^32.*/
+static inline float PitchShift_Read(const float* line, uint32_t len, uint32_t pos,
+                                    float newest, float scale, uint32_t phase) {
+    float w = LFO_SineAt(phase >> 1);   // sin(pi phase), 0 where head 1 jumps
+    w *= w;
+    float d1 = (float)phase * scale;
+    float d2 = (float)(phase + 0x80000000u) * scale;
+    float a = Delay_ReadFrac(line, len, pos, newest - d1);
+    float b = Delay_ReadFrac(line, len, pos, newest - d2);
+    return b + w * (a - b);
+}
+
+#endif // PITCH_SHIFT_H
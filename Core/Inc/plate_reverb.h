@@ -0,0 +1,67 @@
+#ifndef PLATE_REVERB_H
+#define PLATE_REVERB_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+#include "reverb.h"
+#include "lfo.h"
+
+/*Plate reverb after Dattorro ("Effect Design, Part 1", 1997): a bandwidth low-pass and
+four input diffusers feed a figure-eight tank of two halves, each a modulated allpass,
+a delay, a damping low-pass, a second allpass and a delay, the end of each half feeding
+the start of the other. The outputs are seven taps per channel spread over the tank.
+
+The published lengths are for 29761 Hz; they are scaled to the running rate and by 'size'
+(1: the original plate). At 48 kHz a full size instance needs 36.3k floats (145 KB),
+more than all of CCM RAM, so the lines come from a pool list like the FDN and size 0.5
+(72 KB) fits the CCM reverb pool plus a small SRAM spill. Plate_PoolSize() gives the
+exact figure. The tank allpass delays swing by up to 0.54 ms with a wavetable LFO, read
+with linear interpolation.*/
+
+#define PLATE_TAPS 7
+
+typedef struct Plate_Tap_t{
+    const Reverb_Line_t* line;
+    uint32_t delay;       // samples back from the write position
+}Plate_Tap_t;
+
+typedef struct Plate_t{
+    uint8_t ready;
+    Reverb_Line_t diffuser[4];
+    // Tank halves, left then right
+    Reverb_Line_t modAp[2];
+    Reverb_Line_t delay1[2];
+    Reverb_Line_t ap2[2];
+    Reverb_Line_t delay2[2];
+    float modCenter[2];   // nominal modulated allpass delays
+    float excursion;      // peak swing, samples
+
+    Plate_Tap_t tapL[PLATE_TAPS];
+    Plate_Tap_t tapR[PLATE_TAPS];
+
+    LFO_t lfo;
+    float bandwidth, bwState;
+    float damping, damp[2];
+    float decay;
+    float wet;
+    float mono[BLOCK_SIZE_FLOAT];
+}Plate_t;
+
+// Floats needed for one instance of the given size run at 'rate'
+uint32_t Plate_PoolSize(float rate, float size);
+
+/*Lines come from the first of the pools with room, returns 0 if they do not fit.
+decay is the tank gain (0..0.99, 0.5 in the paper), damping 0..1 (0.0005).*/
+uint8_t Plate_Init(Plate_t* pl, Reverb_Pool_t* pools, uint32_t poolCount, float rate, float size,
+                   float decay, float damping, float wet);
+void Plate_SetDecay(Plate_t* pl, float decay);
+void Plate_SetDamping(Plate_t* pl, float damping);
+void Plate_SetWet(Plate_t* pl, float wet);
+
+// Stereo in place, mono sum in, n <= BLOCK_SIZE_FLOAT
+void Plate_ProcessBlock(Plate_t* pl, float* l, float* r, uint32_t n);
+
+// ReducedRate_t / Shimmer_t process hook
+static inline void Plate_Run(void* fx, float* l, float* r, uint32_t n) { Plate_ProcessBlock(fx, l, r, n); }
+
+#endif // PLATE_REVERB_H
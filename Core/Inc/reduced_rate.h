@@ -0,0 +1,60 @@
+#ifndef REDUCED_RATE_H
+#define REDUCED_RATE_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+#include "halfband.h"
+
+/*Runs a stereo block effect at SAMPLE_RATE / factor: the mono sum is decimated, the
+effect runs on the short block (both channels fed the same signal) and its outputs are
+interpolated back and mixed with the dry input at the full rate. Meant for reverbs,
+whose tails carry little above 8-10 kHz: delay lines and cycles shrink by the factor
+for the same decay time. The effect must be initialised for the reduced rate and
+fully wet.
+
+Factor 2 uses the polyphase half-band resamplers. Factor 3 uses a third-band FIR
+(every third tap zero apart from the centre) in polyphase form: the decimator
+evaluates one output in three with 16 symmetric tap pairs, the interpolator one
+16-tap phase per output, and one phase in three is a pure delay. With factor 3 the
+number of low rate samples per block alternates (10 or 11 for 32 frames), the phase
+carries over between blocks.*/
+
+#define RR_MAX_FACTOR 3
+#define RR_THIRD_HALF 24                     // third-band FIR taps -24..24
+#define RR_THIRD_PAIRS 16                    // non-zero symmetric pairs
+#define RR_LOW_HIST (2 * RR_THIRD_HALF / 3)  // low rate samples the interpolator looks back
+#define RR_MAX_LOW (BLOCK_SIZE_FLOAT / 2)
+
+// Same shape as the reverbs' ProcessBlock: stereo in place
+typedef void (*ReducedRate_Process_t)(void* fx, float* l, float* r, uint32_t n);
+
+typedef struct ReducedRate_t{
+    uint32_t factor;          // 1, 2 or 3
+    ReducedRate_Process_t process;
+    void* fx;                 // NULL: plain resampling, for measurements
+    float mix;
+
+    HalfBand_t down, upL, upR;
+
+    uint32_t phase;           // fine samples since the last low rate sample, mod 3
+    float g3[RR_THIRD_PAIRS]; // decimator taps at +-(m + m/2 + 1)
+    float poly[2][RR_THIRD_PAIRS]; // interpolator phases 1 and 2, times 3
+    float hist[2 * RR_THIRD_HALF + BLOCK_SIZE_FLOAT];
+    float lowL[RR_LOW_HIST + RR_MAX_LOW];
+    float lowR[RR_LOW_HIST + RR_MAX_LOW];
+
+    float wetL[BLOCK_SIZE_FLOAT];
+    float wetR[BLOCK_SIZE_FLOAT];
+}ReducedRate_t;
+
+// factor 1..RR_MAX_FACTOR; the effect must run at ReducedRate_Rate()
+void ReducedRate_Init(ReducedRate_t* rr, uint32_t factor, ReducedRate_Process_t process, void* fx, float mix);
+void ReducedRate_SetMix(ReducedRate_t* rr, float mix);
+float ReducedRate_Rate(const ReducedRate_t* rr);
+// Delay the resamplers add to the wet path, in frames
+uint32_t ReducedRate_Latency(const ReducedRate_t* rr);
+
+// Stereo in place, n <= BLOCK_SIZE_FLOAT (even for factor 2)
+void ReducedRate_ProcessBlock(ReducedRate_t* rr, float* l, float* r, uint32_t n);
+
+#endif // REDUCED_RATE_H
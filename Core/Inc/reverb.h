@@ -1,7 +1,98 @@
 #ifndef REVERB_H
 #define REVERB_H
 
-extern float Do_Reverb(float inSample);
-extern void Reverb_Init(void);
+#include <stdint.h>
+#include "dsp_configuration.h"
 
-#endif // REVERB_H
\ No newline at end of file
+/*Schroeder reverb: parallel feedback combs into a series of allpasses, any number of
+each up to the limits below. Delay lines come from a caller-provided pool, so several
+instances can live in CCM RAM, SRAM or external RAM.
+
+The input is the mono sum of the block, the right channel runs its own set of lines
+stretched by 'spread' samples so the two outputs decorrelate (as in Freeverb).
+Combs are run four at a time per sample to keep the independent loads and
+multiply-adds interleaved; the loops run between buffer wraps without index checks.
+
+With cfg->q15 the comb and allpass lines hold 16-bit samples, which halves the pool
+per second of delay. The arithmetic stays float: a block is scaled to the Q15 range
+once, each head converts on its load and store, and the scale comes off in the wet
+gain. Lines keep REVERB_Q15_HEADROOM of headroom for the comb resonances (a full scale
+tone on a comb peak reaches about 7). Stores round to nearest, which keeps the decay
+time, except within 'floor' steps of zero where a loop of gain g could hold a rounded
+value forever: there they truncate towards zero and the tail dies out.*/
+
+#define REVERB_MAX_COMBS 8
+#define REVERB_MAX_ALLPASS 4
+#define REVERB_Q15_HEADROOM 8.0f  // Q15 lines hold +-8
+
+typedef struct Reverb_Line_t{
+    union {
+        float* buf;
+        int16_t* q15;         // Schroeder lines of a cfg->q15 configuration
+    };
+    uint32_t len;
+    uint32_t pos;
+    float g;
+    float floor;              // Q15 lines: past 0.5 / (1 - g), below it stores truncate
+}Reverb_Line_t;
+
+// Bump allocator over a float array, the reverb never frees
+typedef struct Reverb_Pool_t{
+    float* mem;
+    uint32_t size;  // floats
+    uint32_t used;
+}Reverb_Pool_t;
+
+typedef struct Reverb_Config_t{
+    const uint32_t* combLen;  // samples
+    uint32_t combs;
+    const uint32_t* allpassLen;
+    const float* allpassG;
+    uint32_t allpasses;
+    uint32_t spread;          // extra samples on every right channel line
+    float rate;               // sample rate the lengths are given at
+    uint8_t q15;              // lines stored as Q15
+}Reverb_Config_t;
+
+typedef struct Reverb_t{
+    uint32_t combs;
+    uint32_t allpasses;
+    float rate;
+    uint8_t q15;
+    Reverb_Line_t comb[2][REVERB_MAX_COMBS];       // left, right
+    Reverb_Line_t allpass[2][REVERB_MAX_ALLPASS];
+    float combScale;
+    float wet;
+    float mono[BLOCK_SIZE_FLOAT];
+    float out[BLOCK_SIZE_FLOAT];
+}Reverb_t;
+
+// Schroeder's comb and allpass delays at SAMPLE_RATE, stereo spread of 23 samples, float lines
+extern const Reverb_Config_t Reverb_DefaultConfig;
+
+void Reverb_PoolInit(Reverb_Pool_t* pool, float* mem, uint32_t size);
+// Zeroed block of count floats, NULL when the pool cannot hold it
+float* Reverb_PoolAlloc(Reverb_Pool_t* pool, uint32_t count);
+// Same from the first of several pools with room, e.g. CCM RAM first and SRAM after it
+float* Reverb_PoolListAlloc(Reverb_Pool_t* pools, uint32_t poolCount, uint32_t count);
+// Floats needed for a configuration run at 'rate' (both channels)
+uint32_t Reverb_PoolSize(const Reverb_Config_t* cfg, float rate);
+
+/*Lengths are scaled from cfg->rate to the running rate, so the same configuration runs
+at a reduced rate in a ReducedRate_t with proportionally less memory. Returns 0 if the
+pool is too small or the counts exceed the limits.*/
+uint8_t Reverb_Init(Reverb_t* rv, Reverb_Pool_t* pool, const Reverb_Config_t* cfg, float rate, float rt60_s, float wet);
+// Comb feedback gains for a decay of rt60_s seconds: g = 10^(-3 len / (rt60 fs))
+void Reverb_SetDecay(Reverb_t* rv, float rt60_s);
+void Reverb_SetWet(Reverb_t* rv, float wet);
+
+// Schroeder allpass with delay a->len and gain a->g over a block, in place
+void Reverb_AllpassBlock(Reverb_Line_t* a, float* x, uint32_t n);
+
+// Stereo in place, n <= BLOCK_SIZE_FLOAT
+void Reverb_ProcessBlock(Reverb_t* rv, float* l, float* r, uint32_t n);
+
+// ReducedRate_t / Shimmer_t process hook
+static inline void Reverb_Run(void* fx, float* l, float* r, uint32_t n) { Reverb_ProcessBlock(fx, l, r, n); }
+
+#endif // REVERB_H
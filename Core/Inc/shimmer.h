@@ -0,0 +1,64 @@
+#ifndef SHIMMER_H
+#define SHIMMER_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+#include "reverb.h"
+#include "reduced_rate.h"
+#include "arm_math.h"
+
+/*Shimmer: a pitch shifter in a feedback loop around a fully wet reverb. The reverb's
+wet output is low-passed, shifted and fed back into its input one block later, so
+every pass through the tail climbs by the interval (an octave by default).
+
+The shifter is the dual-head delay of pitch_shift.h over a SHIMMER_WINDOW_MS line.
+It runs over the whole block after the reverb, one table read and two interpolated
+reads per sample whatever the interval. The line comes from pools of its own, sized with
+SHIMMER_POOL_SIZE(): the reverb's fill theirs. The loop low-pass sits under rate / 2 / ratio, which keeps
+the shifted highs from folding back at the reverb's (possibly reduced) rate.
+
+The loop carries the whole tail, so its gain at the reverb's strongest resonance is
+feedback times that resonance's peak, and an octave of a comb mode is another mode:
+the usable feedback depends on the reverb (see SHIMMER_FEEDBACK).*/
+
+#define SHIMMER_WINDOW_MS 40
+
+// Floats of line at an integer 'rate' in Hz, for sizing a pool at compile time
+#define SHIMMER_POOL_SIZE(rate) ((rate) * SHIMMER_WINDOW_MS / 1000u + 2u)
+
+typedef struct Shimmer_t{
+    uint8_t ready;
+    ReducedRate_Process_t process;  // the reverb, fully wet
+    void* fx;
+
+    float* line;
+    uint32_t len, pos;
+    float window;                   // samples
+    uint32_t phase;                 // Q32 position in the window
+    int32_t inc;
+
+    float rate;
+    float feedback;
+    float lpfCoeffs[5];
+    float lpfState[2];
+    arm_biquad_cascade_df2T_instance_f32 lpf;
+    float loop[BLOCK_SIZE_FLOAT];   // shifted wet, into the next block
+}Shimmer_t;
+
+// Floats taken from the pools at 'rate', SHIMMER_POOL_SIZE() for a float rate
+uint32_t Shimmer_PoolSize(float rate);
+
+/*The line comes from the first pool with room, returns 0 if none has; ProcessBlock then
+runs the reverb alone. semitones -24..24, feedback 0..0.9.*/
+uint8_t Shimmer_Init(Shimmer_t* sh, Reverb_Pool_t* pools, uint32_t poolCount, float rate,
+                     ReducedRate_Process_t process, void* fx, float semitones, float feedback);
+void Shimmer_SetPitch(Shimmer_t* sh, float semitones);
+void Shimmer_SetFeedback(Shimmer_t* sh, float feedback);
+
+// Stereo in place like the wrapped reverb, n <= BLOCK_SIZE_FLOAT
+void Shimmer_ProcessBlock(Shimmer_t* sh, float* l, float* r, uint32_t n);
+
+// ReducedRate_t process hook
+static inline void Shimmer_Run(void* fx, float* l, float* r, uint32_t n) { Shimmer_ProcessBlock(fx, l, r, n); }
+
+#endif // SHIMMER_H
@@ -2,26 +2,72 @@
 #define SPRING_REVERB_H
 
 #include <stdint.h>
+#include "dsp_configuration.h"
+#include "halfband.h"
+#include "arm_math.h"
+
+/*Dispersive spring reverb (Valimaki, Parker & Abel, "Parametric spring reverberation
+effect", 2010). Each spring is a feedback loop of a cascade of stretched first-order
+allpasses A(z) = (a + z^-K) / (1 + a z^-K), a low-pass and the round trip delay. The
+cascade delays high frequencies more than low ones up to fs / 2K, so every echo comes
+back as a rising chirp and later echoes are smeared further. Above fs / 2K the
+allpass response repeats; the loop low-pass is tuned there, which keeps the
+dispersion to the low band as in a real spring and makes the highs die first.
+
+The springs run at half rate (SPRING_RATE) between half-band resamplers: the band
+they need fits below it and the cascade cost halves. Each allpass runs over the
+whole decimated block before the next one, so the loop delay must be at least one
+decimated block long.*/
+
+#define SPRING_MAX 4
+#define SPRING_MAX_SECTIONS 160
+#define SPRING_STRETCH 3                          // K at the internal rate: dispersion below 4 kHz
+#define SPRING_RATE (SAMPLE_RATE / 2)
+#define SPRING_BLOCK (BLOCK_SIZE_FLOAT / 2)
+#define SPRING_MAX_LEN (66 * SPRING_RATE / 1000) // longest round trip
+
+// Caller memory upper bound, SpringReverb_MemSize() is exact
+#define SPRING_MEM_SIZE(springs, sections) ((springs) * (SPRING_MAX_LEN + (sections) * SPRING_STRETCH))
 
 typedef struct {
-    float *delayBuffer;
-    uint32_t bufferSize;
-    uint32_t writePos;
+    float *line;          // round trip delay
+    uint32_t len;
+    uint32_t pos;
+    float *state;         // sections * SPRING_STRETCH allpass states
+    float g;              // loop gain from the decay time
+    float gainL, gainR;   // output weights
+    float lpfCoeffs[5];
+    float lpfState[2];
+    arm_biquad_cascade_df2T_instance_f32 lpf;
+} SpringLine;
 
-    float feedback;
+typedef struct {
+    uint32_t springs;
+    uint32_t sections;
+    float a;              // dispersion, 0..0.9
     float mix;
+    SpringLine spring[SPRING_MAX];
 
-    float allpass_z1;
-    float allpass_coeff;
+    HalfBand_t down;
+    HalfBand_t upL, upR;
+    float x[SPRING_BLOCK];
+    float u[SPRING_BLOCK];
+    float w[SPRING_STRETCH + SPRING_BLOCK];
+    float outL[BLOCK_SIZE_FLOAT];
+    float outR[BLOCK_SIZE_FLOAT];
 } SpringReverb;
 
-// Initialize (allocate buffer externally, e.g. static float[...])
-void SpringReverb_Init(SpringReverb *rv, float *buffer, uint32_t bufferSize, float feedback, float mix);
+// Floats of caller memory for the given spring and section counts
+uint32_t SpringReverb_MemSize(uint32_t springs, uint32_t sections);
+
+// Buffer from the caller (e.g. static float[...]); returns 0 if it is too small
+uint8_t SpringReverb_Init(SpringReverb *rv, float *buffer, uint32_t bufferSize,
+                          uint32_t springs, uint32_t sections, float rt60_s, float mix);
 
-// Set parameters
-void SpringReverb_SetParams(SpringReverb *rv, float feedback, float mix, float allpass_ms, float fs);
+// Decay time, wet mix and dispersion (allpass coefficient)
+void SpringReverb_SetParams(SpringReverb *rv, float rt60_s, float mix, float dispersion);
 
-// Process single mono sample
-float SpringReverb_ProcessSample(SpringReverb *rv, float in);
+// Stereo in place, mono sum in, n even and <= BLOCK_SIZE_FLOAT
+void SpringReverb_ProcessBlock(SpringReverb *rv, float *l, float *r, uint32_t n);
 
 #endif
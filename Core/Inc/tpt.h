@@ -0,0 +1,47 @@
+#ifndef TPT_H
+#define TPT_H
+
+#include <stdint.h>
+#include "fast_math.h"
+
+/*Topology-preserving transform filters (Zavalishin, "The Art of VA Filter Design") for
+swept effects. Every integrator is trapezoidal, so a filter keeps its response and its
+stability while the cutoff moves, and the cutoff enters only through g = tan(pi fc / fs):
+the effects compute g once per block with Fast_Tan and run the block on it.
+ - TPT_AllpassChain: first order allpass stages on one g per channel, all of them and
+   both channels per sample in a single loop, with feedback from the chain's last output
+   and the dry mix folded in,
+ - TPT_SVF: the two pole state-variable filter, band pass scaled to unity at the peak,
+   again both channels in one loop.*/
+
+#define TPT_MAX_STAGES 12
+
+// Prewarped integrator gain, clamped under Nyquist
+static inline float TPT_G(float hz, float sample_rate) {
+    float x = 3.14159265f * hz / sample_rate;
+    if (x > 1.45f) x = 1.45f;
+    return Fast_Tan(x);
+}
+
+typedef struct TPT_SVF_t{
+    float k;                // 1 / Q
+    float a1, a2, a3;
+    float ic1, ic2;         // integrator states
+}TPT_SVF_t;
+
+static inline void TPT_SVF_Set(TPT_SVF_t* f, float g, float q) {
+    f->k = 1.0f / q;
+    f->a1 = 1.0f / (1.0f + g * (g + f->k));
+    f->a2 = g * f->a1;
+    f->a3 = g * f->a2;
+}
+
+// Stereo in place, a filter per channel: x + mix (band pass - x)
+void TPT_SVF_Bandpass(TPT_SVF_t* fl, TPT_SVF_t* fr, float mix, float* l, float* r, uint32_t n);
+
+/*Stereo in place: x + mix (wet - x), wet the chain's output for x + feedback * the
+previous wet sample. sl and sr hold one state per stage, last the previous wet pair.*/
+void TPT_AllpassChain(float* sl, float* sr, uint32_t stages, float gl, float gr, float feedback,
+                      float mix, float* last, float* l, float* r, uint32_t n);
+
+#endif // TPT_H
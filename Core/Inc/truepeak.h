@@ -0,0 +1,75 @@
+#ifndef TRUEPEAK_H
+#define TRUEPEAK_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+
+/*Output stage: true-peak safety limiter fused with the 24-bit I2S packing. Each frame is
+interpolated at 1/4, 1/2 and 3/4 of the way to the next one by a 4x polyphase FIR
+(TP_TAPS taps per phase, Kaiser windowed sinc), and the largest of those and the sample
+itself sets the gain that interval needs to stay under the ceiling. The 3/4 phase is
+the 1/4 phase reversed and the 1/2 phase is symmetric, so the three phases share one set
+of folded sums and cost 3 TP_TAPS / 2 multiplies per channel.
+
+The gain is held at its minimum over the look-ahead, released with a one-pole and
+averaged over the look-ahead, like the compressor's limiter but in the linear domain:
+the gain is fully down by the time a peak plays and never above what its intervals
+asked for. The scaled sample is rounded, saturated to 24 bits in one instruction and
+packed MSB-aligned, two 16-bit words per channel, in the same loop.
+
+While nothing has gone over, every gain is unity and the stage idles: a block whose
+peak times the interpolator's reach stays under the ceiling is only delayed and packed,
+otherwise only the detector runs until an interval goes over. The hold, release and
+average come back in from there and run until the gain has been back at unity for a
+whole look-ahead.*/
+
+#define TP_TAPS 8               // per phase, even
+#define TP_MAX_LOOKAHEAD 32     // frames
+#define TP_INT24_SCALE 8388607.0f
+
+typedef struct TruePeak_t{
+    float ceiling;              // linear, true-peak
+    float releaseCoeff;
+    uint32_t lookahead;         // L
+    uint32_t delay;             // TP_TAPS / 2 + L
+
+    // Folded interpolator: even / odd parts of the 1/4 phase, the 1/2 phase
+    float even[TP_TAPS / 2];
+    float odd[TP_TAPS / 2];
+    float half[TP_TAPS / 2];
+    float histL[TP_TAPS - 1 + BLOCK_SIZE_FLOAT];
+    float histR[TP_TAPS - 1 + BLOCK_SIZE_FLOAT];
+
+    // Requested gains of the last L + 2 intervals and their held minimum
+    float req[TP_MAX_LOOKAHEAD + 2];
+    uint32_t reqPos;
+    float held;
+    uint32_t heldAge;
+    float env;
+    float avg[TP_MAX_LOOKAHEAD + 1];
+    uint32_t avgPos;
+
+    float delayL[TP_TAPS / 2 + TP_MAX_LOOKAHEAD];
+    float delayR[TP_TAPS / 2 + TP_MAX_LOOKAHEAD];
+    uint32_t delayPos;
+
+    float reach;                // largest interpolated |y| over samples of |x| <= 1
+    uint8_t idle;               // all gains at unity, see above
+    uint32_t quiet;             // frames the gain has been back at unity
+
+    float minGain;              // lowest gain of the last block, for metering
+}TruePeak_t;
+
+// lookahead 0..TP_MAX_LOOKAHEAD frames
+void TruePeak_Init(TruePeak_t* tp, float sample_rate, float ceiling_dB, float release_ms, uint32_t lookahead);
+// Frames from input to output
+uint32_t TruePeak_Latency(const TruePeak_t* tp);
+/*Largest |x| from hist[TP_TAPS / 2 - 1] up to the next sample: the sample and the three
+interpolated points (hist: TP_TAPS samples, oldest first)*/
+float TruePeak_Detect(const TruePeak_t* tp, const float* hist);
+
+/*n frames of l and r to 4n words of tx: left MSB, left LSB, right MSB, right LSB,
+n <= BLOCK_SIZE_FLOAT*/
+void TruePeak_ProcessBlock(TruePeak_t* tp, const float* l, const float* r, uint16_t* tx, uint32_t n);
+
+#endif // TRUEPEAK_H
@@ -0,0 +1,70 @@
+#ifndef TUNER_H
+#define TUNER_H
+
+#include <stdint.h>
+#include "dsp_configuration.h"
+#include "arm_math.h"
+
+/*Chromatic tuner after McLeod & Wyvill ("A smarter way to find pitch", 2005). The audio
+path only copies input into a ring; everything else runs from the idle loop, one step
+per call like the background convolvers:
+ - snapshot: the ring is low-passed and decimated by TUNER_DECIMATION into a window of
+   TUNER_WINDOW samples, zero padded to TUNER_FFT, and the NSDF denominators m(tau)
+   are accumulated,
+ - forward arm_rfft_fast_f32,
+ - power spectrum and inverse rfft: the autocorrelation r(tau),
+ - NSDF 2 r(tau) / m(tau), the first key maximum above TUNER_PEAK_K of the highest,
+   refined by a parabola, then the note, cents and clarity.
+The padding keeps the circular autocorrelation clear of wrap-around up to the longest
+lag. Results are printed over SystemView (RTT) every TUNER_REPORT_MS.*/
+
+#define TUNER_DECIMATION 4
+#define TUNER_RING 2048                   // input samples, power of two
+#define TUNER_FIR_TAPS 16
+#define TUNER_WINDOW ((TUNER_RING - TUNER_FIR_TAPS) / TUNER_DECIMATION)
+#define TUNER_FFT 1024                    // >= TUNER_WINDOW + TUNER_MAX_LAG
+#define TUNER_MIN_HZ 60                   // sets the longest lag
+#define TUNER_MAX_HZ 1400.0f
+#define TUNER_MAX_LAG (SAMPLE_RATE / TUNER_DECIMATION / TUNER_MIN_HZ + 2)
+#define TUNER_HOP 1024                    // input samples between analyses
+#define TUNER_PEAK_K 0.9f
+#define TUNER_MIN_CLARITY 0.8f
+#define TUNER_REPORT_MS 200
+
+typedef struct Tuner_Result_t{
+    uint8_t valid;        // enough level and a clear period
+    float hz;
+    int32_t note;         // MIDI note number, 69 = A4
+    float cents;          // -50..50 from the note
+    float clarity;        // NSDF peak, 0..1
+}Tuner_Result_t;
+
+typedef struct Tuner_t{
+    // Audio side
+    float ring[TUNER_RING];
+    uint32_t pos;
+    uint32_t fresh;       // samples since the last snapshot
+
+    // Idle side
+    uint32_t step;
+    float rate;           // decimated
+    float a4;
+    float minPower;
+    float fir[TUNER_FIR_TAPS];
+    float m[TUNER_MAX_LAG + 1];
+    float x[TUNER_FFT];
+    float X[TUNER_FFT];
+    arm_rfft_fast_instance_f32 fft;
+    uint32_t sinceReport; // input samples
+    Tuner_Result_t result;
+}Tuner_t;
+
+// a4: reference pitch in Hz (440); below min_dB RMS the result is invalid
+void Tuner_Init(Tuner_t* t, float a4, float min_dB);
+// Audio path: mono input, n <= TUNER_HOP
+void Tuner_Push(Tuner_t* t, const float* x, uint32_t n);
+// One analysis step from the idle loop, returns 0 when there was nothing to do
+uint8_t Tuner_Background(Tuner_t* t);
+const Tuner_Result_t* Tuner_GetResult(const Tuner_t* t);
+
+#endif // TUNER_H
@@ -0,0 +1,61 @@
+#ifndef WAVESHAPER_H
+#define WAVESHAPER_H
+
+#include <stdint.h>
+#include "waveshaper_tables.h" // generated at build time: WS_Curve_t
+
+/*Table-driven static waveshaper. Curves are sampled on [-x_max, x_max] by
+tools/gen_waveshaper_tables.py and linked as const data (flash); inputs outside
+the range clamp to the end values.*/
+
+typedef struct WS_Table_t{
+    const float* data;  // segments + 3 points: guard, grid, guard
+    uint32_t segments;
+    float x_max;
+    float inv_step;     // segments / (2 * x_max)
+}WS_Table_t;
+
+extern const WS_Table_t ws_tables[WS_CURVE_COUNT];
+
+typedef enum {
+    WS_INTERP_LINEAR,
+    WS_INTERP_CUBIC     // Catmull-Rom
+} WS_Interp_t;
+
+typedef struct Waveshaper_t{
+    const WS_Table_t* table;
+    WS_Interp_t interp;
+}Waveshaper_t;
+
+void Waveshaper_Init(Waveshaper_t* ws, WS_Curve_t curve, WS_Interp_t interp);
+void Waveshaper_ProcessBlock(const Waveshaper_t* ws, const float* in, float* out, uint32_t n);
+
+// Table position of x: segment index and fraction
+static inline const float* WS_Locate(const WS_Table_t* t, float x, float* frac){
+    float pos = (x + t->x_max) * t->inv_step;
+    if (pos < 0.0f) pos = 0.0f;
+    if (pos > (float)t->segments) pos = (float)t->segments;
+    uint32_t i = (uint32_t)pos;
+    if (i >= t->segments) i = t->segments - 1;
+    *frac = pos - (float)i;
+    return &t->data[i + 1];
+}
+
+static inline float WS_LookupLinear(const WS_Table_t* t, float x){
+    float f;
+    const float* p = WS_Locate(t, x, &f);
+    return p[0] + f * (p[1] - p[0]);
+}
+
+static inline float WS_LookupCubic(const WS_Table_t* t, float x){
+    float f;
+    const float* p = WS_Locate(t, x, &f);
+    float a = p[-1], b = p[0], c = p[1], d = p[2];
+    return b + 0.5f * f * (c - a + f * (2.0f*a - 5.0f*b + 4.0f*c - d + f * (3.0f*(b - c) + d - a)));
+}
+
+static inline float Waveshaper_ProcessSample(const Waveshaper_t* ws, float x){
+    return (ws->interp == WS_INTERP_CUBIC) ? WS_LookupCubic(ws->table, x) : WS_LookupLinear(ws->table, x);
+}
+
+#endif // WAVESHAPER_H
@@ -0,0 +1,169 @@
+#include "ampsim.h"
+#include "waveshaper.h"
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Stage voicing: interstage high-pass and low-pass corners, tanh operating point.
+// Early stages pass more lows, later ones tighten the bass and darken the fizz.
+static const struct { float hpf_hz, lpf_hz, bias; } stage_voice[AMP_MAX_STAGES] = {
+    { 30.0f, 12000.0f,  0.20f},
+    { 90.0f,  9000.0f, -0.30f},
+    {150.0f,  7000.0f,  0.25f},
+    {200.0f,  6000.0f, -0.20f},
+    {160.0f,  5500.0f,  0.30f},
+    {220.0f,  5000.0f, -0.25f},
+};
+
+// 59 Bassman tone stack: R1 treble pot, R2 bass pot, R3 mid pot, R4 slope resistor
+#define TS_R1 250e3
+#define TS_R2 1e6
+#define TS_R3 25e3
+#define TS_R4 56e3
+#define TS_C1 250e-12
+#define TS_C2 20e-9
+#define TS_C3 20e-9
+
+// First order high-pass times first order low-pass (bilinear, prewarped) as one biquad
+static void stage_design(AmpStage_t* st, float fs, float hpf_hz, float lpf_hz) {
+    float kh = tanf((float)M_PI * hpf_hz / fs);
+    float kl = tanf((float)M_PI * lpf_hz / fs);
+    float h0 = 1.0f / (1.0f + kh), h1 = -h0, ah = (kh - 1.0f) / (kh + 1.0f);
+    float l0 = kl / (1.0f + kl), l1 = l0, al = (kl - 1.0f) / (kl + 1.0f);
+
+    // CMSIS order b0, b1, b2, a1, a2 with the feedback terms negated
+    st->coeffs[0] = h0 * l0;
+    st->coeffs[1] = h0 * l1 + h1 * l0;
+    st->coeffs[2] = h1 * l1;
+    st->coeffs[3] = -(ah + al);
+    st->coeffs[4] = -(ah * al);
+}
+
+// Real root in (-1, 1) of z^3 + d1 z^2 + d2 z + d3 (a stable cubic changes sign there)
+static double cubic_real_root(double d1, double d2, double d3) {
+    double lo = -1.0, hi = 1.0;
+    for (int i = 0; i < 60; i++) {
+        double mid = 0.5 * (lo + hi);
+        double v = ((mid + d1) * mid + d2) * mid + d3;
+        if (v > 0.0) hi = mid; else lo = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+/*Analog TMB response H(s) = (b1 s + b2 s^2 + b3 s^3) / (1 + a1 s + a2 s^2 + a3 s^3),
+bilinear transformed and factored as (1 - z^-1)/(1 - p z^-1) times a biquad: the s in
+the numerator is the zero at DC, p the real pole of the digital denominator.*/
+static void tone_design(AmpSim_t* amp) {
+    const double R1 = TS_R1, R2 = TS_R2, R3 = TS_R3, R4 = TS_R4;
+    const double C1 = TS_C1, C2 = TS_C2, C3 = TS_C3;
+    const double t = amp->treble, m = amp->mid;
+    const double l = exp((amp->bass - 1.0) * 3.4); // audio taper
+    const double C123 = C1 * C2 * C3;
+
+    double b1 = t*C1*R1 + m*C3*R3 + l*(C1*R2 + C2*R2) + (C1*R3 + C2*R3);
+    double b2 = t*(C1*C2*R1*R4 + C1*C3*R1*R4) - m*m*(C1*C3*R3*R3 + C2*C3*R3*R3)
+              + m*(C1*C3*R1*R3 + C1*C3*R3*R3 + C2*C3*R3*R3)
+              + l*(C1*C2*R1*R2 + C1*C2*R2*R4 + C1*C3*R2*R4) + l*m*(C1*C3*R2*R3 + C2*C3*R2*R3)
+              + (C1*C2*R1*R3 + C1*C2*R3*R4 + C1*C3*R3*R4);
+    double b3 = l*m*C123*(R1*R2*R3 + R2*R3*R4) - m*m*C123*(R1*R3*R3 + R3*R3*R4)
+              + m*C123*(R1*R3*R3 + R3*R3*R4) + t*C123*R1*R3*R4 - t*m*C123*R1*R3*R4
+              + t*l*C123*R1*R2*R4;
+    double a1 = (C1*R1 + C1*R3 + C2*R3 + C2*R4 + C3*R4) + m*C3*R3 + l*(C1*R2 + C2*R2);
+    double a2 = m*(C1*C3*R1*R3 - C2*C3*R3*R4 + C1*C3*R3*R3 + C2*C3*R3*R3)
+              + l*m*(C1*C3*R2*R3 + C2*C3*R2*R3) - m*m*(C1*C3*R3*R3 + C2*C3*R3*R3)
+              + l*(C1*C2*R2*R4 + C1*C2*R1*R2 + C1*C3*R2*R4 + C2*C3*R2*R4)
+              + (C1*C2*R1*R4 + C1*C3*R1*R4 + C1*C2*R3*R4 + C1*C2*R1*R3 + C1*C3*R3*R4 + C2*C3*R3*R4);
+    double a3 = l*m*C123*(R1*R2*R3 + R2*R3*R4) - m*m*C123*(R1*R3*R3 + R3*R3*R4)
+              + m*C123*(R3*R3*R4 + R1*R3*R3 - R1*R3*R4) + l*C123*R1*R2*R4 + C123*R1*R3*R4;
+
+    // s = c (1 - z^-1) / (1 + z^-1)
+    const double c = 2.0 * amp->sample_rate;
+    const double c2 = c * c, c3 = c2 * c;
+    double B0 = b1*c + b2*c2 + b3*c3;
+    double B1 = b1*c - b2*c2 - 3.0*b3*c3;
+    double B2 = -b1*c - b2*c2 + 3.0*b3*c3;
+    double A0 = 1.0 + a1*c + a2*c2 + a3*c3;
+    double A1 = 3.0 + a1*c - a2*c2 - 3.0*a3*c3;
+    double A2 = 3.0 - a1*c - a2*c2 + 3.0*a3*c3;
+    double A3 = 1.0 - a1*c + a2*c2 - a3*c3;
+
+    // Numerator / (1 - z^-1): synthetic division by the DC zero
+    double q1 = B1 + B0;
+    double q2 = B2 + q1;
+    // Denominator / (1 - p z^-1)
+    double d1 = A1 / A0, d2 = A2 / A0, d3 = A3 / A0;
+    double p = cubic_real_root(d1, d2, d3);
+    double e1 = d1 + p;
+    double e2 = d2 + p * e1;
+
+    float* k = amp->toneCoeffs;
+    k[0] = 1.0f; k[1] = -1.0f; k[2] = 0.0f; k[3] = (float)p; k[4] = 0.0f;
+    k[5] = (float)(B0 / A0); k[6] = (float)(q1 / A0); k[7] = (float)(q2 / A0);
+    k[8] = (float)-e1; k[9] = (float)-e2;
+}
+
+void AmpSim_Init(AmpSim_t* amp, float sample_rate, uint32_t stages) {
+    memset(amp, 0, sizeof(*amp));
+    if (stages < 1) stages = 1;
+    if (stages > AMP_MAX_STAGES) stages = AMP_MAX_STAGES;
+    amp->sample_rate = sample_rate;
+    amp->stages = stages;
+
+    for (uint32_t s = 0; s < stages; s++) {
+        AmpStage_t* st = &amp->stage[s];
+        stage_design(st, sample_rate, stage_voice[s].hpf_hz, stage_voice[s].lpf_hz);
+        arm_biquad_cascade_df2T_init_f32(&st->filt, 1, st->coeffs, st->state);
+        st->bias = stage_voice[s].bias;
+        st->offset = WS_LookupLinear(&ws_tables[WS_CURVE_TANH], st->bias); // same curve as the stage
+    }
+    arm_biquad_cascade_df2T_init_f32(&amp->tone, 2, amp->toneCoeffs, amp->toneState);
+
+    amp->gain = -1.0f; // force the first design
+    amp->bass = -1.0f;
+    AmpSim_SetGain(amp, 20.0f);
+    AmpSim_SetTone(amp, 0.5f, 0.5f, 0.5f);
+    AmpSim_SetOutput(amp, 2.0f); // makes up the ~10 dB mid loss of the tone stack
+}
+
+void AmpSim_SetGain(AmpSim_t* amp, float gain) {
+    if (gain < 1.0f) gain = 1.0f;
+    if (gain == amp->gain) return;
+    amp->gain = gain;
+    float per_stage = powf(gain, 1.0f / (float)amp->stages);
+    for (uint32_t s = 0; s < amp->stages; s++) {
+        amp->stage[s].gain = per_stage;
+    }
+}
+
+void AmpSim_SetTone(AmpSim_t* amp, float bass, float mid, float treble) {
+    if (bass == amp->bass && mid == amp->mid && treble == amp->treble) return;
+    amp->bass = bass;
+    amp->mid = mid;
+    amp->treble = treble;
+    tone_design(amp);
+}
+
+void AmpSim_SetOutput(AmpSim_t* amp, float output) {
+    amp->output = output;
+}
+
+void AmpSim_ProcessBlock(AmpSim_t* amp, const float* in, float* out, uint32_t n) {
+    const WS_Table_t* tanh_table = &ws_tables[WS_CURVE_TANH];
+    const float* src = in;
+
+    for (uint32_t s = 0; s < amp->stages; s++) {
+        AmpStage_t* st = &amp->stage[s];
+        arm_biquad_cascade_df2T_f32(&st->filt, src, out, n);
+        src = out;
+        // Inverting stage: -(tanh(g x + bias) - tanh(bias))
+        for (uint32_t i = 0; i < n; i++) {
+            out[i] = st->offset - WS_LookupLinear(tanh_table, st->gain * out[i] + st->bias);
+        }
+    }
+
+    arm_biquad_cascade_df2T_f32(&amp->tone, out, out, n);
+    arm_scale_f32(out, amp->output, out, n);
+}
@@ -1,11 +1,34 @@
 #include "dsp_configuration.h"
 #include "audio_processing.h"
 #include "reverb.h"
+#include "fdn_reverb.h"
+#include "plate_reverb.h"
+#include "reduced_rate.h"
+#include "shimmer.h"
+#include "lfo.h"
 #include "delay.h"
 #include "distortion.h"
 #include "spring_verb.h"
+#include "looper.h"
+#include "dsp_bench.h"
+#include "fx_bench.h"
+#include "cabsim.h"
+#include "convreverb.h"
+#include "neural_amp.h"
+#include "neural_amp_model.h"
+#include "ampsim.h"
+#include "eq.h"
+#include "compressor.h"
+#include "truepeak.h"
+#include "gate.h"
+#include "tuner.h"
+#include "harmonizer.h"
+#include "modulation.h"
+#include "phaser.h"
+#include "autowah.h"
 #include "SEGGER_SYSVIEW.h"
 #include <stdint.h>
+#include <string.h>
 #include <math.h>
 
 /*rxBuf and txBuf are used for I2S DMA transfer, l_buf_in and
@@ -29,11 +52,285 @@ static float r_buf_out [BLOCK_SIZE_FLOAT*2];
 static I2S_DMA_Callback_State_t callback_state = I2S_DMA_CALLBACK_IDLE;
 static FX_Delay_t dly_fx;
 static DS1 ds1_fx;
+static DS1 ds1_fx_r;
 static SpringReverb spring_reverb_fx;
+#ifdef REVERB_ENABLE
+static Reverb_t reverb_fx;
+static Reverb_Config_t reverb_cfg;
+#ifdef REVERB_POOL_SECTION
+__attribute__((section(REVERB_POOL_SECTION)))
+#endif
+static float reverbPool[REVERB_POOL_SIZE];
+#ifdef FDN_ENABLE
+static FDN_t fdn_fx;
+static float fdnSramPool[FDN_SRAM_POOL_SIZE];
+#endif // FDN_ENABLE
+#ifdef PLATE_ENABLE
+static Plate_t plate_fx;
+static float plateSramPool[PLATE_SRAM_POOL_SIZE];
+#endif // PLATE_ENABLE
+static ReducedRate_t reverb_rr;
+#ifdef SHIMMER_ENABLE
+static Shimmer_t shimmer_fx;
+static float shimmerPool[SHIMMER_POOL_SIZE(SAMPLE_RATE / REVERB_DECIMATION)];
+#endif // SHIMMER_ENABLE
+#define REVERB_RATE ((float)SAMPLE_RATE / REVERB_DECIMATION)
 
-#define SPRING_BUFFER_SIZE 8000
+/*Schroeder's lines stretched by REVERB_SIZE: the lengths are declared at a rate that much lower*/
+static void reverb_config(void)
+{
+    reverb_cfg = Reverb_DefaultConfig;
+    reverb_cfg.rate /= REVERB_SIZE;
+#ifdef REVERB_Q15
+    reverb_cfg.q15 = 1;
+#endif // REVERB_Q15
+}
+#endif // REVERB_ENABLE
+#ifdef NEURAL_AMP_ENABLE
+static NeuralAmp_t nam_fx;
+#endif // NEURAL_AMP_ENABLE
+#ifdef AMPSIM_ENABLE
+static AmpSim_t amp_fx;
+static AmpSim_t amp_fx_r;
+#endif // AMPSIM_ENABLE
+
+#define SPRING_BUFFER_SIZE SPRING_MEM_SIZE(SPRING_COUNT, SPRING_SECTIONS)
 static float springBuffer[SPRING_BUFFER_SIZE];
 
+#ifdef CAB_ENABLE
+static CabIR_t cab_ir;
+static CabSim_t cab_l;
+static CabSim_t cab_r;
+static float cabSpectra[CAB_IR_SIZE(CAB_IR_TAPS, CAB_PARTITION)];
+static float cabMem[2 * CAB_CHANNEL_SIZE(CAB_IR_TAPS, CAB_PARTITION)]; // left, right
+#endif // CAB_ENABLE
+
+#ifdef EQ_ENABLE
+static EQ_t eq_fx;
+#endif // EQ_ENABLE
+
+#ifdef COMP_ENABLE
+static Compressor_t comp_fx;
+#endif // COMP_ENABLE
+#ifdef LIMITER_ENABLE
+static Compressor_t limiter_fx;
+#endif // LIMITER_ENABLE
+#ifdef TRUEPEAK_ENABLE
+static TruePeak_t truepeak_fx;
+#endif // TRUEPEAK_ENABLE
+#ifdef GATE_ENABLE
+static Gate_t gate_fx;
+#endif // GATE_ENABLE
+#ifdef TUNER_ENABLE
+static Tuner_t tuner_fx;
+#endif // TUNER_ENABLE
+#ifdef HARMONIZER_ENABLE
+static Harmonizer_t harm_fx;
+#endif // HARMONIZER_ENABLE
+/*The modulation matrix runs whenever an effect takes a destination from it*/
+#if defined(MOD_ENABLE) || defined(PHASER_ENABLE) || defined(AUTOWAH_ENABLE)
+#define MOD_MATRIX
+enum {
+    MOD_DEST_LEVEL,
+    MOD_DEST_PAN,
+    MOD_DEST_PHASER_L,
+    MOD_DEST_PHASER_R,
+    MOD_DEST_WAH
+};
+static Mod_t mod_fx;
+#endif // MOD_ENABLE || PHASER_ENABLE || AUTOWAH_ENABLE
+#ifdef PHASER_ENABLE
+static Phaser_t phaser_fx;
+#endif // PHASER_ENABLE
+#ifdef AUTOWAH_ENABLE
+static AutoWah_t wah_fx;
+#endif // AUTOWAH_ENABLE
+
+#ifdef CONVREV_ENABLE
+static ConvReverb_t convrev_fx;
+#ifdef CONVREV_POOL_SECTION
+__attribute__((section(CONVREV_POOL_SECTION)))
+#endif
+static float convrevPool[CONVREV_MEM_SIZE(CONVREV_IR_TAPS) + CONVREV_IR_TAPS]; // levels, then the IR taps
+#define CONVREV_IR (&convrevPool[CONVREV_MEM_SIZE(CONVREV_IR_TAPS)])
+#endif // CONVREV_ENABLE
+
+#ifdef LOOPER_ENABLE
+static Looper_t looper_fx;
+#ifdef LOOPER_POOL_SECTION
+__attribute__((section(LOOPER_POOL_SECTION)))
+#endif
+static float looperPool[LOOPER_POOL_SAMPLES];
+#endif // LOOPER_ENABLE
+
+#if !defined(TRUEPEAK_ENABLE) || defined(DSP_BENCH_ENABLE)
+/*Plain output conversion: clamp, round and split into the MSB-aligned 16-bit DMA words.
+Overs clip hard, TRUEPEAK_ENABLE replaces it with the limiting converter*/
+static void output_clamp(const float* l, const float* r, uint16_t* tx, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        /* Round to nearest integer in 24-bit range (use INT24_SCALE_OUT) */
+        float fl = l[i];
+        float fr = r[i];
+
+        /* clamp normalized floats just in case */
+        if (fl > 1.0f) fl = 1.0f;
+        if (fl < -1.0f) fl = -1.0f;
+        if (fr > 1.0f) fr = 1.0f;
+        if (fr < -1.0f) fr = -1.0f;
+
+        int32_t s24L = (int32_t)lrintf(fl * INT24_SCALE_OUT); /* range -2^23..2^23-1 */
+        int32_t s24R = (int32_t)lrintf(fr * INT24_SCALE_OUT);
+
+        /* clamp to signed 24-bit just in case */
+        if (s24L >  0x7FFFFF) s24L =  0x7FFFFF;
+        if (s24L < -0x800000) s24L = -0x800000;
+        if (s24R >  0x7FFFFF) s24R =  0x7FFFFF;
+        if (s24R < -0x800000) s24R = -0x800000;
+
+        /* Left-justify into 32-bit word (24-bit MSB-aligned) */
+        uint32_t out32L = ((uint32_t)(s24L & 0xFFFFFF)) << 8;
+        uint32_t out32R = ((uint32_t)(s24R & 0xFFFFFF)) << 8;
+
+        /* Split into two 16-bit words for DMA */
+        tx[4 * i]     = (uint16_t)((out32L >> 16) & 0xFFFF);
+        tx[4 * i + 1] = (uint16_t)(out32L & 0xFFFF);
+        tx[4 * i + 2] = (uint16_t)((out32R >> 16) & 0xFFFF);
+        tx[4 * i + 3] = (uint16_t)(out32R & 0xFFFF);
+    }
+}
+#endif // !TRUEPEAK_ENABLE || DSP_BENCH_ENABLE
+
+#ifdef MOD_ENABLE
+/*Tremolo and auto-pan in one gain pair, ramped across the block from the destinations'
+values at its start and end. Equal power pan from the sine table: cos and sin of
+pi/4 (pan + 1), scaled so the centre is unity.*/
+static void mod_gains(float level, float pan, float* gl, float* gr)
+{
+    uint32_t phase = (uint32_t)((pan + 1.0f) * 536870912.0f); // 2^32 / 8 per unit
+    *gl = 1.41421356f * level * LFO_SineAt(0x40000000u - phase);
+    *gr = 1.41421356f * level * LFO_SineAt(phase);
+}
+
+static void mod_tremolo_pan(float* l, float* r, uint32_t n)
+{
+    float gl, gr, gl1, gr1;
+    mod_gains(Mod_Prev(&mod_fx, MOD_DEST_LEVEL), Mod_Prev(&mod_fx, MOD_DEST_PAN), &gl, &gr);
+    mod_gains(Mod_Value(&mod_fx, MOD_DEST_LEVEL), Mod_Value(&mod_fx, MOD_DEST_PAN), &gl1, &gr1);
+    const float dl = (gl1 - gl) / (float)n;
+    const float dr = (gr1 - gr) / (float)n;
+    for (uint32_t i = 0; i < n; i++) {
+        gl += dl;
+        gr += dr;
+        l[i] *= gl;
+        r[i] *= gr;
+    }
+}
+#endif // MOD_ENABLE
+
+/*Drive to output limiter on the block at 'offset_w_ptr': l/r_buf_in to l/r_buf_out*/
+static void process_chain(int offset_w_ptr)
+{
+#ifdef MOD_MATRIX
+    /* ---------- MODULATION: sources, routes and smoothing once per block ---------- */
+    Mod_FeedEnvelope(&mod_fx, 0, &l_buf_in[offset_w_ptr], &r_buf_in[offset_w_ptr], BLOCK_SIZE_FLOAT);
+    Mod_Update(&mod_fx, BLOCK_SIZE_FLOAT);
+#endif // MOD_MATRIX
+
+#ifdef AUTOWAH_ENABLE
+    /* ---------- WAH: input envelope sweep, ahead of the drive ---------- */
+    AutoWah_ProcessBlock(&wah_fx, &l_buf_in[offset_w_ptr], &r_buf_in[offset_w_ptr], BLOCK_SIZE_FLOAT,
+                         Mod_Value(&mod_fx, MOD_DEST_WAH));
+#endif // AUTOWAH_ENABLE
+
+#ifdef NEURAL_AMP_ENABLE
+    /* ---------- DRIVE: neural amp model on the left input, copied to both channels ---------- */
+    NeuralAmp_ProcessBlock(&nam_fx, &l_buf_in[offset_w_ptr], &l_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+    memcpy(&r_buf_out[offset_w_ptr], &l_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT * sizeof(float));
+#elif defined(AMPSIM_ENABLE)
+    /* ---------- DRIVE: amp simulator per channel ---------- */
+    AmpSim_ProcessBlock(&amp_fx, &l_buf_in[offset_w_ptr], &l_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+    AmpSim_ProcessBlock(&amp_fx_r, &r_buf_in[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+#else
+    /* ---------- DRIVE: DS1 per channel, block-wise so the clipper can be oversampled ---------- */
+    DS1_ProcessBlock(&ds1_fx, &l_buf_in[offset_w_ptr], &l_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+    DS1_ProcessBlock(&ds1_fx_r, &r_buf_in[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+#endif // NEURAL_AMP_ENABLE
+
+#ifdef CAB_ENABLE
+    /* ---------- CAB: speaker cabinet IR, in place ---------- */
+    CabSim_ProcessBlock(&cab_l, &l_buf_out[offset_w_ptr], &l_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+    CabSim_ProcessBlock(&cab_r, &r_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+#endif // CAB_ENABLE
+
+#ifdef EQ_ENABLE
+    /* ---------- EQ: parametric bands, in place ---------- */
+    EQ_ProcessBlock(&eq_fx, &l_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+#endif // EQ_ENABLE
+
+#ifdef COMP_ENABLE
+    /* ---------- DYNAMICS: compressor ahead of the time based FX ---------- */
+    Compressor_ProcessBlock(&comp_fx, &l_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+#endif // COMP_ENABLE
+
+#ifdef HARMONIZER_ENABLE
+    /* ---------- PITCH: harmony voices over the dry signal ---------- */
+    Harmonizer_ProcessBlock(&harm_fx, &l_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+#endif // HARMONIZER_ENABLE
+
+#ifdef MOD_ENABLE
+    /* ---------- TREMOLO / AUTO-PAN ---------- */
+    mod_tremolo_pan(&l_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+#endif // MOD_ENABLE
+
+#ifdef PHASER_ENABLE
+    /* ---------- PHASER: allpass chain per channel, LFO sweeps in quadrature ---------- */
+    Phaser_ProcessBlock(&phaser_fx, &l_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT,
+                        Mod_Value(&mod_fx, MOD_DEST_PHASER_L), Mod_Value(&mod_fx, MOD_DEST_PHASER_R));
+#endif // PHASER_ENABLE
+
+    /* ---------- PROCESS: per-sample DSP (expects normalized floats) ---------- */
+    for (int i = offset_w_ptr; i < offset_w_ptr + BLOCK_SIZE_FLOAT; i++) {
+        float temp_l = l_buf_out[i];
+        float temp_r = r_buf_out[i];
+
+        /* Optionally chain other FX here */
+        FX_Do_DelayStereo(&dly_fx, &temp_l, &temp_r);
+
+        /* Store normalized result back (keep floats in [-1,1]) for clarity */
+        l_buf_out[i] = temp_l;
+        r_buf_out[i] = temp_r; // For mono processing, use the same output for both channels
+    }
+
+    /* ---------- BLOCK FX: operate in place on the output half ---------- */
+    SpringReverb_ProcessBlock(&spring_reverb_fx, &l_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+#ifdef REVERB_ENABLE
+    ReducedRate_ProcessBlock(&reverb_rr, &l_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+#endif // REVERB_ENABLE
+#ifdef CONVREV_ENABLE
+    ConvReverb_ProcessBlock(&convrev_fx, &l_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+#endif // CONVREV_ENABLE
+#ifdef LOOPER_ENABLE
+    Looper_ProcessBlock(&looper_fx, &l_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+#endif // LOOPER_ENABLE
+#ifdef LIMITER_ENABLE
+    Compressor_ProcessBlock(&limiter_fx, &l_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
+#endif // LIMITER_ENABLE
+}
+
+#ifdef GATE_ENABLE
+/*The gate only idles the chain when nothing else needs it running: the looper keeps
+its clock while it records or has a command waiting*/
+static uint8_t chain_may_sleep(void)
+{
+#ifdef LOOPER_ENABLE
+    if (looper_fx.pending != LOOPER_CMD_NONE) return 0;
+    if (looper_fx.state != LOOPER_EMPTY && looper_fx.state != LOOPER_STOP) return 0;
+#endif // LOOPER_ENABLE
+    return 1;
+}
+#endif // GATE_ENABLE
+
 void processAudio(void)
 {
     int offset_r_ptr = 0;
@@ -71,62 +368,32 @@ void processAudio(void)
             w_ptr++;
         }
 
-        /* ---------- PROCESS: per-sample DSP (expects normalized floats) ---------- */
-        for (int i = offset_w_ptr; i < offset_w_ptr + BLOCK_SIZE_FLOAT; i++) {
-            float inL = l_buf_in[i];
-            float inR = r_buf_in[i];
-            float temp_l = 0.0f;
-            float temp_r = 0.0f;
-
-            /* Call your DSP function (DS1 / Overdrive / etc) that expects normalized floats */
-            temp_l = DS1_ProcessSample(&ds1_fx, inL);
-            temp_r = DS1_ProcessSample(&ds1_fx, inR);
-
-            /* Optionally chain other FX here */
-            temp_l = FX_Do_Delay(&dly_fx, temp_l);
-            temp_r = FX_Do_Delay(&dly_fx, temp_r);
-            temp_l = SpringReverb_ProcessSample(&spring_reverb_fx, temp_l);
-            temp_r = SpringReverb_ProcessSample(&spring_reverb_fx, temp_r);
-
-            /* Store normalized result back (keep floats in [-1,1]) for clarity */
-            l_buf_out[i] = temp_l;
-            r_buf_out[i] = temp_r; // For mono processing, use the same output for both channels
+#ifdef TUNER_ENABLE
+        /* ---------- TUNER: ahead of the gate, the analysis runs from audio_Background ---------- */
+        Tuner_Push(&tuner_fx, &l_buf_in[offset_w_ptr], BLOCK_SIZE_FLOAT);
+#endif // TUNER_ENABLE
+
+#ifdef GATE_ENABLE
+        /* ---------- GATE: skip the chain while closed and the tails are gone ---------- */
+        Gate_ProcessBlock(&gate_fx, &l_buf_in[offset_w_ptr], &r_buf_in[offset_w_ptr], BLOCK_SIZE_FLOAT);
+        if (Gate_Idle(&gate_fx) && chain_may_sleep()) {
+            memset(&l_buf_out[offset_w_ptr], 0, BLOCK_SIZE_FLOAT * sizeof(float));
+            memset(&r_buf_out[offset_w_ptr], 0, BLOCK_SIZE_FLOAT * sizeof(float));
+        } else {
+            process_chain(offset_w_ptr);
+            Gate_WatchTail(&gate_fx, &l_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], BLOCK_SIZE_FLOAT);
         }
+#else
+        process_chain(offset_w_ptr);
+#endif // GATE_ENABLE
 
+#ifdef TRUEPEAK_ENABLE
+        /* ---------- OUTPUT: true-peak limiter and 24-bit packing in one pass ---------- */
+        TruePeak_ProcessBlock(&truepeak_fx, &l_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], &txBuf[offset_r_ptr], BLOCK_SIZE_FLOAT);
+#else
         /* ---------- OUTPUT: convert normalized floats back to 24-bit MSB-aligned words ---------- */
-        w_ptr = offset_w_ptr;
-        for (int i = offset_r_ptr; i < offset_r_ptr + BLOCK_SIZE_U16; i += 4) {
-            /* Round to nearest integer in 24-bit range (use INT24_SCALE_OUT) */
-            float fl = l_buf_out[w_ptr];
-            float fr = r_buf_out[w_ptr];
-
-            /* clamp normalized floats just in case */
-            if (fl > 1.0f) fl = 1.0f;
-            if (fl < -1.0f) fl = -1.0f;
-            if (fr > 1.0f) fr = 1.0f;
-            if (fr < -1.0f) fr = -1.0f;
-
-            int32_t s24L = (int32_t)lrintf(fl * INT24_SCALE_OUT); /* range -2^23..2^23-1 */
-            int32_t s24R = (int32_t)lrintf(fr * INT24_SCALE_OUT);
-
-            /* clamp to signed 24-bit just in case */
-            if (s24L >  0x7FFFFF) s24L =  0x7FFFFF;
-            if (s24L < -0x800000) s24L = -0x800000;
-            if (s24R >  0x7FFFFF) s24R =  0x7FFFFF;
-            if (s24R < -0x800000) s24R = -0x800000;
-
-            /* Left-justify into 32-bit word (24-bit MSB-aligned) */
-            uint32_t out32L = ((uint32_t)(s24L & 0xFFFFFF)) << 8;
-            uint32_t out32R = ((uint32_t)(s24R & 0xFFFFFF)) << 8;
-
-            /* Split into two 16-bit words for DMA */
-            txBuf[i]   = (uint16_t)((out32L >> 16) & 0xFFFF);
-            txBuf[i+1] = (uint16_t)(out32L & 0xFFFF);
-            txBuf[i+2] = (uint16_t)((out32R >> 16) & 0xFFFF);
-            txBuf[i+3] = (uint16_t)(out32R & 0xFFFF);
-
-            w_ptr++;
-        }
+        output_clamp(&l_buf_out[offset_w_ptr], &r_buf_out[offset_w_ptr], &txBuf[offset_r_ptr], BLOCK_SIZE_FLOAT);
+#endif // TRUEPEAK_ENABLE
 
         callback_state = I2S_DMA_CALLBACK_IDLE;
         SEGGER_SYSVIEW_Print("DSP: Processing finished");
@@ -134,19 +401,344 @@ void processAudio(void)
     }
 }
 
+/*Idle time work, called from the main loop between blocks. One item per call so a
+pending block is never held back by more than the largest item.*/
+void audio_Background(void)
+{
+    if (callback_state != I2S_DMA_CALLBACK_IDLE) return;
+#ifdef CONVREV_ENABLE
+    if (ConvReverb_Background(&convrev_fx)) return;
+#endif // CONVREV_ENABLE
+#ifdef TUNER_ENABLE
+    Tuner_Background(&tuner_fx);
+#endif // TUNER_ENABLE
+}
+
 void audio_SetCallbackState(I2S_DMA_Callback_State_t state)
 {
     callback_state = state;
 }
 
+#ifdef DSP_BENCH_ENABLE
+#ifdef MOD_ENABLE
+/*Tremolo and auto-pan at control rate with the gain ramp, against the same effect with
+both LFOs and the pan gains evaluated per sample*/
+static void bench_tremolo_pan(void)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    static LFO_t trem, pan;
+    uint32_t start;
+
+    Mod_Init(&mod_fx, (float)SAMPLE_RATE);
+    Mod_SetLFO(&mod_fx, 0, MOD_SINE, MOD_TREMOLO_HZ, 0.0f);
+    Mod_SetLFO(&mod_fx, 1, MOD_SINE, MOD_PAN_HZ, 0.0f);
+    Mod_SetDest(&mod_fx, MOD_DEST_LEVEL, 0.75f, 0.0f, 1.0f, MOD_SMOOTH_MS);
+    Mod_SetDest(&mod_fx, MOD_DEST_PAN, 0.0f, -1.0f, 1.0f, MOD_SMOOTH_MS);
+    Mod_Route(&mod_fx, MOD_SRC_LFO(0), MOD_DEST_LEVEL, 0.25f);
+    Mod_Route(&mod_fx, MOD_SRC_LFO(1), MOD_DEST_PAN, 0.8f);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        memcpy(l_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+        memcpy(r_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+        Mod_Update(&mod_fx, BLOCK_SIZE_FLOAT);
+        mod_tremolo_pan(l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT);
+    }
+    DSP_Bench_Report("tremolo+pan block", start, frames);
+
+    LFO_SetRate(&trem, MOD_TREMOLO_HZ, (float)SAMPLE_RATE);
+    LFO_SetRate(&pan, MOD_PAN_HZ, (float)SAMPLE_RATE);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        memcpy(l_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+        memcpy(r_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+        for (uint32_t i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            float gl, gr;
+            mod_gains(0.75f + 0.25f * LFO_Next(&trem), 0.8f * LFO_Next(&pan), &gl, &gr);
+            l_buf_out[i] *= gl;
+            r_buf_out[i] *= gr;
+        }
+    }
+    DSP_Bench_Report("tremolo+pan per sample", start, frames);
+}
+#endif // MOD_ENABLE
+
+
+/*The whole chain after init, fed silence so the FX are left as they were (DSP_BENCH_ENABLE
+runs before the FX are set up, this runs at the end of audio_InitFX). With the gate: its
+own cost on an open and on a closing signal, and the block while the chain is skipped.*/
+static void bench_chain(void)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    uint32_t start;
+
+    memset(l_buf_in, 0, sizeof(l_buf_in));
+    memset(r_buf_in, 0, sizeof(r_buf_in));
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        process_chain((b & 1) * BLOCK_SIZE_FLOAT);
+    }
+    uint32_t chain = DSP_Bench_Report("chain", start, frames);
+
+#ifdef GATE_ENABLE
+    Gate_t gate;
+    DSP_Bench_FillInput(l_buf_out, BLOCK_SIZE_FLOAT);
+    Gate_Init(&gate, (float)SAMPLE_RATE, GATE_OPEN_DB, GATE_HYSTERESIS_DB, GATE_HOLD_MS, GATE_ATTACK_MS, GATE_RELEASE_MS);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        Gate_ProcessBlock(&gate, l_buf_out, l_buf_out, BLOCK_SIZE_FLOAT);
+    }
+    DSP_Bench_Report("gate open", start, frames);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        gate.state = GATE_RELEASE;
+        gate.gain = 0.5f;
+        Gate_ProcessBlock(&gate, r_buf_in, r_buf_in, BLOCK_SIZE_FLOAT);
+    }
+    DSP_Bench_Report("gate ramp", start, frames);
+
+    Gate_Init(&gate, (float)SAMPLE_RATE, GATE_OPEN_DB, GATE_HYSTERESIS_DB, GATE_HOLD_MS, GATE_ATTACK_MS, GATE_RELEASE_MS);
+    Gate_SetTail(&gate, (float)SAMPLE_RATE, GATE_SILENCE_DB, 0.0f);
+    Gate_WatchTail(&gate, l_buf_in, r_buf_in, BLOCK_SIZE_FLOAT);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        Gate_ProcessBlock(&gate, l_buf_in, r_buf_in, BLOCK_SIZE_FLOAT);
+        if (Gate_Idle(&gate) && chain_may_sleep()) {
+            memset(l_buf_out, 0, BLOCK_SIZE_FLOAT * sizeof(float));
+            memset(r_buf_out, 0, BLOCK_SIZE_FLOAT * sizeof(float));
+        } else {
+            process_chain(0);
+        }
+    }
+    uint32_t idle = DSP_Bench_Report("chain gated idle", start, frames);
+    SEGGER_SYSVIEW_PrintfHost("BENCH gate: idle saves %u.%02u cycles/frame",
+                              (chain - idle) / 100u, (chain - idle) % 100u);
+#else
+    (void)chain;
+#endif // GATE_ENABLE
+}
+
+/*Runs each effect over DSP_BENCH_BLOCKS blocks of a test signal using the live instances,
+must be called before the instances are initialized for real. The effect benches are in
+fx_bench.c, the ones here cover the engine's own stages.*/
+static void audio_RunBenchmarks(void)
+{
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    FX_Bench_Delay(&dly_fx);
+    FX_Bench_Spring(&spring_reverb_fx, springBuffer, SPRING_BUFFER_SIZE);
+#ifdef REVERB_ENABLE
+    const FX_Bench_Reverbs_t rv = {
+        .schroeder = &reverb_fx,
+        .cfg = &reverb_cfg,
+        .rr = &reverb_rr,
+        .pool = reverbPool,
+#ifdef FDN_ENABLE
+        .fdn = &fdn_fx,
+        .fdnSram = fdnSramPool,
+#endif // FDN_ENABLE
+#ifdef PLATE_ENABLE
+        .plate = &plate_fx,
+        .plateSram = plateSramPool,
+#endif // PLATE_ENABLE
+#ifdef SHIMMER_ENABLE
+        .shimmer = &shimmer_fx,
+        .shimmerPool = shimmerPool,
+#endif // SHIMMER_ENABLE
+    };
+    FX_Bench_Reverbs(&rv);
+#endif // REVERB_ENABLE
+    FX_Bench_Shaper();
+    FX_Bench_DS1(&ds1_fx);
+#ifdef AMPSIM_ENABLE
+    FX_Bench_Amp(&amp_fx);
+#endif // AMPSIM_ENABLE
+#ifdef EQ_ENABLE
+    FX_Bench_EQ(&eq_fx);
+#endif // EQ_ENABLE
+    FX_Bench_Dynamics();
+    FX_Bench_Output(output_clamp);
+#ifdef NEURAL_AMP_ENABLE
+    FX_Bench_NeuralAmp(&nam_fx);
+#endif // NEURAL_AMP_ENABLE
+#ifdef CAB_ENABLE
+    FX_Bench_Cab(&cab_ir, &cab_l, cabSpectra, cabMem, sizeof(cabMem) / sizeof(float));
+#endif // CAB_ENABLE
+#ifdef CONVREV_ENABLE
+    FX_Bench_ConvReverb(&convrev_fx, convrevPool);
+#endif // CONVREV_ENABLE
+#ifdef TUNER_ENABLE
+    FX_Bench_Tuner(&tuner_fx);
+#endif // TUNER_ENABLE
+#ifdef HARMONIZER_ENABLE
+    FX_Bench_Harmonizer(&harm_fx);
+#endif // HARMONIZER_ENABLE
+#ifdef MOD_ENABLE
+    FX_Bench_ModMatrix();
+    bench_tremolo_pan();
+#endif // MOD_ENABLE
+#if defined(PHASER_ENABLE) || defined(AUTOWAH_ENABLE)
+    FX_Bench_Swept();
+#endif // PHASER_ENABLE || AUTOWAH_ENABLE
+}
+#endif // DSP_BENCH_ENABLE
+
 void audio_InitFX(void)
 {
-    Reverb_Init();
-    SpringReverb_Init(&spring_reverb_fx, springBuffer, SPRING_BUFFER_SIZE, 0.5f, 0.3f);
+    LFO_InitTable();
+#ifdef REVERB_ENABLE
+    reverb_config();
+#endif // REVERB_ENABLE
+#ifdef DSP_BENCH_ENABLE
+    audio_RunBenchmarks();
+#endif // DSP_BENCH_ENABLE
+#ifdef REVERB_ENABLE
+    /* The reverb runs fully wet at REVERB_RATE, the wrapper mixes it in at REVERB_WET */
+    Reverb_Pool_t rv_pools[2];
+    uint32_t rv_pool_count = 1;
+    ReducedRate_Process_t rv_run;
+    void* rv_fx;
+    uint8_t rv_ok;
+    Reverb_PoolInit(&rv_pools[0], reverbPool, REVERB_POOL_SIZE);
+#ifdef FDN_ENABLE
+    Reverb_PoolInit(&rv_pools[1], fdnSramPool, FDN_SRAM_POOL_SIZE);
+    rv_pool_count = 2;
+    rv_ok = FDN_Init(&fdn_fx, rv_pools, rv_pool_count, FDN_DefaultLengths, REVERB_RATE, REVERB_RT60, FDN_HF_RATIO, 1.0f);
+    rv_run = FDN_Run;
+    rv_fx = &fdn_fx;
+#elif defined(PLATE_ENABLE)
+    Reverb_PoolInit(&rv_pools[1], plateSramPool, PLATE_SRAM_POOL_SIZE);
+    rv_pool_count = 2;
+    rv_ok = Plate_Init(&plate_fx, rv_pools, rv_pool_count, REVERB_RATE, PLATE_SIZE, PLATE_DECAY, PLATE_DAMPING, 1.0f);
+    rv_run = Plate_Run;
+    rv_fx = &plate_fx;
+#else
+    rv_ok = Reverb_Init(&reverb_fx, &rv_pools[0], &reverb_cfg, REVERB_RATE, REVERB_RT60, 1.0f);
+    rv_run = Reverb_Run;
+    rv_fx = &reverb_fx;
+#endif // FDN_ENABLE
+#ifdef SHIMMER_ENABLE
+    /* The shifter line has its own pool: the reverb's are sized to be filled */
+    Reverb_Pool_t sh_pool;
+    Reverb_PoolInit(&sh_pool, shimmerPool, SHIMMER_POOL_SIZE(SAMPLE_RATE / REVERB_DECIMATION));
+    Shimmer_Init(&shimmer_fx, &sh_pool, 1, REVERB_RATE, rv_run, rv_fx, SHIMMER_SEMITONES, SHIMMER_FEEDBACK);
+    rv_run = Shimmer_Run;
+    rv_fx = &shimmer_fx;
+#endif // SHIMMER_ENABLE
+    (void)rv_pool_count;
+    ReducedRate_Init(&reverb_rr, REVERB_DECIMATION, rv_run, rv_fx, REVERB_WET);
+    if (!rv_ok) ReducedRate_SetMix(&reverb_rr, 0.0f); // pool too small: bypassed
+#endif // REVERB_ENABLE
+    SpringReverb_Init(&spring_reverb_fx, springBuffer, SPRING_BUFFER_SIZE, SPRING_COUNT, SPRING_SECTIONS, SPRING_RT60, SPRING_MIX);
     FX_Delay_Init(&dly_fx, 400, 0.25f, 0.5f); //500ms delay, 50% mix, 50% feedback
+    FX_Delay_SetTape(&dly_fx, 3500.0f, 120.0f, 2.0f, 1.5f, 0.15f); //repeats darken above 3.5kHz, thin below 120Hz, 1.5ms wow, 0.15ms flutter
+#ifdef DELAY_TAPE_ENABLE
+    FX_Delay_EnableTape(&dly_fx, 1);
+#endif // DELAY_TAPE_ENABLE
 	DS1_Init(&ds1_fx, (float)SAMPLE_RATE); //Initialize overdrive with 48kHz sample rate
 	DS1_SetParams(&ds1_fx, 40.0f, 1.0f, 4000.0f, 100.0f, CLIP_HARD); //Set parameters: drive=30, output=1, tone=6kHz, hpf=720Hz, clipping type=hard
+	DS1_SetOversampling(&ds1_fx, OD_OVERSAMPLE);
+	DS1_Init(&ds1_fx_r, (float)SAMPLE_RATE);
+	DS1_SetParams(&ds1_fx_r, 40.0f, 1.0f, 4000.0f, 100.0f, CLIP_HARD);
+	DS1_SetOversampling(&ds1_fx_r, OD_OVERSAMPLE);
+#ifdef AMPSIM_ENABLE
+    AmpSim_Init(&amp_fx, (float)SAMPLE_RATE, AMP_STAGES);
+    AmpSim_SetGain(&amp_fx, AMP_GAIN);
+    AmpSim_Init(&amp_fx_r, (float)SAMPLE_RATE, AMP_STAGES);
+    AmpSim_SetGain(&amp_fx_r, AMP_GAIN);
+#endif // AMPSIM_ENABLE
+#ifdef NEURAL_AMP_ENABLE
+    NeuralAmp_Init(&nam_fx, neural_amp_model, sizeof(neural_amp_model)); // invalid blob: stage passes through
+#endif // NEURAL_AMP_ENABLE
+#ifdef CAB_ENABLE
+    CabIR_InitDefault(&cab_ir, cabSpectra, CAB_PARTITION, CAB_IR_TAPS);
+    CabSim_Init(&cab_l, &cab_ir, cabMem);
+    CabSim_Init(&cab_r, &cab_ir, cabMem + CAB_CHANNEL_SIZE(CAB_IR_TAPS, CAB_PARTITION));
+#endif // CAB_ENABLE
+#ifdef EQ_ENABLE
+    EQ_Init(&eq_fx, (float)SAMPLE_RATE);
+    EQ_SetBand(&eq_fx, 0, EQ_HIGH_PASS, EQ_HPF_HZ, 0.70710678f, 0.0f);
+    EQ_SetBand(&eq_fx, 1, EQ_LOW_SHELF, EQ_LOW_HZ, 0.70710678f, EQ_LOW_DB);
+    EQ_SetBand(&eq_fx, 2, EQ_PEAK, EQ_MID_HZ, EQ_MID_Q, EQ_MID_DB);
+    EQ_SetBand(&eq_fx, 3, EQ_HIGH_SHELF, EQ_HIGH_HZ, 0.70710678f, EQ_HIGH_DB);
+#endif // EQ_ENABLE
+#ifdef COMP_ENABLE
+    Compressor_Init(&comp_fx, (float)SAMPLE_RATE, COMP_LOOKAHEAD_MS, COMP_DETECTOR);
+    Compressor_SetParams(&comp_fx, COMP_THRESHOLD_DB, COMP_RATIO, COMP_KNEE_DB, COMP_ATTACK_MS, COMP_RELEASE_MS, COMP_MAKEUP_DB);
+    SEGGER_SYSVIEW_PrintfHost("DSP: compressor look-ahead %u frames", Compressor_Latency(&comp_fx));
+#endif // COMP_ENABLE
+#ifdef LIMITER_ENABLE
+    Compressor_Init(&limiter_fx, (float)SAMPLE_RATE, LIMITER_LOOKAHEAD_MS, COMP_PEAK);
+    Compressor_SetParams(&limiter_fx, LIMITER_CEILING_DB, COMP_RATIO_INF, 0.0f, 0.0f, LIMITER_RELEASE_MS, 0.0f);
+    SEGGER_SYSVIEW_PrintfHost("DSP: limiter look-ahead %u frames", Compressor_Latency(&limiter_fx));
+#endif // LIMITER_ENABLE
+#ifdef MOD_MATRIX
+    Mod_Init(&mod_fx, (float)SAMPLE_RATE);
+    Mod_SetEnvelope(&mod_fx, 0, MOD_ENV_ATTACK_MS, MOD_ENV_RELEASE_MS, MOD_ENV_FLOOR_DB);
+#endif // MOD_MATRIX
+#ifdef MOD_ENABLE
+    Mod_SetLFO(&mod_fx, 0, MOD_SINE, MOD_TREMOLO_HZ, 0.0f);
+    Mod_SetLFO(&mod_fx, 1, MOD_SINE, MOD_PAN_HZ, 0.0f);
+    Mod_SetDest(&mod_fx, MOD_DEST_LEVEL, 1.0f - 0.5f * MOD_TREMOLO_DEPTH, 0.0f, 1.0f, MOD_SMOOTH_MS);
+    Mod_SetDest(&mod_fx, MOD_DEST_PAN, 0.0f, -1.0f, 1.0f, MOD_SMOOTH_MS);
+    Mod_Route(&mod_fx, MOD_SRC_LFO(0), MOD_DEST_LEVEL, 0.5f * MOD_TREMOLO_DEPTH);
+    Mod_Route(&mod_fx, MOD_SRC_LFO(1), MOD_DEST_PAN, MOD_PAN_DEPTH);
+#endif // MOD_ENABLE
+#ifdef PHASER_ENABLE
+    Phaser_Init(&phaser_fx, (float)SAMPLE_RATE, PHASER_STAGES, PHASER_MIN_HZ, PHASER_MAX_HZ, PHASER_FEEDBACK, 0.5f);
+    Mod_SetLFO(&mod_fx, 2, MOD_TRIANGLE, PHASER_RATE_HZ, 0.0f);
+    Mod_SetLFO(&mod_fx, 3, MOD_TRIANGLE, PHASER_RATE_HZ, PHASER_STEREO_PHASE);
+    Mod_SetDest(&mod_fx, MOD_DEST_PHASER_L, 0.5f, 0.0f, 1.0f, MOD_SMOOTH_MS);
+    Mod_SetDest(&mod_fx, MOD_DEST_PHASER_R, 0.5f, 0.0f, 1.0f, MOD_SMOOTH_MS);
+    Mod_Route(&mod_fx, MOD_SRC_LFO(2), MOD_DEST_PHASER_L, 0.5f);
+    Mod_Route(&mod_fx, MOD_SRC_LFO(3), MOD_DEST_PHASER_R, 0.5f);
+#endif // PHASER_ENABLE
+#ifdef AUTOWAH_ENABLE
+    AutoWah_Init(&wah_fx, (float)SAMPLE_RATE, AUTOWAH_MIN_HZ, AUTOWAH_MAX_HZ, AUTOWAH_Q, AUTOWAH_MIX);
+    Mod_SetDest(&mod_fx, MOD_DEST_WAH, 0.0f, 0.0f, 1.0f, MOD_SMOOTH_MS);
+    Mod_Route(&mod_fx, MOD_SRC_ENV(0), MOD_DEST_WAH, AUTOWAH_SENSITIVITY);
+#endif // AUTOWAH_ENABLE
+#ifdef HARMONIZER_ENABLE
+    Harmonizer_Init(&harm_fx, HARM_DRY);
+    Harmonizer_SetVoice(&harm_fx, 0, HARM_VOICE1_SEMITONES, HARM_VOICE1_LEVEL, HARM_VOICE1_PAN);
+    Harmonizer_SetVoice(&harm_fx, 1, HARM_VOICE2_SEMITONES, HARM_VOICE2_LEVEL, HARM_VOICE2_PAN);
+#endif // HARMONIZER_ENABLE
+#ifdef TRUEPEAK_ENABLE
+    TruePeak_Init(&truepeak_fx, (float)SAMPLE_RATE, TP_CEILING_DB, TP_RELEASE_MS, TP_LOOKAHEAD);
+    SEGGER_SYSVIEW_PrintfHost("DSP: true-peak output stage latency %u frames", TruePeak_Latency(&truepeak_fx));
+#endif // TRUEPEAK_ENABLE
+#ifdef CONVREV_ENABLE
+    ConvReverb_GenerateIR(CONVREV_IR, CONVREV_IR_TAPS, CONVREV_RT60, 0.5f);
+    ConvReverb_Init(&convrev_fx, convrevPool, CONVREV_MEM_SIZE(CONVREV_IR_TAPS), CONVREV_IR, CONVREV_IR_TAPS, CONVREV_MIX);
+#endif // CONVREV_ENABLE
+#ifdef LOOPER_ENABLE
+    Looper_Pool_t pool;
+    Looper_PoolFromMemory(&pool, looperPool, LOOPER_POOL_SAMPLES);
+    Looper_Init(&looper_fx, &pool, 1.0f);
+#endif // LOOPER_ENABLE
+#ifdef TUNER_ENABLE
+    Tuner_Init(&tuner_fx, TUNER_A4, TUNER_MIN_DB);
+#endif // TUNER_ENABLE
+#ifdef GATE_ENABLE
+    Gate_Init(&gate_fx, (float)SAMPLE_RATE, GATE_OPEN_DB, GATE_HYSTERESIS_DB, GATE_HOLD_MS, GATE_ATTACK_MS, GATE_RELEASE_MS);
+    Gate_SetTail(&gate_fx, (float)SAMPLE_RATE, GATE_SILENCE_DB, GATE_TAIL_MS);
+#endif // GATE_ENABLE
+#ifdef DSP_BENCH_ENABLE
+    bench_chain();
+#endif // DSP_BENCH_ENABLE
+}
+
+#ifdef LOOPER_ENABLE
+Looper_t* audio_getLooper(void)
+{
+    return &looper_fx;
+}
+#endif // LOOPER_ENABLE
+
+#ifdef EQ_ENABLE
+EQ_t* audio_getEQ(void)
+{
+    return &eq_fx;
 }
+#endif // EQ_ENABLE
 
 uint16_t* audio_getTxBuf(void)
 {
@@ -0,0 +1,22 @@
+#include "autowah.h"
+#include <string.h>
+#include <math.h>
+
+void AutoWah_Init(AutoWah_t* aw, float sample_rate, float min_hz, float max_hz, float q, float mix) {
+    memset(aw, 0, sizeof(AutoWah_t));
+    aw->sample_rate = sample_rate;
+    aw->minHz = min_hz;
+    aw->octaves = log2f(max_hz / min_hz);
+    aw->q = q;
+    aw->mix = mix;
+    float g = TPT_G(min_hz, sample_rate);
+    TPT_SVF_Set(&aw->left, g, q);
+    TPT_SVF_Set(&aw->right, g, q);
+}
+
+void AutoWah_ProcessBlock(AutoWah_t* aw, float* l, float* r, uint32_t n, float pos) {
+    float g = TPT_G(aw->minHz * Fast_Exp2(pos * aw->octaves), aw->sample_rate);
+    TPT_SVF_Set(&aw->left, g, aw->q);
+    TPT_SVF_Set(&aw->right, g, aw->q);
+    TPT_SVF_Bandpass(&aw->left, &aw->right, aw->mix, l, r, n);
+}
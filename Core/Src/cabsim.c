@@ -0,0 +1,241 @@
+#include "cabsim.h"
+#include "eq.h"
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Shared FFT scratch (audio runs single threaded): time domain frames and spectrum products
+static float cab_work[2 * CAB_MAX_PARTITION];
+
+// ---------- Spectrum helpers ----------
+
+// acc += x * h for arm_rfft_fast_f32 spectra, work receives the products
+static void spectrum_mac(float* acc, const float* x, const float* h, float* work, uint32_t N) {
+    // Bin 0 packs the (real) DC and Nyquist values
+    acc[0] += x[0] * h[0];
+    acc[1] += x[1] * h[1];
+    arm_cmplx_mult_cmplx_f32(&x[2], &h[2], work, N / 2 - 1);
+    arm_add_f32(&acc[2], work, &acc[2], N - 2);
+}
+
+// ---------- Impulse response ----------
+
+static uint8_t ir_setup(CabIR_t* ir, float* spectra, uint32_t partSize, uint32_t len) {
+    if (partSize < CAB_MIN_PARTITION || partSize > CAB_MAX_PARTITION ||
+        (partSize & (partSize - 1)) || (partSize % BLOCK_SIZE_FLOAT)) {
+        return 0;
+    }
+    if (arm_rfft_fast_init_f32(&ir->fft, (uint16_t)(2 * partSize)) != ARM_MATH_SUCCESS) {
+        return 0;
+    }
+    ir->spectra = spectra;
+    ir->partSize = partSize;
+    ir->partitions = CAB_PARTITIONS(len, partSize);
+    return 1;
+}
+
+// Transform partition m, its taps are in cab_work[0..P)
+static void ir_load_partition(CabIR_t* ir, uint32_t m) {
+    const uint32_t P = ir->partSize;
+    memset(&cab_work[P], 0, P * sizeof(float));
+    arm_rfft_fast_f32(&ir->fft, cab_work, &ir->spectra[m * 2 * P], 0);
+}
+
+uint8_t CabIR_Init(CabIR_t* ir, float* spectra, uint32_t partSize, const float* taps, uint32_t len, float gain) {
+    if (!ir_setup(ir, spectra, partSize, len)) return 0;
+
+    const uint32_t P = partSize;
+    for (uint32_t m = 0; m < ir->partitions; m++) {
+        uint32_t count = (len - m * P < P) ? len - m * P : P;
+        arm_scale_f32(&taps[m * P], gain, cab_work, count);
+        memset(&cab_work[count], 0, (P - count) * sizeof(float));
+        ir_load_partition(ir, m);
+    }
+    return 1;
+}
+
+#define CAB_DEFAULT_STAGES 6
+
+uint8_t CabIR_InitDefault(CabIR_t* ir, float* spectra, uint32_t partSize, uint32_t len) {
+    if (!ir_setup(ir, spectra, partSize, len)) return 0;
+
+    // Low resonance of the closed box, mid scoop, cone breakup presence and a steep top end roll off
+    float coeffs[5 * CAB_DEFAULT_STAGES];
+    float state[2 * CAB_DEFAULT_STAGES] = {0};
+    EQ_Design(&coeffs[0],  EQ_HIGH_PASS,   75.0f, 1.1f,  0.0f, SAMPLE_RATE);
+    EQ_Design(&coeffs[5],  EQ_PEAK,       120.0f, 1.4f,  3.0f, SAMPLE_RATE);
+    EQ_Design(&coeffs[10], EQ_PEAK,       450.0f, 0.9f, -5.0f, SAMPLE_RATE);
+    EQ_Design(&coeffs[15], EQ_PEAK,      2500.0f, 1.8f,  5.0f, SAMPLE_RATE);
+    EQ_Design(&coeffs[20], EQ_LOW_PASS,  4800.0f, 0.9f,  0.0f, SAMPLE_RATE);
+    EQ_Design(&coeffs[25], EQ_LOW_PASS,  6000.0f, 0.6f,  0.0f, SAMPLE_RATE);
+    arm_biquad_cascade_df2T_instance_f32 bq;
+    arm_biquad_cascade_df2T_init_f32(&bq, CAB_DEFAULT_STAGES, coeffs, state);
+
+    // Impulse through the cascade partition by partition, half cosine fade over the last quarter
+    const uint32_t P = partSize;
+    const uint32_t fade = len / 4;
+    for (uint32_t m = 0; m < ir->partitions; m++) {
+        memset(cab_work, 0, P * sizeof(float));
+        if (m == 0) cab_work[0] = 1.0f;
+        arm_biquad_cascade_df2T_f32(&bq, cab_work, cab_work, P);
+        for (uint32_t i = 0; i < P; i++) {
+            uint32_t k = m * P + i;
+            if (k >= len) {
+                cab_work[i] = 0.0f;
+            } else if (k >= len - fade) {
+                cab_work[i] *= 0.5f + 0.5f * cosf((float)M_PI * (float)(k - (len - fade)) / (float)fade);
+            }
+        }
+        ir_load_partition(ir, m);
+    }
+
+    // Peak magnitude on the 2P point grid: partition m is delayed by m*P, i.e. (-1)^(k*m) at bin k
+    const uint32_t N = 2 * P;
+    float peak = 0.0f;
+    for (uint32_t k = 0; k < N / 2; k++) {
+        float re = 0.0f, im = 0.0f;
+        for (uint32_t m = 0; m < ir->partitions; m++) {
+            const float* h = &ir->spectra[m * N];
+            float s = ((k * m) & 1) ? -1.0f : 1.0f;
+            re += s * ((k == 0) ? h[0] : h[2 * k]);
+            im += s * ((k == 0) ? 0.0f : h[2 * k + 1]);
+        }
+        float mag = sqrtf(re * re + im * im);
+        if (mag > peak) peak = mag;
+    }
+    if (peak > 0.0f) {
+        arm_scale_f32(ir->spectra, 1.0f / peak, ir->spectra, ir->partitions * N);
+    }
+    return 1;
+}
+
+// ---------- Convolver ----------
+
+void CabSim_Init(CabSim_t* cab, const CabIR_t* ir, float* mem) {
+    const uint32_t P = ir->partSize;
+    cab->ir = ir;
+    cab->fdl = mem;
+    cab->frame = mem + ir->partitions * 2 * P;
+    cab->acc = cab->frame + 2 * P;
+    cab->out = cab->acc + 2 * P;
+    cab->background = 0;
+    CabSim_Reset(cab);
+}
+
+void CabSim_InitBackground(CabSim_t* cab, const CabIR_t* ir, float* mem) {
+    const uint32_t P = ir->partSize;
+    CabSim_Init(cab, ir, mem);
+    cab->next = cab->out + P;
+    cab->job = cab->next + P;
+    cab->background = 1;
+    CabSim_Reset(cab);
+}
+
+void CabSim_Reset(CabSim_t* cab) {
+    const uint32_t P = cab->ir->partSize;
+    uint32_t size = cab->background ? CAB_BACKGROUND_SIZE(0, P) : CAB_CHANNEL_SIZE(0, P);
+    memset(cab->fdl, 0, (cab->ir->partitions * 2 * P + size) * sizeof(float));
+    cab->head = 0;
+    cab->fill = 0;
+    cab->nextPart = 1;
+    cab->jobStep = 0;
+    cab->overruns = 0;
+}
+
+// Background: the previous result becomes audible and the completed frame is queued
+static void background_frame(CabSim_t* cab) {
+    const uint32_t P = cab->ir->partSize;
+    if (cab->jobStep != 0) {
+        // Idle time ran out, finish the frame here rather than play stale output
+        while (CabSim_BackgroundStep(cab)) {}
+        cab->overruns++;
+    }
+    float* tmp = cab->out;
+    cab->out = cab->next;
+    cab->next = tmp;
+
+    memcpy(cab->job, cab->frame, 2 * P * sizeof(float));
+    memcpy(cab->frame, &cab->frame[P], P * sizeof(float));
+    cab->fill = 0;
+    cab->jobStep = 1;
+}
+
+uint8_t CabSim_BackgroundStep(CabSim_t* cab) {
+    if (cab->jobStep == 0) return 0;
+
+    const CabIR_t* ir = cab->ir;
+    const uint32_t P = ir->partSize;
+    const uint32_t N = 2 * P;
+    const uint32_t M = ir->partitions;
+
+    if (cab->jobStep == 1) {
+        // Item 1: spectrum of the queued frame, it replaces the oldest FDL entry
+        cab->head = (cab->head == 0) ? M - 1 : cab->head - 1;
+        arm_rfft_fast_f32(&ir->fft, cab->job, &cab->fdl[cab->head * N], 0);
+        memset(cab->acc, 0, N * sizeof(float));
+    } else if (cab->jobStep <= M + 1) {
+        // Items 2..M+1: one partition each, X[j-m] is m slots after the head
+        uint32_t m = cab->jobStep - 2;
+        uint32_t slot = cab->head + m;
+        if (slot >= M) slot -= M;
+        spectrum_mac(cab->acc, &cab->fdl[slot * N], &ir->spectra[m * N], cab->job, N);
+    } else {
+        // Last item: back to the time domain, the valid half is the next output frame
+        arm_rfft_fast_f32(&ir->fft, cab->acc, cab->job, 1);
+        memcpy(cab->next, &cab->job[P], P * sizeof(float));
+        cab->jobStep = 0;
+        return 1;
+    }
+    cab->jobStep++;
+    return 1;
+}
+
+void CabSim_ProcessBlock(CabSim_t* cab, const float* in, float* out, uint32_t n) {
+    const CabIR_t* ir = cab->ir;
+    const uint32_t P = ir->partSize;
+    const uint32_t N = 2 * P;
+    const uint32_t M = ir->partitions;
+
+    memcpy(&cab->frame[P + cab->fill], in, n * sizeof(float));
+    cab->fill += n;
+
+    if (cab->background) {
+        if (cab->fill == P) {
+            background_frame(cab);
+        }
+        memcpy(out, &cab->out[cab->fill], n * sizeof(float));
+        return;
+    }
+
+    // Older frames: partitions 1..M-1 spread evenly over the blocks of this frame.
+    // X[j-m] sits m-1 slots after the head until the new frame is stored.
+    uint32_t target = 1 + ((M - 1) * cab->fill) / P;
+    for (; cab->nextPart < target; cab->nextPart++) {
+        uint32_t slot = cab->head + cab->nextPart - 1;
+        if (slot >= M) slot -= M;
+        spectrum_mac(cab->acc, &cab->fdl[slot * N], &ir->spectra[cab->nextPart * N], cab_work, N);
+    }
+
+    if (cab->fill == P) {
+        // New frame spectrum replaces the oldest FDL entry
+        cab->head = (cab->head == 0) ? M - 1 : cab->head - 1;
+        float* X = &cab->fdl[cab->head * N];
+        memcpy(cab_work, cab->frame, N * sizeof(float));
+        arm_rfft_fast_f32(&ir->fft, cab_work, X, 0);
+        spectrum_mac(cab->acc, X, ir->spectra, cab_work, N);
+
+        // Overlap-save: the second half of the circular convolution is valid
+        arm_rfft_fast_f32(&ir->fft, cab->acc, cab_work, 1);
+        memcpy(cab->out, &cab_work[P], P * sizeof(float));
+
+        memcpy(cab->frame, &cab->frame[P], P * sizeof(float));
+        memset(cab->acc, 0, N * sizeof(float));
+        cab->fill = 0;
+        cab->nextPart = 1;
+    }
+
+    memcpy(out, &cab->out[cab->fill], n * sizeof(float));
+}
@@ -0,0 +1,132 @@
+#include "compressor.h"
+#include "fast_math.h"
+#include "arm_math.h"
+#include <string.h>
+#include <math.h>
+
+#define COMP_FLOOR 1e-30f // keeps silence out of the denormals ahead of Fast_Log2
+
+// One-pole coefficient for a time constant of 'ms' at 'rate' updates per second, 0 ms: instant
+static float time_coeff(float ms, float rate) {
+    if (ms <= 0.0f) return 1.0f;
+    return 1.0f - expf(-1000.0f / (ms * rate));
+}
+
+void Compressor_Init(Compressor_t* c, float sample_rate, float lookahead_ms, Comp_Detector_t detector) {
+    memset(c, 0, sizeof(Compressor_t));
+    c->sample_rate = sample_rate;
+    c->detector = detector;
+    uint32_t L = (uint32_t)(lookahead_ms * 0.001f * sample_rate + 0.5f);
+    if (L > COMP_MAX_LOOKAHEAD) L = COMP_MAX_LOOKAHEAD;
+    c->lookahead = L;
+    Compressor_SetParams(c, 0.0f, 1.0f, 0.0f, 0.0f, 100.0f, 0.0f);
+}
+
+void Compressor_SetParams(Compressor_t* c, float threshold_dB, float ratio, float knee_dB,
+                          float attack_ms, float release_ms, float makeup_dB) {
+    if (knee_dB < 0.0f) knee_dB = 0.0f;
+    c->threshold = threshold_dB / FAST_DB_PER_LOG2;
+    c->knee = knee_dB / FAST_DB_PER_LOG2;
+    if (ratio == COMP_RATIO_INF) {
+        c->slope = 1.0f;
+    } else {
+        c->slope = ratio > 1.0f ? 1.0f - 1.0f / ratio : 0.0f;
+    }
+    c->makeup = makeup_dB / FAST_DB_PER_LOG2;
+    c->attackCoeff = time_coeff(attack_ms, c->sample_rate);
+    c->releaseCoeff = time_coeff(release_ms, c->sample_rate);
+    c->rmsCoeff = time_coeff(COMP_RMS_MS, c->sample_rate / BLOCK_SIZE_FLOAT);
+}
+
+uint32_t Compressor_Latency(const Compressor_t* c) {
+    return c->lookahead;
+}
+
+float Compressor_Reduction_dB(const Compressor_t* c) {
+    return -c->env * FAST_DB_PER_LOG2;
+}
+
+// Soft knee over threshold +- knee/2, log2 units in and out
+static inline float gain_computer(const Compressor_t* c, float x) {
+    float over = x - c->threshold;
+    float w = c->knee;
+    if (2.0f * over <= -w) return 0.0f;
+    if (2.0f * over >= w) return -c->slope * over;
+    float k = over + 0.5f * w;
+    return -c->slope * k * k / (2.0f * w);
+}
+
+/*Minimum of the last L + 1 reductions. The deque holds increasing values with increasing
+indices, the front is the minimum; every value enters and leaves once.*/
+static inline float hold_min(Compressor_t* c, float t) {
+    const uint32_t size = c->lookahead + 2;
+    const uint32_t now = c->count++;
+
+    if (c->head != c->tail && now - c->minIdx[c->head] > c->lookahead) {
+        if (++c->head == size) c->head = 0;
+    }
+    while (c->tail != c->head) {
+        uint32_t back = (c->tail == 0 ? size : c->tail) - 1;
+        if (c->minVal[back] < t) break;
+        c->tail = back;
+    }
+    c->minVal[c->tail] = t;
+    c->minIdx[c->tail] = now;
+    if (++c->tail == size) c->tail = 0;
+    return c->minVal[c->head];
+}
+
+void Compressor_ProcessBlock(Compressor_t* c, float* l, float* r, uint32_t n) {
+    float* lev = c->level;
+    const uint32_t L = c->lookahead;
+
+    // Detector over the block, log2 level per sample
+    if (c->detector == COMP_RMS) {
+        float pl, pr;
+        arm_power_f32(l, n, &pl);
+        arm_power_f32(r, n, &pr);
+        c->ms += c->rmsCoeff * ((pl + pr) / (float)(2 * n) - c->ms);
+        arm_fill_f32(0.5f * Fast_Log2(c->ms + COMP_FLOOR), lev, n);
+    } else {
+        float* tmp = c->scratch;
+        arm_abs_f32(l, lev, n);
+        arm_abs_f32(r, tmp, n);
+        for (uint32_t i = 0; i < n; i++) {
+            float a = lev[i] > tmp[i] ? lev[i] : tmp[i];
+            lev[i] = Fast_Log2(a + COMP_FLOOR);
+        }
+    }
+
+    // Reduction per sample; the running sum is rebuilt each block so it cannot drift
+    float sum = 0.0f;
+    const float invL = L > 0 ? 1.0f / (float)L : 0.0f;
+    if (L > 0) {
+        arm_mean_f32(c->avg, L, &sum);
+        sum *= (float)L;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        float t = gain_computer(c, lev[i]);
+        if (L > 0) t = hold_min(c, t);
+        c->env += (t < c->env ? c->attackCoeff : c->releaseCoeff) * (t - c->env);
+        float g = c->env;
+        if (L > 0) {
+            uint32_t p = c->pos;
+            sum += g - c->avg[p];
+            c->avg[p] = g;
+            g = sum * invL;
+
+            float dl = c->delayL[p];
+            float dr = c->delayR[p];
+            c->delayL[p] = l[i];
+            c->delayR[p] = r[i];
+            l[i] = dl;
+            r[i] = dr;
+            if (++p == L) p = 0;
+            c->pos = p;
+        }
+        lev[i] = Fast_Exp2(g + c->makeup);
+    }
+
+    arm_mult_f32(l, lev, l, n);
+    arm_mult_f32(r, lev, r, n);
+}
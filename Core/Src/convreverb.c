@@ -0,0 +1,97 @@
+#include "convreverb.h"
+#include <string.h>
+#include <math.h>
+
+static const uint32_t level_part[CONVREV_LEVELS] = {BLOCK_SIZE_FLOAT, CONVREV_P1, CONVREV_P2};
+
+// IR offset where a level starts: its own latency, 0 for the audio path level
+static uint32_t level_start(uint32_t k) {
+    return (k == 0) ? 0 : 2 * level_part[k] - BLOCK_SIZE_FLOAT;
+}
+
+void ConvReverb_GenerateIR(float* taps, uint32_t len, float rt60_s, float damping) {
+    uint32_t seed = 4242;
+    float lp = 0.0f;
+    float env = 1.0f;
+    // -60 dB after rt60_s
+    const float decay = expf(-6.9078f / (rt60_s * SAMPLE_RATE));
+    float energy = 0.0f;
+
+    for (uint32_t i = 0; i < len; i++) {
+        seed = seed * 196314165u + 907633515u;
+        float noise = (float)(int32_t)seed * (1.0f / 2147483648.0f);
+        // One pole lowpass closing as the tail decays (high frequencies die first)
+        float a = 1.0f - damping * (1.0f - env) * 0.95f;
+        lp += a * (noise - lp);
+        taps[i] = lp * env;
+        energy += taps[i] * taps[i];
+        env *= decay;
+    }
+    if (energy > 0.0f) {
+        arm_scale_f32(taps, sqrtf(0.5f / energy), taps, len);
+    }
+}
+
+uint8_t ConvReverb_Init(ConvReverb_t* cr, float* mem, uint32_t memSize, const float* taps, uint32_t len, float mix) {
+    float* end = mem + memSize;
+    cr->levels = 0;
+    cr->mix = mix;
+
+    for (uint32_t k = 0; k < CONVREV_LEVELS && level_start(k) < len; k++) {
+        uint32_t start = level_start(k);
+        uint32_t stop = (k + 1 < CONVREV_LEVELS && level_start(k + 1) < len) ? level_start(k + 1) : len;
+        uint32_t seg = stop - start;
+        uint32_t P = level_part[k];
+        uint32_t size = (k == 0) ? CAB_CHANNEL_SIZE(seg, P) : CAB_BACKGROUND_SIZE(seg, P);
+
+        if (mem + CAB_IR_SIZE(seg, P) + size > end) return 0;
+        if (!CabIR_Init(&cr->ir[k], mem, P, &taps[start], seg, 1.0f)) return 0;
+        mem += CAB_IR_SIZE(seg, P);
+        if (k == 0) {
+            CabSim_Init(&cr->level[k], &cr->ir[k], mem);
+        } else {
+            CabSim_InitBackground(&cr->level[k], &cr->ir[k], mem);
+        }
+        mem += size;
+        cr->levels++;
+    }
+    return 1;
+}
+
+void ConvReverb_SetMix(ConvReverb_t* cr, float mix) {
+    cr->mix = mix;
+}
+
+void ConvReverb_ProcessBlock(ConvReverb_t* cr, float* l, float* r, uint32_t n) {
+    arm_add_f32(l, r, cr->mono, n);
+    arm_scale_f32(cr->mono, 0.5f, cr->mono, n);
+
+    // Every level is already aligned to its IR offset, the outputs just add up
+    memset(cr->wet, 0, n * sizeof(float));
+    for (uint32_t k = 0; k < cr->levels; k++) {
+        CabSim_ProcessBlock(&cr->level[k], cr->mono, cr->tmp, n);
+        arm_add_f32(cr->wet, cr->tmp, cr->wet, n);
+    }
+
+    arm_scale_f32(cr->wet, cr->mix, cr->wet, n);
+    arm_scale_f32(l, 1.0f - cr->mix, l, n);
+    arm_scale_f32(r, 1.0f - cr->mix, r, n);
+    arm_add_f32(l, cr->wet, l, n);
+    arm_add_f32(r, cr->wet, r, n);
+}
+
+uint8_t ConvReverb_Background(ConvReverb_t* cr) {
+    // Smaller partitions have the shorter deadline
+    for (uint32_t k = 1; k < cr->levels; k++) {
+        if (CabSim_BackgroundStep(&cr->level[k])) return 1;
+    }
+    return 0;
+}
+
+uint32_t ConvReverb_Overruns(const ConvReverb_t* cr) {
+    uint32_t overruns = 0;
+    for (uint32_t k = 1; k < cr->levels; k++) {
+        overruns += cr->level[k].overruns;
+    }
+    return overruns;
+}
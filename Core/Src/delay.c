@@ -1,12 +1,96 @@
 #include "delay.h"
+#include <math.h>
+
+// ---------- Tape feedback section ----------
+
+static void tape_clamp_depth(FX_Delay_t* dly) {
+    // Modulated read must stay at least 2 frames inside the active line, stereo or mono
+    float maxDepth = (float)(dly->delayLength / 2) - 2.0f;
+    FX_DelayTape_t* t = &dly->tape;
+    if (maxDepth < 0.0f) maxDepth = 0.0f;
+    if (t->wowDepth + t->flutterDepth > maxDepth) {
+        float scale = maxDepth / (t->wowDepth + t->flutterDepth);
+        t->wowDepth *= scale;
+        t->flutterDepth *= scale;
+    }
+}
+
+// Parabolic sine approximation, Q32 phase -> [-1, 1]
+static inline float tape_lfo(uint32_t phase) {
+    float p = (float)(int32_t)phase * (1.0f / 2147483648.0f);
+    float y = 4.0f * p * (1.0f - fabsf(p));
+    return y + 0.225f * (y * fabsf(y) - y);
+}
+
+// Cubic soft clipper, knee at |x| = 1
+static inline float tape_saturate(float x) {
+    if (x > 1.0f) return 2.0f / 3.0f;
+    if (x < -1.0f) return -2.0f / 3.0f;
+    return x - (x * x * x) * (1.0f / 3.0f);
+}
+
+// Head offset for this frame: moves the head towards newer samples (shorter delay)
+static inline float tape_mod(FX_DelayTape_t* t) {
+    float mod = t->wowDepth * 0.5f * (1.0f + tape_lfo(t->wowPhase))
+              + t->flutterDepth * 0.5f * (1.0f + tape_lfo(t->flutterPhase));
+    t->wowPhase += t->wowInc;
+    t->flutterPhase += t->flutterInc;
+    return mod;
+}
+
+// Delay_ReadFrac on one channel of the interleaved line, offs in frames
+static inline float read_frame(const float* line, uint32_t len, uint32_t pos, float offs) {
+    uint32_t o = (uint32_t)offs;
+    float frac = offs - (float)o;
+    uint32_t i0 = pos + 2 * o;
+    if (i0 >= len) i0 -= len;
+    uint32_t i1 = i0 + 2;
+    if (i1 >= len) i1 -= len;
+    return line[i0] + frac * (line[i1] - line[i0]);
+}
+
+static inline float tape_feedback(FX_DelayTape_t* t, uint32_t ch, float x) {
+    x = OnePoleHPF_Process(&t->hpf[ch], x);
+    x = OnePoleLPF_Process(&t->lpf[ch], x);
+    return tape_saturate(x * t->drive) * t->driveInv;
+}
+
+// Writes the line input at index i, returns the clamped dry/wet mix
+static inline float delay_mix(FX_Delay_t* dly, uint32_t i, float in, float delayed, float feedback) {
+    dly->line[i] = in + feedback;
+
+    float out = in * (1.0f - dly->mix) + (delayed * dly->mix);
+    if (out < -1.0f) {
+        out = -1.0f; // Clamp output to -1.0
+    } else if (out > 1.0f) {
+        out = 1.0f; // Clamp output to 1.0
+    }
+    return out;
+}
+
+// ---------- Delay ----------
 
 void FX_Delay_Init(FX_Delay_t* dly, uint32_t delayTime_ms, float mix, float feedback) {
+    dly->tape.enabled = 0;
+    for (uint32_t ch = 0; ch < 2; ch++) {
+        OnePoleHPF_Init(&dly->tape.hpf[ch]);
+        OnePoleLPF_Init(&dly->tape.lpf[ch]);
+    }
+    dly->tape.drive = 1.0f;
+    dly->tape.driveInv = 1.0f;
+    dly->tape.wowDepth = 0.0f;
+    dly->tape.flutterDepth = 0.0f;
+    dly->tape.wowPhase = 0;
+    dly->tape.flutterPhase = 0;
+    dly->tape.wowInc = (uint32_t)(DELAY_TAPE_WOW_HZ * (4294967296.0f / SAMPLE_RATE));
+    dly->tape.flutterInc = (uint32_t)(DELAY_TAPE_FLUTTER_HZ * (4294967296.0f / SAMPLE_RATE));
+
+    dly->lineIndex = 0;
     FX_Delay_SetLength(dly, delayTime_ms);
 
     dly->mix = mix;
     dly->feedback = feedback;
 
-    dly->lineIndex = 0;
     for (uint32_t i = 0; i < DELAY_MAX_LENGTH; i++) {
         dly->line[i] = 0.0f; // Initialize delay line
     }
@@ -22,20 +106,50 @@ void FX_Delay_SetLength(FX_Delay_t* dly, uint32_t delayTime_ms) {
     if (dly->delayLength > DELAY_MAX_LENGTH) {
         dly->delayLength = DELAY_MAX_LENGTH; // Ensure it does not exceed max length
     }
+    dly->delayLength &= ~1u; // whole stereo frames
+    if (dly->lineIndex >= dly->delayLength) {
+        dly->lineIndex = 0;
+    }
+    tape_clamp_depth(dly);
+}
+
+void FX_Delay_SetTape(FX_Delay_t* dly, float lpf_hz, float hpf_hz, float drive, float wow_ms, float flutter_ms) {
+    FX_DelayTape_t* t = &dly->tape;
+    for (uint32_t ch = 0; ch < 2; ch++) {
+        OnePoleLPF_Set(&t->lpf[ch], (float)SAMPLE_RATE, lpf_hz);
+        OnePoleHPF_Set(&t->hpf[ch], (float)SAMPLE_RATE, hpf_hz);
+    }
+
+    if (drive < 1.0f) {
+        drive = 1.0f;
+    }
+    t->drive = drive;
+    t->driveInv = 1.0f / drive;
+
+    t->wowDepth = wow_ms * 0.001f * SAMPLE_RATE;
+    t->flutterDepth = flutter_ms * 0.001f * SAMPLE_RATE;
+    tape_clamp_depth(dly);
+}
+
+void FX_Delay_EnableTape(FX_Delay_t* dly, uint8_t enable) {
+    dly->tape.enabled = enable;
 }
 
 float FX_Do_Delay(FX_Delay_t* dly, float inSample) {
     // Read the delayed sample
-    float delayLineOutput = dly->line[dly->lineIndex];
-
-    // Compute current delay line input
-    float delayLineInput = inSample + dly->feedback * delayLineOutput;
+    float delayLineOutput;
+    float feedback;
 
-    // Write the new sample into the delay line circular buffer
-    dly->line[dly->lineIndex] = delayLineInput;
+    if (dly->tape.enabled) {
+        float mod = tape_mod(&dly->tape);
+        delayLineOutput = Delay_ReadFrac(dly->line, dly->delayLength, dly->lineIndex, mod);
+        feedback = tape_feedback(&dly->tape, 0, dly->feedback * delayLineOutput);
+    } else {
+        delayLineOutput = dly->line[dly->lineIndex];
+        feedback = dly->feedback * delayLineOutput;
+    }
 
-    // Update the output sample
-    dly->out = inSample * (1.0f - dly->mix) + (delayLineOutput * dly->mix);
+    dly->out = delay_mix(dly, dly->lineIndex, inSample, delayLineOutput, feedback);
 
     // Increment the index and wrap around if necessary
     dly->lineIndex++;
@@ -43,11 +157,32 @@ float FX_Do_Delay(FX_Delay_t* dly, float inSample) {
         dly->lineIndex = 0;
     }
 
-    if (dly->out < -1.0f) {
-        dly->out = -1.0f; // Clamp output to -1.0
-    } else if (dly->out > 1.0f) {
-        dly->out = 1.0f; // Clamp output to 1.0
+    return dly->out;
+}
+
+void FX_Do_DelayStereo(FX_Delay_t* dly, float* l, float* r) {
+    uint32_t il = dly->lineIndex, ir = il + 1;
+    float dl, dr, fl, fr;
+
+    if (dly->tape.enabled) {
+        // One head position per frame for both channels
+        float mod = tape_mod(&dly->tape);
+        dl = read_frame(dly->line, dly->delayLength, il, mod);
+        dr = read_frame(dly->line, dly->delayLength, ir, mod);
+        fl = tape_feedback(&dly->tape, 0, dly->feedback * dl);
+        fr = tape_feedback(&dly->tape, 1, dly->feedback * dr);
+    } else {
+        dl = dly->line[il];
+        dr = dly->line[ir];
+        fl = dly->feedback * dl;
+        fr = dly->feedback * dr;
     }
 
-    return dly->out;
-}
\ No newline at end of file
+    *l = delay_mix(dly, il, *l, dl, fl);
+    *r = dly->out = delay_mix(dly, ir, *r, dr, fr);
+
+    dly->lineIndex += 2;
+    if (dly->lineIndex >= dly->delayLength) {
+        dly->lineIndex = 0;
+    }
+}
@@ -1,4 +1,5 @@
 #include "distortion.h"
+#include "dsp_configuration.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -9,9 +10,9 @@
 
 // ---------- Simple 1-pole LPF ----------
 
-static void lpf_init(OnePoleLPF *f){ f->a0=1.0f; f->b1=0.0f; f->z1=0.0f; }
+void OnePoleLPF_Init(OnePoleLPF *f){ f->a0=1.0f; f->b1=0.0f; f->z1=0.0f; }
 
-static void lpf_set(OnePoleLPF *f, float sample_rate, float cutoff_hz){
+void OnePoleLPF_Set(OnePoleLPF *f, float sample_rate, float cutoff_hz){
     if (cutoff_hz <= 0.0f || cutoff_hz >= sample_rate*0.45f){
         f->a0 = 1.0f; f->b1 = 0.0f; return; // bypass
     }
@@ -20,17 +21,11 @@ static void lpf_set(OnePoleLPF *f, float sample_rate, float cutoff_hz){
     f->b1 = x;
 }
 
-static inline float lpf_process(OnePoleLPF *f, float x){
-    f->z1 = f->a0*x + f->b1*f->z1;
-    return f->z1;
-}
-
 // ---------- Simple 1-pole HPF ----------
 
+void OnePoleHPF_Init(OnePoleHPF *f){ f->a0=1.0f; f->b1=0.0f; f->z1=0.0f; }
 
-static void hpf_init(OnePoleHPF *f){ f->a0=1.0f; f->b1=0.0f; f->z1=0.0f; }
-
-static void hpf_set(OnePoleHPF *f, float sample_rate, float cutoff_hz){
+void OnePoleHPF_Set(OnePoleHPF *f, float sample_rate, float cutoff_hz){
     if (cutoff_hz <= 0.0f || cutoff_hz >= sample_rate*0.45f){
         f->a0 = 1.0f; f->b1 = 0.0f; return; // bypass
     }
@@ -39,13 +34,15 @@ static void hpf_set(OnePoleHPF *f, float sample_rate, float cutoff_hz){
     f->b1 = x;
 }
 
-static inline float hpf_process(OnePoleHPF *f, float x){
-    float y = f->a0 * (x - f->z1) + f->b1 * f->z1;
-    f->z1 = x;
-    return y;
-}
-
 // ---------- DS1 Effect ----------
+
+// Oversampled clipper work buffer, shared by all instances
+static float os_buf[BLOCK_SIZE_FLOAT * DS1_MAX_OVERSAMPLE];
+
+// Half-band stage designs, first stage sits next to the base rate and is the steepest
+static const uint32_t os_stage_K[3] = {12, 6, 4};
+static const float os_stage_beta[3] = {7.0f, 6.0f, 5.0f};
+
 void DS1_Init(DS1 *fx, float sample_rate){
     memset(fx, 0, sizeof(*fx));
     fx->sample_rate = sample_rate;
@@ -53,19 +50,42 @@ void DS1_Init(DS1 *fx, float sample_rate){
     fx->output = 1.0f;
     fx->type = CLIP_HARD;
 
-    lpf_init(&fx->tone);
-    lpf_set(&fx->tone, sample_rate, 6000.0f); // DS-1 tone LPF ~6 kHz
+    OnePoleLPF_Init(&fx->tone);
+    OnePoleLPF_Set(&fx->tone, sample_rate, 6000.0f); // DS-1 tone LPF ~6 kHz
+
+    OnePoleHPF_Init(&fx->hpf);
+    OnePoleHPF_Set(&fx->hpf, sample_rate, 720.0f);   // DS-1 input HPF ~720 Hz
+
+    DS1_SetOversampling(fx, 1);
+    Waveshaper_Init(&fx->shaper, WS_CURVE_TANH, WS_INTERP_CUBIC);
+}
+
+void DS1_SetShaper(DS1 *fx, WS_Curve_t curve, WS_Interp_t interp){
+    Waveshaper_Init(&fx->shaper, curve, interp);
+}
+
+void DS1_SetOversampling(DS1 *fx, uint32_t factor){
+    uint32_t stages = 0;
+    while ((1u << stages) < factor && stages < 3) stages++;
 
-    hpf_init(&fx->hpf);
-    hpf_set(&fx->hpf, sample_rate, 720.0f);   // DS-1 input HPF ~720 Hz
+    for (uint32_t s = 0; s < stages; s++){
+        HalfBand_Init(&fx->up[s], os_stage_K[s], os_stage_beta[s]);
+        HalfBand_Init(&fx->down[s], os_stage_K[s], os_stage_beta[s]);
+    }
+    fx->os_stages = stages;
 }
 
 void DS1_SetParams(DS1 *fx, float drive, float output, float tone_hz, float hpf_hz, ClipType type){
     fx->drive = drive;
     fx->output = output;
+    if (type != fx->type){
+        // ADAA history holds F1 or F2 depending on the order, start clean
+        fx->adaa_x1 = fx->adaa_x2 = 0.0f;
+        fx->adaa_Fx1 = fx->adaa_D = 0.0f;
+    }
     fx->type = type;
-    lpf_set(&fx->tone, fx->sample_rate, tone_hz);
-    hpf_set(&fx->hpf, fx->sample_rate, hpf_hz);
+    OnePoleLPF_Set(&fx->tone, fx->sample_rate, tone_hz);
+    OnePoleHPF_Set(&fx->hpf, fx->sample_rate, hpf_hz);
 }
 
 static inline float clip_sample(float x, ClipType type){
@@ -75,7 +95,7 @@ static inline float clip_sample(float x, ClipType type){
             if (x < -0.3f) x = -0.3f;
             return x;
         case CLIP_TANH:
-            return tanhf(x);
+            return WS_LookupCubic(&ws_tables[WS_CURVE_TANH], x);
         case CLIP_ASYM:
             if (x > 0.3f) x = 0.3f;
             if (x < -0.2f) x = -0.2f;
@@ -85,19 +105,175 @@ static inline float clip_sample(float x, ClipType type){
     }
 }
 
+// ---------- Antiderivative anti-aliasing ----------
+
+#define ADAA_EPS 1e-3f // below this input difference the divided differences are ill-conditioned
+#define LN2 0.69314718f
+#define PI2_24 0.41123352f // pi^2 / 24
+
+// Clamp to [lo, hi]: first and second antiderivatives
+static inline float clamp_F1(float x, float lo, float hi){
+    if (x > hi) return hi*x - 0.5f*hi*hi;
+    if (x < lo) return lo*x - 0.5f*lo*lo;
+    return 0.5f*x*x;
+}
+
+static inline float clamp_F2(float x, float lo, float hi){
+    if (x > hi) return 0.5f*hi*x*x - 0.5f*hi*hi*x + hi*hi*hi*(1.0f/6.0f);
+    if (x < lo) return 0.5f*lo*x*x - 0.5f*lo*lo*x + lo*lo*lo*(1.0f/6.0f);
+    return x*x*x*(1.0f/6.0f);
+}
+
+// tanh: F1 = log(cosh(x)) = |x| + log(1 + e^-2|x|) - ln2
+static inline float tanh_F1(float x){
+    float a = fabsf(x);
+    return a + log1pf(expf(-2.0f*a)) - LN2;
+}
+
+/* F2 = sign(x) * (x^2/2 - |x| ln2 + pi^2/24 + Li2(-e^-2|x|)/2). Li2(-u) uses the
+   Bernoulli series in t = -log(1+u), |t| <= ln2, truncated after t^7. */
+static inline float tanh_F2(float x){
+    float a = fabsf(x);
+    float t = -log1pf(expf(-2.0f*a));
+    float t2 = t*t;
+    float li2 = t*(1.0f + t*(-0.25f + t*(1.0f/36.0f + t2*(-1.0f/3600.0f + t2*(1.0f/211680.0f)))));
+    float F = 0.5f*a*a - a*LN2 + PI2_24 + 0.5f*li2;
+    return (x < 0.0f) ? -F : F;
+}
+
+static inline ClipType adaa_curve(ClipType type){
+    switch(type){
+        case CLIP_HARD_ADAA1: case CLIP_HARD_ADAA2: return CLIP_HARD;
+        case CLIP_TANH_ADAA1: case CLIP_TANH_ADAA2: return CLIP_TANH;
+        case CLIP_ASYM_ADAA1: case CLIP_ASYM_ADAA2: return CLIP_ASYM;
+        default: return type;
+    }
+}
+
+static inline float curve_F1(ClipType c, float x){
+    switch(c){
+        case CLIP_TANH: return tanh_F1(x);
+        case CLIP_ASYM: return clamp_F1(x, -0.2f, 0.3f);
+        default:        return clamp_F1(x, -0.3f, 0.3f);
+    }
+}
+
+static inline float curve_F2(ClipType c, float x){
+    switch(c){
+        case CLIP_TANH: return tanh_F2(x);
+        case CLIP_ASYM: return clamp_F2(x, -0.2f, 0.3f);
+        default:        return clamp_F2(x, -0.3f, 0.3f);
+    }
+}
+
+static inline float clip_adaa1(DS1 *fx, ClipType c, float x){
+    float F = curve_F1(c, x);
+    float dx = x - fx->adaa_x1;
+    float y = (fabsf(dx) > ADAA_EPS) ? (F - fx->adaa_Fx1) / dx
+                                     : clip_sample(0.5f*(x + fx->adaa_x1), c);
+    fx->adaa_x1 = x;
+    fx->adaa_Fx1 = F;
+    return y;
+}
+
+static inline float clip_adaa2(DS1 *fx, ClipType c, float x){
+    float x1 = fx->adaa_x1, x2 = fx->adaa_x2;
+    float F = curve_F2(c, x);
+
+    // First divided difference of F2, falls back to F1 at the midpoint
+    float d0 = x - x1;
+    float D = (fabsf(d0) > ADAA_EPS) ? (F - fx->adaa_Fx1) / d0 : curve_F1(c, 0.5f*(x + x1));
+
+    float y;
+    float d2 = x - x2;
+    if (fabsf(d2) > ADAA_EPS){
+        y = 2.0f * (D - fx->adaa_D) / d2;
+    } else {
+        // x[n] ~ x[n-2]: expand around their mean
+        float xb = 0.5f*(x + x2);
+        float delta = xb - x1;
+        if (fabsf(delta) > ADAA_EPS){
+            y = (2.0f / delta) * (curve_F1(c, xb) + (fx->adaa_Fx1 - curve_F2(c, xb)) / delta);
+        } else {
+            y = clip_sample(0.5f*(xb + x1), c);
+        }
+    }
+
+    fx->adaa_x2 = x1;
+    fx->adaa_x1 = x;
+    fx->adaa_Fx1 = F;
+    fx->adaa_D = D;
+    return y;
+}
+
+static inline float clip_process(DS1 *fx, float x){
+    switch(fx->type){
+        case CLIP_HARD_ADAA1: case CLIP_TANH_ADAA1: case CLIP_ASYM_ADAA1:
+            return clip_adaa1(fx, adaa_curve(fx->type), x);
+        case CLIP_HARD_ADAA2: case CLIP_TANH_ADAA2: case CLIP_ASYM_ADAA2:
+            return clip_adaa2(fx, adaa_curve(fx->type), x);
+        case CLIP_SHAPER:
+            return Waveshaper_ProcessSample(&fx->shaper, x);
+        default:
+            return clip_sample(x, fx->type);
+    }
+}
+
 float DS1_ProcessSample(DS1 *fx, float in){
     // 1. Input HPF
-    float x = hpf_process(&fx->hpf, in);
+    float x = OnePoleHPF_Process(&fx->hpf, in);
 
     // 2. Pre-gain
     x *= fx->drive;
 
     // 3. Clipping
-    x = clip_sample(x, fx->type);
+    x = clip_process(fx, x);
 
     // 4. Tone shaping LPF
-    x = lpf_process(&fx->tone, x);
+    x = OnePoleLPF_Process(&fx->tone, x);
 
     // 5. Output level
     return x * fx->output;
-}
\ No newline at end of file
+}
+
+void DS1_ProcessBlock(DS1 *fx, const float *in, float *out, uint32_t n){
+    // 1. Input HPF + 2. Pre-gain at the base rate
+    for (uint32_t i = 0; i < n; i++){
+        out[i] = OnePoleHPF_Process(&fx->hpf, in[i]) * fx->drive;
+    }
+
+    // 3. Clipping, optionally at 2x/4x/8x to keep the harmonics from aliasing
+    if (fx->os_stages == 0){
+        if (fx->type == CLIP_SHAPER){
+            Waveshaper_ProcessBlock(&fx->shaper, out, out, n);
+        } else {
+            for (uint32_t i = 0; i < n; i++){
+                out[i] = clip_process(fx, out[i]);
+            }
+        }
+    } else {
+        uint32_t len = n;
+        memcpy(os_buf, out, n * sizeof(float));
+        for (uint32_t s = 0; s < fx->os_stages; s++){
+            HalfBand_Up(&fx->up[s], os_buf, os_buf, len);
+            len *= 2;
+        }
+        if (fx->type == CLIP_SHAPER){
+            Waveshaper_ProcessBlock(&fx->shaper, os_buf, os_buf, len);
+        } else {
+            for (uint32_t i = 0; i < len; i++){
+                os_buf[i] = clip_process(fx, os_buf[i]);
+            }
+        }
+        for (uint32_t s = fx->os_stages; s-- > 0;){
+            len /= 2;
+            HalfBand_Down(&fx->down[s], os_buf, os_buf, len);
+        }
+        memcpy(out, os_buf, n * sizeof(float));
+    }
+
+    // 4. Tone shaping LPF + 5. Output level
+    for (uint32_t i = 0; i < n; i++){
+        out[i] = OnePoleLPF_Process(&fx->tone, out[i]) * fx->output;
+    }
+}
@@ -0,0 +1,83 @@
+#include "dsp_bench.h"
+#include "dsp_configuration.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void DSP_Bench_FillInput(float* buf, uint32_t len)
+{
+    uint32_t seed = 22222;
+    float saw = 0.0f;
+    float env = 0.8f;
+
+    for (uint32_t i = 0; i < len; i++) {
+        seed = seed * 196314165u + 907633515u;
+        float noise = (float)(int32_t)seed * (1.0f / 2147483648.0f);
+
+        saw += 110.0f / SAMPLE_RATE * 2.0f;
+        if (saw > 1.0f) saw -= 2.0f;
+
+        buf[i] = env * saw + 0.01f * noise;
+        env *= 0.9999f;
+    }
+}
+
+uint32_t DSP_Bench_Report(const char* name, uint32_t start, uint32_t frames)
+{
+    uint32_t cycles = (uint32_t)SEGGER_SYSVIEW_GET_TIMESTAMP() - start;
+    uint32_t per_frame_x100 = (uint32_t)(((uint64_t)cycles * 100u) / frames);
+
+    SEGGER_SYSVIEW_PrintfHost("BENCH %s: %u.%02u cycles/frame",
+                              name, per_frame_x100 / 100u, per_frame_x100 % 100u);
+    return per_frame_x100;
+}
+
+void DSP_Goertzel_Init(DSP_Goertzel_t* g, float freq_hz)
+{
+    g->coeff = 2.0f * cosf(2.0f * (float)M_PI * freq_hz / SAMPLE_RATE);
+    g->s1 = 0.0f;
+    g->s2 = 0.0f;
+}
+
+void DSP_Goertzel_Push(DSP_Goertzel_t* g, const float* buf, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        float s = buf[i] + g->coeff * g->s1 - g->s2;
+        g->s2 = g->s1;
+        g->s1 = s;
+    }
+}
+
+float DSP_Goertzel_Power(const DSP_Goertzel_t* g)
+{
+    return g->s1 * g->s1 + g->s2 * g->s2 - g->coeff * g->s1 * g->s2;
+}
+
+float DSP_Bench_Tone(DSP_Bench_Process_t process, void* fx, float hz, float amp, uint32_t settle, uint32_t measure,
+                     DSP_Goertzel_t* in, DSP_Goertzel_t* out, uint32_t bins)
+{
+    static float l[BLOCK_SIZE_FLOAT], r[BLOCK_SIZE_FLOAT];
+    const double inc = (double)hz / SAMPLE_RATE;
+    double phase = 0.0;     // cycles; in float the rounding of the sum smears the bins at -80 dB
+    float power = 0.0f;
+
+    for (uint32_t n = 0; n < settle + measure; n += BLOCK_SIZE_FLOAT) {
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            l[i] = r[i] = amp * sinf(2.0f * (float)M_PI * (float)phase);
+            phase += inc;
+            if (phase >= 1.0) phase -= 1.0;
+        }
+        if (n >= settle && in) DSP_Goertzel_Push(in, l, BLOCK_SIZE_FLOAT);
+        process(fx, l, r, BLOCK_SIZE_FLOAT);
+        if (n < settle) continue;
+        for (uint32_t k = 0; k < bins; k++) {
+            DSP_Goertzel_Push(&out[k], l, BLOCK_SIZE_FLOAT);
+        }
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            power += l[i] * l[i];
+        }
+    }
+    return power / (float)measure;
+}
@@ -0,0 +1,160 @@
+#include "eq.h"
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void EQ_Design(float* c, EQ_Type_t type, float freq, float q, float gain_dB, float sample_rate) {
+    if (freq < 1.0f) freq = 1.0f;
+    if (freq > 0.49f * sample_rate) freq = 0.49f * sample_rate;
+    if (q < 0.1f) q = 0.1f;
+    float w = 2.0f * (float)M_PI * freq / sample_rate;
+    float cw = cosf(w);
+    float alpha = sinf(w) / (2.0f * q);
+    float A = powf(10.0f, gain_dB / 40.0f);
+    float sa = 2.0f * sqrtf(A) * alpha;
+    float b0, b1, b2, a0, a1, a2;
+
+    switch (type) {
+        case EQ_LOW_SHELF:
+            b0 = A * ((A + 1.0f) - (A - 1.0f) * cw + sa);
+            b1 = 2.0f * A * ((A - 1.0f) - (A + 1.0f) * cw);
+            b2 = A * ((A + 1.0f) - (A - 1.0f) * cw - sa);
+            a0 = (A + 1.0f) + (A - 1.0f) * cw + sa;
+            a1 = -2.0f * ((A - 1.0f) + (A + 1.0f) * cw);
+            a2 = (A + 1.0f) + (A - 1.0f) * cw - sa;
+            break;
+        case EQ_HIGH_SHELF:
+            b0 = A * ((A + 1.0f) + (A - 1.0f) * cw + sa);
+            b1 = -2.0f * A * ((A - 1.0f) + (A + 1.0f) * cw);
+            b2 = A * ((A + 1.0f) + (A - 1.0f) * cw - sa);
+            a0 = (A + 1.0f) - (A - 1.0f) * cw + sa;
+            a1 = 2.0f * ((A - 1.0f) - (A + 1.0f) * cw);
+            a2 = (A + 1.0f) - (A - 1.0f) * cw - sa;
+            break;
+        case EQ_NOTCH:
+            b0 = 1.0f; b1 = -2.0f * cw; b2 = 1.0f;
+            a0 = 1.0f + alpha; a1 = -2.0f * cw; a2 = 1.0f - alpha;
+            break;
+        case EQ_LOW_PASS:
+            b0 = (1.0f - cw) * 0.5f; b1 = 1.0f - cw; b2 = b0;
+            a0 = 1.0f + alpha; a1 = -2.0f * cw; a2 = 1.0f - alpha;
+            break;
+        case EQ_HIGH_PASS:
+            b0 = (1.0f + cw) * 0.5f; b1 = -(1.0f + cw); b2 = b0;
+            a0 = 1.0f + alpha; a1 = -2.0f * cw; a2 = 1.0f - alpha;
+            break;
+        default:
+            b0 = 1.0f + alpha * A; b1 = -2.0f * cw; b2 = 1.0f - alpha * A;
+            a0 = 1.0f + alpha / A; a1 = -2.0f * cw; a2 = 1.0f - alpha / A;
+            break;
+    }
+    c[0] = b0 / a0; c[1] = b1 / a0; c[2] = b2 / a0;
+    c[3] = -a1 / a0; c[4] = -a2 / a0;
+}
+
+// A peak or shelf at 0 dB is a wire and stays out of the cascade
+static uint8_t band_active(const EQ_Band_t* b) {
+    if (!b->enabled) return 0;
+    if (b->type == EQ_PEAK || b->type == EQ_LOW_SHELF || b->type == EQ_HIGH_SHELF) {
+        return b->gain_dB != 0.0f;
+    }
+    return 1;
+}
+
+/*Packs the active bands into the spare set. pending is cleared first so the audio side
+cannot take the set up half written; with it clear 'live' does not change either.*/
+static void publish(EQ_t* eq) {
+    eq->pending = 0;
+    __COMPILER_BARRIER();
+    EQ_Set_t* s = &eq->set[eq->live ^ 1u];
+    uint32_t n = 0;
+    for (uint32_t b = 0; b < EQ_MAX_BANDS; b++) {
+        if (band_active(&eq->band[b])) {
+            memcpy(&s->coeffs[5 * n], eq->band[b].coeffs, sizeof(eq->band[b].coeffs));
+            s->band[n] = (uint8_t)b;
+            n++;
+        }
+    }
+    s->stages = n;
+    __COMPILER_BARRIER();
+    eq->pending = 1;
+}
+
+// Audio side: swap sets, each band carries its state over to its new section
+static void take_pending(EQ_t* eq) {
+    const EQ_Set_t* old = &eq->set[eq->live];
+    const EQ_Set_t* s = &eq->set[eq->live ^ 1u];
+    float zl[2 * EQ_MAX_BANDS];
+    float zr[2 * EQ_MAX_BANDS];
+    memcpy(zl, eq->stateL, sizeof(zl));
+    memcpy(zr, eq->stateR, sizeof(zr));
+
+    arm_biquad_cascade_df2T_init_f32(&eq->left, (uint8_t)s->stages, s->coeffs, eq->stateL);
+    arm_biquad_cascade_df2T_init_f32(&eq->right, (uint8_t)s->stages, s->coeffs, eq->stateR);
+    for (uint32_t k = 0; k < s->stages; k++) {
+        for (uint32_t j = 0; j < old->stages; j++) {
+            if (old->band[j] == s->band[k]) {
+                memcpy(&eq->stateL[2 * k], &zl[2 * j], 2 * sizeof(float));
+                memcpy(&eq->stateR[2 * k], &zr[2 * j], 2 * sizeof(float));
+                break;
+            }
+        }
+    }
+    eq->live ^= 1u;
+    eq->pending = 0;
+}
+
+void EQ_Init(EQ_t* eq, float sample_rate) {
+    memset(eq, 0, sizeof(EQ_t));
+    eq->sample_rate = sample_rate;
+    for (uint32_t b = 0; b < EQ_MAX_BANDS; b++) {
+        eq->band[b].type = EQ_PEAK;
+        eq->band[b].freq = 1000.0f;
+        eq->band[b].q = 0.70710678f;
+    }
+    arm_biquad_cascade_df2T_init_f32(&eq->left, 0, eq->set[0].coeffs, eq->stateL);
+    arm_biquad_cascade_df2T_init_f32(&eq->right, 0, eq->set[0].coeffs, eq->stateR);
+}
+
+uint8_t EQ_SetBand(EQ_t* eq, uint32_t band, EQ_Type_t type, float freq, float q, float gain_dB) {
+    if (band >= EQ_MAX_BANDS) return 0;
+    EQ_Band_t* b = &eq->band[band];
+    b->type = type;
+    b->freq = freq;
+    b->q = q;
+    b->gain_dB = gain_dB;
+    b->enabled = 1;
+    EQ_Design(b->coeffs, type, freq, q, gain_dB, eq->sample_rate);
+    publish(eq);
+    return 1;
+}
+
+void EQ_SetGain(EQ_t* eq, uint32_t band, float gain_dB) {
+    if (band >= EQ_MAX_BANDS) return;
+    EQ_Band_t* b = &eq->band[band];
+    if (gain_dB == b->gain_dB) return;
+    b->gain_dB = gain_dB;
+    EQ_Design(b->coeffs, b->type, b->freq, b->q, gain_dB, eq->sample_rate);
+    publish(eq);
+}
+
+void EQ_EnableBand(EQ_t* eq, uint32_t band, uint8_t enable) {
+    if (band >= EQ_MAX_BANDS) return;
+    if (eq->band[band].enabled == (enable != 0)) return;
+    eq->band[band].enabled = (enable != 0);
+    publish(eq);
+}
+
+uint32_t EQ_ActiveBands(const EQ_t* eq) {
+    return eq->set[eq->pending ? eq->live ^ 1u : eq->live].stages;
+}
+
+void EQ_ProcessBlock(EQ_t* eq, float* l, float* r, uint32_t n) {
+    if (eq->pending) take_pending(eq);
+    if (eq->set[eq->live].stages == 0) return;
+    arm_biquad_cascade_df2T_f32(&eq->left, l, l, n);
+    arm_biquad_cascade_df2T_f32(&eq->right, r, r, n);
+}
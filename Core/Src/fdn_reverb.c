@@ -0,0 +1,139 @@
+#include "fdn_reverb.h"
+#include <stddef.h>
+#include <math.h>
+
+const uint32_t FDN_DefaultLengths[FDN_LINES] = {1201, 1433, 1669, 1889, 2131, 2371, 2591, 2833};
+
+// 1/sqrt(8): makes the butterflies below an orthogonal matrix
+#define FDN_MIX_SCALE 0.35355339f
+// Wet output level, about that of the Schroeder reverb at the same decay
+#define FDN_OUT_SCALE 0.5f
+
+// Lengths are given at SAMPLE_RATE; scaled ones are kept odd so they stay nearly coprime
+static uint32_t scaled_len(uint32_t len, float rate) {
+    if (rate == (float)SAMPLE_RATE) return len;
+    return (uint32_t)((float)len * rate / (float)SAMPLE_RATE) | 1u;
+}
+
+uint32_t FDN_PoolSize(const uint32_t* len, float rate) {
+    uint32_t size = 0;
+    for (uint32_t k = 0; k < FDN_LINES; k++) size += scaled_len(len[k], rate);
+    return size;
+}
+
+uint8_t FDN_Init(FDN_t* fdn, Reverb_Pool_t* pools, uint32_t poolCount, const uint32_t* len, float rate,
+                 float rt60_s, float hf_ratio, float wet) {
+    fdn->ready = 0;
+    fdn->rate = rate;
+    for (uint32_t k = 0; k < FDN_LINES; k++) {
+        fdn->len[k] = scaled_len(len[k], rate);
+        fdn->buf[k] = Reverb_PoolListAlloc(pools, poolCount, fdn->len[k]);
+        if (fdn->buf[k] == NULL) return 0;
+        fdn->pos[k] = 0;
+        fdn->lp[k] = 0.0f;
+    }
+    FDN_SetDecay(fdn, rt60_s, hf_ratio);
+    FDN_SetWet(fdn, wet);
+    fdn->ready = 1;
+    return 1;
+}
+
+/*Jot's absorbent filters: line k gets g (1 - p) / (1 - p z^-1) with g = 10^(-3 len / (rt60 fs))
+for the decay at DC and p = ln(10)/4 log10(g) (1 - 1/hf_ratio^2) for the one at Nyquist.*/
+void FDN_SetDecay(FDN_t* fdn, float rt60_s, float hf_ratio) {
+    if (hf_ratio > 1.0f) hf_ratio = 1.0f;
+    if (hf_ratio < 0.05f) hf_ratio = 0.05f;
+    const float shape = 0.25f * logf(10.0f) * (1.0f - 1.0f / (hf_ratio * hf_ratio));
+
+    for (uint32_t k = 0; k < FDN_LINES; k++) {
+        float log_g = -3.0f * (float)fdn->len[k] / (rt60_s * fdn->rate);
+        float p = shape * log_g;
+        if (p > 0.99f) p = 0.99f;
+        fdn->pole[k] = p;
+        fdn->gain[k] = powf(10.0f, log_g) * (1.0f - p) * FDN_MIX_SCALE;
+    }
+}
+
+void FDN_SetWet(FDN_t* fdn, float wet) {
+    fdn->wet = wet;
+}
+
+/*Per sample: read the eight line outputs, tap the stereo outputs from them, damp,
+mix through the Hadamard butterflies and write back with the input added. Reads and
+writes share the position of each line, so the loop runs between wraps on plain
+pointers; the filter states stay in registers for the whole run.*/
+void FDN_ProcessBlock(FDN_t* fdn, float* l, float* r, uint32_t n) {
+    if (!fdn->ready) return;
+    const float wet = fdn->wet * FDN_OUT_SCALE;
+    const float dry = 1.0f - fdn->wet;
+    const float g0 = fdn->gain[0], g1 = fdn->gain[1], g2 = fdn->gain[2], g3 = fdn->gain[3];
+    const float g4 = fdn->gain[4], g5 = fdn->gain[5], g6 = fdn->gain[6], g7 = fdn->gain[7];
+    const float p0 = fdn->pole[0], p1 = fdn->pole[1], p2 = fdn->pole[2], p3 = fdn->pole[3];
+    const float p4 = fdn->pole[4], p5 = fdn->pole[5], p6 = fdn->pole[6], p7 = fdn->pole[7];
+    float d0 = fdn->lp[0], d1 = fdn->lp[1], d2 = fdn->lp[2], d3 = fdn->lp[3];
+    float d4 = fdn->lp[4], d5 = fdn->lp[5], d6 = fdn->lp[6], d7 = fdn->lp[7];
+
+    while (n > 0) {
+        uint32_t run = n;
+        for (uint32_t k = 0; k < FDN_LINES; k++) {
+            uint32_t left = fdn->len[k] - fdn->pos[k];
+            if (left < run) run = left;
+        }
+        float* b0 = &fdn->buf[0][fdn->pos[0]];
+        float* b1 = &fdn->buf[1][fdn->pos[1]];
+        float* b2 = &fdn->buf[2][fdn->pos[2]];
+        float* b3 = &fdn->buf[3][fdn->pos[3]];
+        float* b4 = &fdn->buf[4][fdn->pos[4]];
+        float* b5 = &fdn->buf[5][fdn->pos[5]];
+        float* b6 = &fdn->buf[6][fdn->pos[6]];
+        float* b7 = &fdn->buf[7][fdn->pos[7]];
+
+        for (uint32_t i = 0; i < run; i++) {
+            float x = 0.5f * (l[i] + r[i]);
+            float s0 = b0[i], s1 = b1[i], s2 = b2[i], s3 = b3[i];
+            float s4 = b4[i], s5 = b5[i], s6 = b6[i], s7 = b7[i];
+
+            // Two orthogonal Hadamard rows as the stereo taps
+            float yl = ((s0 - s1) + (s2 - s3)) + ((s4 - s5) + (s6 - s7));
+            float yr = ((s0 + s1) - (s2 + s3)) + ((s4 + s5) - (s6 + s7));
+            l[i] = dry * l[i] + wet * yl;
+            r[i] = dry * r[i] + wet * yr;
+
+            d0 = g0 * s0 + p0 * d0;
+            d1 = g1 * s1 + p1 * d1;
+            d2 = g2 * s2 + p2 * d2;
+            d3 = g3 * s3 + p3 * d3;
+            d4 = g4 * s4 + p4 * d4;
+            d5 = g5 * s5 + p5 * d5;
+            d6 = g6 * s6 + p6 * d6;
+            d7 = g7 * s7 + p7 * d7;
+
+            // Hadamard butterflies: pairs at distance 1, 2, 4
+            float a0 = d0 + d1, a1 = d0 - d1, a2 = d2 + d3, a3 = d2 - d3;
+            float a4 = d4 + d5, a5 = d4 - d5, a6 = d6 + d7, a7 = d6 - d7;
+            float c0 = a0 + a2, c2 = a0 - a2, c1 = a1 + a3, c3 = a1 - a3;
+            float c4 = a4 + a6, c6 = a4 - a6, c5 = a5 + a7, c7 = a5 - a7;
+
+            // Input on Hadamard row 6 (+ + - - - - + +), orthogonal to both taps
+            b0[i] = (c0 + c4) + x;
+            b1[i] = (c1 + c5) + x;
+            b2[i] = (c2 + c6) - x;
+            b3[i] = (c3 + c7) - x;
+            b4[i] = (c0 - c4) - x;
+            b5[i] = (c1 - c5) - x;
+            b6[i] = (c2 - c6) + x;
+            b7[i] = (c3 - c7) + x;
+        }
+
+        for (uint32_t k = 0; k < FDN_LINES; k++) {
+            fdn->pos[k] += run;
+            if (fdn->pos[k] == fdn->len[k]) fdn->pos[k] = 0;
+        }
+        l += run;
+        r += run;
+        n -= run;
+    }
+
+    fdn->lp[0] = d0; fdn->lp[1] = d1; fdn->lp[2] = d2; fdn->lp[3] = d3;
+    fdn->lp[4] = d4; fdn->lp[5] = d5; fdn->lp[6] = d6; fdn->lp[7] = d7;
+}
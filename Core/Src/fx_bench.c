@@ -0,0 +1,1054 @@
+#include "fx_bench.h"
+#include "dsp_bench.h"
+#include "waveshaper.h"
+#include "compressor.h"
+#include "fast_math.h"
+#include "truepeak.h"
+#include "modulation.h"
+#include "phaser.h"
+#include "autowah.h"
+#include "neural_amp_model.h"
+#include "SEGGER_SYSVIEW.h"
+#include <string.h>
+#include <math.h>
+
+#ifdef DSP_BENCH_ENABLE
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Signed value x100 as "-1.23"
+#define BENCH_X100(v) ((v) < 0 ? "-" : ""), (uint32_t)((v) < 0 ? -(v) : (v)) / 100u, (uint32_t)((v) < 0 ? -(v) : (v)) % 100u
+
+/*l_buf_in holds the test signal, r_buf_in what a bench derives from it; the second half
+of the output buffers is a second instance's block*/
+static float l_buf_in [BLOCK_SIZE_FLOAT];
+static float r_buf_in [BLOCK_SIZE_FLOAT];
+static float l_buf_out [BLOCK_SIZE_FLOAT*2];
+static float r_buf_out [BLOCK_SIZE_FLOAT*2];
+
+static Compressor_t bench_comp;
+
+/*DSP_Bench_Tone hooks*/
+static void ds1_run(void* fx, float* l, float* r, uint32_t n) { DS1_ProcessBlock(fx, l, l, n); }
+static void comp_run(void* fx, float* l, float* r, uint32_t n) { Compressor_ProcessBlock(fx, l, r, n); }
+#ifdef REVERB_ENABLE
+static void rr_run(void* fx, float* l, float* r, uint32_t n) { ReducedRate_ProcessBlock(fx, l, r, n); }
+#endif // REVERB_ENABLE
+#ifdef EQ_ENABLE
+static void eq_run(void* fx, float* l, float* r, uint32_t n) { EQ_ProcessBlock(fx, l, r, n); }
+#endif // EQ_ENABLE
+#ifdef HARMONIZER_ENABLE
+static void harm_run(void* fx, float* l, float* r, uint32_t n) { Harmonizer_ProcessBlock(fx, l, r, n); }
+#endif // HARMONIZER_ENABLE
+#if defined(PHASER_ENABLE) || defined(AUTOWAH_ENABLE)
+static void wah_centre(void* fx, float* l, float* r, uint32_t n) { AutoWah_ProcessBlock(fx, l, r, n, 0.5f); }
+#endif // PHASER_ENABLE || AUTOWAH_ENABLE
+
+void FX_Bench_Delay(FX_Delay_t* dly)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    uint32_t start;
+
+    /* Stereo frames: plain feedback vs. tape feedback section */
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    FX_Delay_Init(dly, 400, 0.25f, 0.5f);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            l_buf_out[i] = r_buf_out[i] = l_buf_in[i];
+            FX_Do_DelayStereo(dly, &l_buf_out[i], &r_buf_out[i]);
+        }
+    }
+    DSP_Bench_Report("delay", start, frames);
+
+    FX_Delay_SetTape(dly, 3500.0f, 120.0f, 2.0f, 1.5f, 0.15f);
+    FX_Delay_EnableTape(dly, 1);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            l_buf_out[i] = r_buf_out[i] = l_buf_in[i];
+            FX_Do_DelayStereo(dly, &l_buf_out[i], &r_buf_out[i]);
+        }
+    }
+    DSP_Bench_Report("delay+tape", start, frames);
+}
+
+/*Spring reverb: cascade depth against the block deadline (180 MHz)*/
+void FX_Bench_Spring(SpringReverb* spring, float* mem, uint32_t size)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    static const struct { const char* name; uint32_t sections; } spring_cfg[] = {
+        {"spring 25 sections", 25}, {"spring 50 sections", 50}, {"spring 75 sections", 75}, {"spring 100 sections", 100},
+    };
+    const uint32_t spring_deadline = 180000000u / SAMPLE_RATE; // cycles per frame
+    uint32_t spring_cost[4] = {0};
+
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    for (uint32_t c = 0; c < 4; c++) {
+        if (!SpringReverb_Init(spring, mem, size, SPRING_COUNT,
+                               spring_cfg[c].sections, SPRING_RT60, SPRING_MIX)) continue;
+        uint32_t start = DSP_Bench_Start();
+        for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+            memcpy(l_buf_out, l_buf_in, sizeof(float) * BLOCK_SIZE_FLOAT);
+            memcpy(r_buf_out, l_buf_in, sizeof(float) * BLOCK_SIZE_FLOAT);
+            SpringReverb_ProcessBlock(spring, l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT);
+        }
+        spring_cost[c] = DSP_Bench_Report(spring_cfg[c].name, start, frames); // x100
+        SEGGER_SYSVIEW_PrintfHost("BENCH %s: %u springs, %u%% of the block deadline", spring_cfg[c].name,
+                                  SPRING_COUNT, spring_cost[c] / spring_deadline);
+    }
+    if (spring_cost[3] > spring_cost[0]) {
+        uint32_t per_section = (spring_cost[3] - spring_cost[0]) / 75;
+        uint32_t fixed = spring_cost[0] - 25 * per_section;
+        SEGGER_SYSVIEW_PrintfHost("BENCH spring: %u.%02u cycles/frame per section (%u springs), fixed %u.%02u, %u sections fit the deadline",
+                                  per_section / 100u, per_section % 100u, SPRING_COUNT, fixed / 100u, fixed % 100u,
+                                  per_section ? (spring_deadline * 100u - fixed) / per_section : 0u);
+    }
+}
+
+#ifdef REVERB_ENABLE
+static const char* bench_rr_name(const char* reverb, uint32_t f)
+{
+    static char name[24];
+    static const char* const rate[RR_MAX_FACTOR] = {"48k", "24k", "16k"};
+    strcpy(name, reverb);
+    strcat(name, " ");
+    strcat(name, rate[f - 1]);
+    return name;
+}
+
+/*A reverb already set up for SAMPLE_RATE / f, fully wet, run through the wrapper at REVERB_WET*/
+static uint32_t bench_reverb_rr(ReducedRate_t* rr, const char* name, uint32_t f, ReducedRate_Process_t run, void* fx, uint32_t floats)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+
+    ReducedRate_Init(rr, f, run, fx, fx ? REVERB_WET : 1.0f);
+    uint32_t start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        memcpy(l_buf_out, l_buf_in, sizeof(float) * BLOCK_SIZE_FLOAT);
+        memcpy(r_buf_out, l_buf_in, sizeof(float) * BLOCK_SIZE_FLOAT);
+        ReducedRate_ProcessBlock(rr, l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT);
+    }
+    uint32_t cost = DSP_Bench_Report(name, start, frames);
+    if (fx) SEGGER_SYSVIEW_PrintfHost("BENCH %s: %u floats of lines", name, floats);
+    return cost;
+}
+
+/*Level (dB) the resampling wrapper alone gives a sine at 'hz' (10 Hz grid), measured where
+it lands at the low rate: 'hz' itself in the passband, its alias above it*/
+static int32_t bench_rr_response_dB(ReducedRate_t* rr, uint32_t f, float hz)
+{
+    const float low = (float)SAMPLE_RATE / f;
+    float at = fmodf(hz, low);
+    if (at > 0.5f * low) at = low - at;
+    DSP_Goertzel_t in, out;
+
+    ReducedRate_Init(rr, f, NULL, NULL, 1.0f);
+    DSP_Goertzel_Init(&in, hz);
+    DSP_Goertzel_Init(&out, at);
+    DSP_Bench_Tone(rr_run, rr, hz, 0.5f, 4800, 4800, &in, &out, 1);
+    return (int32_t)lrintf(10.0f * log10f(DSP_Goertzel_Power(&out) / DSP_Goertzel_Power(&in) + 1e-20f));
+}
+
+static Reverb_t bench_rv_q15;
+
+/*Schroeder reverb with float and Q15 lines: cycles at the full rate, then both side by side
+at half rate (both fit the pool there) on a 0.1 s noise burst. The decay times come from the
+level drop over half of REVERB_RT60 from 0.2 s, the error is the difference of the outputs
+over the first second, re full scale.*/
+static void bench_reverb_q15(Reverb_t* rv, float* mem)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    Reverb_Config_t cfg = Reverb_DefaultConfig;
+    Reverb_Pool_t pool;
+
+    for (uint8_t q15 = 0; q15 < 2; q15++) {
+        cfg.q15 = q15;
+        Reverb_PoolInit(&pool, mem, REVERB_POOL_SIZE);
+        if (!Reverb_Init(rv, &pool, &cfg, (float)SAMPLE_RATE, REVERB_RT60, 1.0f)) continue;
+        uint32_t start = DSP_Bench_Start();
+        for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+            memcpy(l_buf_out, l_buf_in, sizeof(float) * BLOCK_SIZE_FLOAT);
+            memcpy(r_buf_out, l_buf_in, sizeof(float) * BLOCK_SIZE_FLOAT);
+            Reverb_ProcessBlock(rv, l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT);
+        }
+        DSP_Bench_Report(q15 ? "schroeder q15" : "schroeder float", start, frames);
+        SEGGER_SYSVIEW_PrintfHost("BENCH schroeder %s: %u floats of lines", q15 ? "q15" : "float", pool.used);
+    }
+
+    const float rate = 0.5f * (float)SAMPLE_RATE;
+    const uint32_t window = (uint32_t)(0.1f * rate) / BLOCK_SIZE_FLOAT; // blocks
+    const uint32_t w_start = 2, w_end = w_start + (uint32_t)(5.0f * REVERB_RT60);
+    float* q_l = &l_buf_out[BLOCK_SIZE_FLOAT];
+    float* q_r = &r_buf_out[BLOCK_SIZE_FLOAT];
+
+    Reverb_PoolInit(&pool, mem, REVERB_POOL_SIZE);
+    cfg.q15 = 0;
+    uint8_t ok = Reverb_Init(rv, &pool, &cfg, rate, REVERB_RT60, 1.0f);
+    cfg.q15 = 1;
+    ok = ok && Reverb_Init(&bench_rv_q15, &pool, &cfg, rate, REVERB_RT60, 1.0f);
+    if (!ok) return;
+
+    float e_float[2] = {0.0f, 0.0f}, e_q15[2] = {0.0f, 0.0f}, err_max = 0.0f;
+    uint32_t silent = 0;
+    for (uint32_t w = 0; w < (uint32_t)(30.0f * REVERB_RT60); w++) {
+        float ef = 0.0f, eq = 0.0f, ee = 0.0f;
+        for (uint32_t b = 0; b < window; b++) {
+            for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+                l_buf_out[i] = (w == 0) ? 0.5f * l_buf_in[i] : 0.0f;
+                r_buf_out[i] = q_l[i] = q_r[i] = l_buf_out[i];
+            }
+            Reverb_ProcessBlock(rv, l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT);
+            Reverb_ProcessBlock(&bench_rv_q15, q_l, q_r, BLOCK_SIZE_FLOAT);
+            for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+                ef += l_buf_out[i] * l_buf_out[i];
+                eq += q_l[i] * q_l[i];
+                ee += (l_buf_out[i] - q_l[i]) * (l_buf_out[i] - q_l[i]);
+            }
+        }
+        if (w == w_start || w == w_end) {
+            e_float[w == w_end] = ef;
+            e_q15[w == w_end] = eq;
+        }
+        if (w < 10 && ee > err_max) err_max = ee;
+        if (silent == 0 && w > 1 && eq == 0.0f) silent = w;
+    }
+    // 60 dB over the drop between the two windows
+    const float span = 100.0f * (float)(w_end - w_start); // ms
+    uint32_t rt_float = (uint32_t)(60.0f * span / (10.0f * log10f(e_float[0] / e_float[1])));
+    uint32_t rt_q15 = (uint32_t)(60.0f * span / (10.0f * log10f(e_q15[0] / (e_q15[1] + 1e-30f))));
+    SEGGER_SYSVIEW_PrintfHost("BENCH schroeder q15 vs float: rt60 %u / %u ms, err %d dB FS, q15 tail silent after %u ms",
+                              rt_float, rt_q15,
+                              (int32_t)lrintf(10.0f * log10f(err_max / (float)(window * BLOCK_SIZE_FLOAT) + 1e-20f)),
+                              silent * 100u);
+}
+
+/*Reverbs at the full, half and third rate behind the resampling wrapper, both channels,
+then the resampling alone*/
+void FX_Bench_Reverbs(const FX_Bench_Reverbs_t* rv)
+{
+    Reverb_Pool_t rv_pool;
+
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    for (uint32_t f = 1; f <= RR_MAX_FACTOR; f++) {
+        Reverb_PoolInit(&rv_pool, rv->pool, REVERB_POOL_SIZE);
+        if (!Reverb_Init(rv->schroeder, &rv_pool, rv->cfg, (float)SAMPLE_RATE / f, REVERB_RT60, 1.0f)) continue;
+        uint32_t base = bench_reverb_rr(rv->rr, bench_rr_name("schroeder", f), f, Reverb_Run, rv->schroeder, rv_pool.used);
+#ifdef SHIMMER_ENABLE
+        /* Shimmer on top, its line in its own pool (sized for REVERB_DECIMATION and up) */
+        Reverb_Pool_t sh_pool;
+        Reverb_PoolInit(&sh_pool, rv->shimmerPool, SHIMMER_POOL_SIZE(SAMPLE_RATE / REVERB_DECIMATION));
+        if (Shimmer_Init(rv->shimmer, &sh_pool, 1, (float)SAMPLE_RATE / f, Reverb_Run, rv->schroeder,
+                         SHIMMER_SEMITONES, SHIMMER_FEEDBACK)) {
+            uint32_t cost = bench_reverb_rr(rv->rr, bench_rr_name("shimmer", f), f, Shimmer_Run, rv->shimmer,
+                                            rv_pool.used + sh_pool.used);
+            uint32_t extra = cost > base ? cost - base : 0;
+            SEGGER_SYSVIEW_PrintfHost("BENCH shimmer %s: +%u.%02u cycles/frame over the reverb, +%u floats",
+                                      bench_rr_name("", f) + 1, extra / 100u, extra % 100u, sh_pool.used);
+        }
+#else
+        (void)base;
+#endif // SHIMMER_ENABLE
+    }
+    bench_reverb_q15(rv->schroeder, rv->pool);
+#ifdef FDN_ENABLE
+    /* FDN lines split over the CCM and SRAM pools */
+    Reverb_Pool_t fdn_pools[2];
+    for (uint32_t f = 1; f <= RR_MAX_FACTOR; f++) {
+        Reverb_PoolInit(&fdn_pools[0], rv->pool, REVERB_POOL_SIZE);
+        Reverb_PoolInit(&fdn_pools[1], rv->fdnSram, FDN_SRAM_POOL_SIZE);
+        if (FDN_Init(rv->fdn, fdn_pools, 2, FDN_DefaultLengths, (float)SAMPLE_RATE / f, REVERB_RT60, FDN_HF_RATIO, 1.0f)) {
+            bench_reverb_rr(rv->rr, bench_rr_name("fdn", f), f, FDN_Run, rv->fdn, fdn_pools[0].used + fdn_pools[1].used);
+        }
+    }
+#endif // FDN_ENABLE
+#ifdef PLATE_ENABLE
+    Reverb_Pool_t plate_pools[2];
+    for (uint32_t f = 1; f <= RR_MAX_FACTOR; f++) {
+        Reverb_PoolInit(&plate_pools[0], rv->pool, REVERB_POOL_SIZE);
+        Reverb_PoolInit(&plate_pools[1], rv->plateSram, PLATE_SRAM_POOL_SIZE);
+        if (Plate_Init(rv->plate, plate_pools, 2, (float)SAMPLE_RATE / f, PLATE_SIZE, PLATE_DECAY, PLATE_DAMPING, 1.0f)) {
+            bench_reverb_rr(rv->rr, bench_rr_name("plate", f), f, Plate_Run, rv->plate, plate_pools[0].used + plate_pools[1].used);
+        }
+    }
+    SEGGER_SYSVIEW_PrintfHost("BENCH plate: %u floats per instance at size 1, %u at PLATE_SIZE",
+                              Plate_PoolSize((float)SAMPLE_RATE, 1.0f), Plate_PoolSize((float)SAMPLE_RATE, PLATE_SIZE));
+#endif // PLATE_ENABLE
+    /* Resampling alone (no effect, fully wet): cost, passband gain, alias level of tones above the low rate band */
+    for (uint32_t f = 2; f <= RR_MAX_FACTOR; f++) {
+        bench_reverb_rr(rv->rr, f == 2 ? "resample /2" : "resample /3", f, NULL, NULL, 0);
+        SEGGER_SYSVIEW_PrintfHost("BENCH resample /%u: 1 kHz %d dB, 6 kHz %d dB, alias of 15 kHz %d dB, of 20 kHz %d dB, latency %u frames", f,
+                                  bench_rr_response_dB(rv->rr, f, 990.0f), bench_rr_response_dB(rv->rr, f, 5990.0f),
+                                  bench_rr_response_dB(rv->rr, f, 14990.0f), bench_rr_response_dB(rv->rr, f, 19990.0f),
+                                  ReducedRate_Latency(rv->rr));
+    }
+}
+#endif // REVERB_ENABLE
+
+/*Max abs error of a table waveshaper against tanhf over [-10, 10], in units of 1e-7*/
+static uint32_t bench_shaper_error(const Waveshaper_t* ws)
+{
+    float max_err = 0.0f;
+    for (int k = 0; k <= 4096; k++) {
+        float x = -10.0f + 20.0f * (float)k / 4096.0f;
+        float err = fabsf(Waveshaper_ProcessSample(ws, x) - tanhf(x));
+        if (err > max_err) max_err = err;
+    }
+    return (uint32_t)(max_err * 1e7f);
+}
+
+/*Waveshaper: tanhf vs. table lookups, inputs spread over the table range*/
+void FX_Bench_Shaper(void)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    Waveshaper_t ws_lin, ws_cub;
+    uint32_t start;
+    float acc = 0.0f; // keeps the tanhf loop from being optimised away
+
+    Waveshaper_Init(&ws_lin, WS_CURVE_TANH, WS_INTERP_LINEAR);
+    Waveshaper_Init(&ws_cub, WS_CURVE_TANH, WS_INTERP_CUBIC);
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+        r_buf_in[i] = 12.0f * l_buf_in[i];
+    }
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            acc += tanhf(r_buf_in[i]);
+        }
+    }
+    DSP_Bench_Report("tanhf", start, frames);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        Waveshaper_ProcessBlock(&ws_lin, r_buf_in, r_buf_out, BLOCK_SIZE_FLOAT);
+    }
+    DSP_Bench_Report("shaper linear", start, frames);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        Waveshaper_ProcessBlock(&ws_cub, r_buf_in, r_buf_out, BLOCK_SIZE_FLOAT);
+    }
+    DSP_Bench_Report("shaper cubic", start, frames);
+    SEGGER_SYSVIEW_PrintfHost("BENCH shaper max err vs tanhf: linear %u e-7, cubic %u e-7 (checksum %d)",
+                              bench_shaper_error(&ws_lin), bench_shaper_error(&ws_cub), (int32_t)acc);
+}
+
+/*Alias level of DS1 for a coherently sampled sine: odd harmonics of 2910 Hz that fold back
+into the audio band land on bins that are no harmonic, their summed power relative to the fundamental.*/
+static int32_t bench_ds1_alias_dB(DS1* ds1, ClipType type, uint32_t factor)
+{
+    static const float alias_hz[] = {15990.0f, 10170.0f, 4350.0f, 1470.0f, 7290.0f, 13110.0f, 18930.0f};
+    const uint32_t n_alias = sizeof(alias_hz) / sizeof(alias_hz[0]);
+    DSP_Goertzel_t bins[1 + sizeof(alias_hz) / sizeof(alias_hz[0])]; // fundamental, then the aliases
+
+    DS1_Init(ds1, (float)SAMPLE_RATE);
+    DS1_SetParams(ds1, 40.0f, 1.0f, 20000.0f, 100.0f, type);
+    DS1_SetOversampling(ds1, factor);
+    DSP_Goertzel_Init(&bins[0], 2910.0f);
+    for (uint32_t k = 0; k < n_alias; k++) {
+        DSP_Goertzel_Init(&bins[1 + k], alias_hz[k]);
+    }
+    DSP_Bench_Tone(ds1_run, ds1, 2910.0f, 0.5f, 4800, 4800, NULL, bins, 1 + n_alias); // 10 Hz bins
+
+    float p_alias = 0.0f;
+    for (uint32_t k = 0; k < n_alias; k++) {
+        p_alias += DSP_Goertzel_Power(&bins[1 + k]);
+    }
+    return (int32_t)lrintf(10.0f * log10f(p_alias / DSP_Goertzel_Power(&bins[0]) + 1e-20f));
+}
+
+/*DS1: cycles and alias level, oversampling vs. antiderivative anti-aliasing*/
+void FX_Bench_DS1(DS1* ds1)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    static const struct { const char* name; ClipType type; uint32_t factor; } ds1_cfg[] = {
+        {"ds1 hard 1x",    CLIP_HARD,       1},
+        {"ds1 hard 2x",    CLIP_HARD,       2},
+        {"ds1 hard 4x",    CLIP_HARD,       4},
+        {"ds1 hard 8x",    CLIP_HARD,       8},
+        {"ds1 hard adaa1", CLIP_HARD_ADAA1, 1},
+        {"ds1 hard adaa2", CLIP_HARD_ADAA2, 1},
+        {"ds1 tanh 1x",    CLIP_TANH,       1},
+        {"ds1 tanh 2x",    CLIP_TANH,       2},
+        {"ds1 tanh 4x",    CLIP_TANH,       4},
+        {"ds1 tanh adaa1", CLIP_TANH_ADAA1, 1},
+        {"ds1 tanh adaa2", CLIP_TANH_ADAA2, 1},
+        {"ds1 asym 1x",    CLIP_ASYM,       1},
+        {"ds1 asym 2x",    CLIP_ASYM,       2},
+        {"ds1 asym 4x",    CLIP_ASYM,       4},
+        {"ds1 asym adaa1", CLIP_ASYM_ADAA1, 1},
+        {"ds1 asym adaa2", CLIP_ASYM_ADAA2, 1},
+    };
+
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    for (uint32_t c = 0; c < sizeof(ds1_cfg) / sizeof(ds1_cfg[0]); c++) {
+        DS1_Init(ds1, (float)SAMPLE_RATE);
+        DS1_SetParams(ds1, 40.0f, 1.0f, 4000.0f, 100.0f, ds1_cfg[c].type);
+        DS1_SetOversampling(ds1, ds1_cfg[c].factor);
+        uint32_t start = DSP_Bench_Start();
+        for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+            DS1_ProcessBlock(ds1, l_buf_in, l_buf_out, BLOCK_SIZE_FLOAT);
+        }
+        DSP_Bench_Report(ds1_cfg[c].name, start, frames);
+        SEGGER_SYSVIEW_PrintfHost("BENCH %s alias: %d dB", ds1_cfg[c].name,
+                                  bench_ds1_alias_dB(ds1, ds1_cfg[c].type, ds1_cfg[c].factor));
+    }
+}
+
+#ifdef AMPSIM_ENABLE
+/*Amp simulator: cost per preamp stage and how many stages the frame budget (180 MHz) holds*/
+void FX_Bench_Amp(AmpSim_t* amp)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    const uint32_t budget = 180000000u / SAMPLE_RATE;
+    uint32_t amp_cost[AMP_MAX_STAGES];
+    static const char* const amp_names[AMP_MAX_STAGES] = {
+        "amp 1 stage", "amp 2 stages", "amp 3 stages", "amp 4 stages", "amp 5 stages", "amp 6 stages",
+    };
+
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    for (uint32_t s = 1; s <= AMP_MAX_STAGES; s++) {
+        AmpSim_Init(amp, (float)SAMPLE_RATE, s);
+        AmpSim_SetGain(amp, AMP_GAIN);
+        uint32_t start = DSP_Bench_Start();
+        for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+            AmpSim_ProcessBlock(amp, l_buf_in, l_buf_out, BLOCK_SIZE_FLOAT);
+        }
+        amp_cost[s - 1] = DSP_Bench_Report(amp_names[s - 1], start, frames); // x100
+    }
+    uint32_t per_stage = (amp_cost[AMP_MAX_STAGES - 1] - amp_cost[0]) / (AMP_MAX_STAGES - 1);
+    uint32_t fixed = amp_cost[0] - per_stage;
+    SEGGER_SYSVIEW_PrintfHost("BENCH amp: %u.%02u cycles/frame per stage, tone stack + output %u.%02u, budget %u: %u stages per channel",
+                              per_stage / 100u, per_stage % 100u, fixed / 100u, fixed % 100u, budget,
+                              per_stage ? (budget * 100u - fixed) / per_stage : 0u);
+}
+#endif // AMPSIM_ENABLE
+
+#ifdef EQ_ENABLE
+/*Level change through the EQ at 'hz' in tenths of a dB, after 0.1 s of settling*/
+static int32_t bench_eq_gain_dB10(EQ_t* eq, float hz)
+{
+    DSP_Goertzel_t in, out;
+    DSP_Goertzel_Init(&in, hz);
+    DSP_Goertzel_Init(&out, hz);
+    DSP_Bench_Tone(eq_run, eq, hz, 0.25f, 4800, 4800, &in, &out, 1);
+    return (int32_t)lrintf(100.0f * log10f(DSP_Goertzel_Power(&out) / DSP_Goertzel_Power(&in) + 1e-20f));
+}
+
+/*Stereo EQ with 0..EQ_MAX_BANDS active peaks: cost per band from the slope, the block copy
+that keeps the input bounded cancels out of it. Then a band at 0 dB (left out of the
+cascade) and the gain of a +6 dB peak measured at and an octave off its centre.*/
+void FX_Bench_EQ(EQ_t* eq)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    const uint32_t budget = 180000000u / SAMPLE_RATE;
+    static const char* const eq_names[EQ_MAX_BANDS + 1] = {
+        "eq 0 bands", "eq 1 band", "eq 2 bands", "eq 3 bands", "eq 4 bands",
+        "eq 5 bands", "eq 6 bands", "eq 7 bands", "eq 8 bands",
+    };
+    uint32_t cost[EQ_MAX_BANDS + 1];
+
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    EQ_Init(eq, (float)SAMPLE_RATE);
+    for (uint32_t n = 0; n <= EQ_MAX_BANDS; n++) {
+        if (n > 0) EQ_SetBand(eq, n - 1, EQ_PEAK, 60.0f * (float)(1u << n), 1.0f, -3.0f);
+        EQ_ProcessBlock(eq, l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT); // takes up the new set
+        uint32_t start = DSP_Bench_Start();
+        for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+            memcpy(l_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+            memcpy(r_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+            EQ_ProcessBlock(eq, l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT);
+        }
+        cost[n] = DSP_Bench_Report(eq_names[n], start, frames); // x100
+    }
+    uint32_t per_band = (cost[EQ_MAX_BANDS] - cost[1]) / (EQ_MAX_BANDS - 1);
+    SEGGER_SYSVIEW_PrintfHost("BENCH eq: %u.%02u cycles/frame per band (stereo), %u bands %u.%u%% of the budget %u",
+                              per_band / 100u, per_band % 100u, EQ_MAX_BANDS,
+                              cost[EQ_MAX_BANDS] / budget, (cost[EQ_MAX_BANDS] * 10u / budget) % 10u, budget);
+
+    EQ_Init(eq, (float)SAMPLE_RATE);
+    EQ_SetBand(eq, 0, EQ_LOW_SHELF, 200.0f, 0.70710678f, 0.0f);
+    EQ_SetBand(eq, 1, EQ_PEAK, 1000.0f, 1.0f, 6.0f);
+    int32_t at = bench_eq_gain_dB10(eq, 1000.0f);
+    int32_t off = bench_eq_gain_dB10(eq, 2000.0f);
+    SEGGER_SYSVIEW_PrintfHost("BENCH eq: %u of 2 bands in the cascade, +6 dB peak at 1 kHz %d.%u dB, 2 kHz %d.%u dB",
+                              EQ_ActiveBands(eq), at / 10, (uint32_t)(at < 0 ? -at : at) % 10u,
+                              off / 10, (uint32_t)(off < 0 ? -off : off) % 10u);
+}
+#endif // EQ_ENABLE
+
+/*Dynamics: Fast_Log2/Exp2 against libm, the compressor per detector with and without
+look-ahead, the static curve of the RMS detector on a sine, and the overshoot of a
+brickwall limiter (zero attack, 1 ms look-ahead) on the test signal boosted by 12 dB.*/
+void FX_Bench_Dynamics(void)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    uint32_t start;
+    float acc = 0.0f;
+
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+        r_buf_in[i] = fabsf(l_buf_in[i]) + 1e-3f;
+    }
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) acc += log2f(r_buf_in[i]);
+    }
+    DSP_Bench_Report("log2f", start, frames);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) acc += Fast_Log2(r_buf_in[i]);
+    }
+    DSP_Bench_Report("fast log2", start, frames);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) acc += exp2f(-4.0f * r_buf_in[i]);
+    }
+    DSP_Bench_Report("exp2f", start, frames);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) acc += Fast_Exp2(-4.0f * r_buf_in[i]);
+    }
+    DSP_Bench_Report("fast exp2", start, frames);
+    float log_err = 0.0f, exp_err = 0.0f;
+    for (uint32_t k = 0; k < 4096; k++) {
+        float x = -24.0f + (float)k * (24.0f / 4096.0f);
+        float e = fabsf(Fast_Log2(exp2f(x)) - x);
+        if (e > log_err) log_err = e;
+        e = fabsf(Fast_Exp2(x) / exp2f(x) - 1.0f);
+        if (e > exp_err) exp_err = e;
+    }
+    SEGGER_SYSVIEW_PrintfHost("BENCH fast log2 error %u.%04u, exp2 relative error %u.%04u (checksum %d)",
+                              (uint32_t)log_err, (uint32_t)(log_err * 10000.0f) % 10000u,
+                              (uint32_t)exp_err, (uint32_t)(exp_err * 10000.0f) % 10000u, (int32_t)acc);
+
+    static const struct { const char* name; Comp_Detector_t det; float ms; } cfg[] = {
+        {"comp peak",          COMP_PEAK, 0.0f},
+        {"comp peak 1.5ms la", COMP_PEAK, 1.5f},
+        {"comp rms",           COMP_RMS,  0.0f},
+        {"comp rms 1.5ms la",  COMP_RMS,  1.5f},
+    };
+    for (uint32_t c = 0; c < sizeof(cfg) / sizeof(cfg[0]); c++) {
+        Compressor_Init(&bench_comp, (float)SAMPLE_RATE, cfg[c].ms, cfg[c].det);
+        Compressor_SetParams(&bench_comp, -20.0f, 4.0f, 6.0f, 5.0f, 100.0f, 0.0f);
+        start = DSP_Bench_Start();
+        for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+            memcpy(l_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+            memcpy(r_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+            Compressor_ProcessBlock(&bench_comp, l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT);
+        }
+        DSP_Bench_Report(cfg[c].name, start, frames);
+    }
+
+    /* 1 kHz sine at -8 dB RMS into -20 dB, 4:1, hard knee: -17 dB RMS out */
+    Compressor_Init(&bench_comp, (float)SAMPLE_RATE, 0.0f, COMP_RMS);
+    Compressor_SetParams(&bench_comp, -20.0f, 4.0f, 0.0f, 1.0f, 1.0f, 0.0f);
+    const float amp = sqrtf(2.0f) * powf(10.0f, -8.0f / 20.0f);
+    float power = DSP_Bench_Tone(comp_run, &bench_comp, 1000.0f, amp, 2 * 4800, 4800, NULL, NULL, 0);
+    int32_t rms = (int32_t)lrintf(1000.0f * log10f(power + 1e-20f));
+    SEGGER_SYSVIEW_PrintfHost("BENCH comp rms curve: -8 dB in, %s%u.%02u dB out (-17.00 expected)", BENCH_X100(rms));
+
+    Compressor_Init(&bench_comp, (float)SAMPLE_RATE, 1.0f, COMP_PEAK);
+    Compressor_SetParams(&bench_comp, -1.0f, COMP_RATIO_INF, 0.0f, 0.0f, 50.0f, 0.0f);
+    float peak = 0.0f;
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        float g = 4.0f * (1.0f + 0.5f * sinf((float)b * 0.37f)); // level jumps from block to block
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            l_buf_out[i] = g * l_buf_in[i];
+            r_buf_out[i] = -g * l_buf_in[(i + 7) % BLOCK_SIZE_FLOAT];
+        }
+        Compressor_ProcessBlock(&bench_comp, l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT);
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            if (fabsf(l_buf_out[i]) > peak) peak = fabsf(l_buf_out[i]);
+            if (fabsf(r_buf_out[i]) > peak) peak = fabsf(r_buf_out[i]);
+        }
+    }
+    int32_t over = (int32_t)lrintf(100.0f * (20.0f * log10f(peak) + 1.0f));
+    SEGGER_SYSVIEW_PrintfHost("BENCH limiter -1 dB: peak %s%u.%02u dB re the ceiling, latency %u frames",
+                              BENCH_X100(over), Compressor_Latency(&bench_comp));
+}
+
+static uint16_t bench_tx[BLOCK_SIZE_U16];
+static TruePeak_t bench_tp;
+
+// Left channel of a packed frame back to float
+static float bench_unpack(const uint16_t* tx)
+{
+    int32_t s = (int32_t)(((uint32_t)tx[0] << 16) | tx[1]) >> 8;
+    return (float)s / TP_INT24_SCALE;
+}
+
+/*Output stage: the clamping converter alone and behind a separate sample-peak limiter,
+against the fused true-peak converter, limiting and at two levels under the ceiling
+(idle blocks, and blocks only the detector runs on). Then the detector on full scale
+sines whose samples miss the crest, and the true peak coming out of a -1 dBTP ceiling
+on a sine 6 dB over it, re-measured on the unpacked output.*/
+void FX_Bench_Output(FX_Bench_Convert_t clamp)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    const uint32_t la = 8;
+    uint32_t start;
+
+    /* The test signal at full scale on the left and 3.5 dB over it on the right, so both
+    limiters have work in every block */
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    float peak = 0.0f;
+    for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+        if (fabsf(l_buf_in[i]) > peak) peak = fabsf(l_buf_in[i]);
+    }
+    for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+        l_buf_in[i] /= peak;
+    }
+    for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+        r_buf_in[i] = 1.5f * l_buf_in[(i + 5) % BLOCK_SIZE_FLOAT];
+    }
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        clamp(l_buf_in, r_buf_in, bench_tx, BLOCK_SIZE_FLOAT);
+    }
+    DSP_Bench_Report("out clamp", start, frames);
+
+    Compressor_Init(&bench_comp, (float)SAMPLE_RATE, 1000.0f * la / SAMPLE_RATE, COMP_PEAK);
+    Compressor_SetParams(&bench_comp, -1.0f, COMP_RATIO_INF, 0.0f, 0.0f, 50.0f, 0.0f);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        memcpy(l_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+        memcpy(r_buf_out, r_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+        Compressor_ProcessBlock(&bench_comp, l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT);
+        clamp(l_buf_out, r_buf_out, bench_tx, BLOCK_SIZE_FLOAT);
+    }
+    DSP_Bench_Report("out limiter + clamp", start, frames);
+
+    TruePeak_Init(&bench_tp, (float)SAMPLE_RATE, -1.0f, 50.0f, la);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        TruePeak_ProcessBlock(&bench_tp, l_buf_in, r_buf_in, bench_tx, BLOCK_SIZE_FLOAT);
+    }
+    DSP_Bench_Report("out true-peak", start, frames);
+
+    /* The same under the ceiling, the gain never leaving unity: blocks the stage only
+    delays and packs, and blocks whose intervals the detector has to check */
+    static const struct { const char* name; float level; } under[] = {
+        {"out true-peak idle",   0.35f},
+        {"out true-peak detect", 0.5f},
+    };
+    for (uint32_t c = 0; c < sizeof(under) / sizeof(under[0]); c++) {
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            l_buf_out[i] = under[c].level * l_buf_in[i];
+            r_buf_out[i] = under[c].level * r_buf_in[i];
+        }
+        TruePeak_Init(&bench_tp, (float)SAMPLE_RATE, -1.0f, 50.0f, la);
+        start = DSP_Bench_Start();
+        for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+            TruePeak_ProcessBlock(&bench_tp, l_buf_out, r_buf_out, bench_tx, BLOCK_SIZE_FLOAT);
+        }
+        DSP_Bench_Report(under[c].name, start, frames);
+    }
+
+    /* Sines at 0 dBTP, a quarter sample off the crest: worst under-read of samples and detector */
+    static const float tp_hz[] = {1000.0f, 6000.0f, 11000.0f, 15000.0f, 19000.0f};
+    float hist[TP_TAPS];
+    int32_t worst_sample = 0, worst_tp = 0;
+    for (uint32_t f = 0; f < sizeof(tp_hz) / sizeof(tp_hz[0]); f++) {
+        float w = 2.0f * (float)M_PI * tp_hz[f] / (float)SAMPLE_RATE;
+        float smax = 0.0f, tmax = 0.0f;
+        for (uint32_t n = 0; n < 480; n++) {
+            for (uint32_t k = 0; k < TP_TAPS; k++) {
+                hist[k] = sinf(w * ((float)(n + k) + 0.37f));
+            }
+            float sp = fabsf(hist[TP_TAPS / 2 - 1]);
+            float tpk = TruePeak_Detect(&bench_tp, hist);
+            if (sp > smax) smax = sp;
+            if (tpk > tmax) tmax = tpk;
+        }
+        int32_t se = (int32_t)lrintf(2000.0f * log10f(smax));
+        int32_t te = (int32_t)lrintf(2000.0f * log10f(tmax));
+        if (se < worst_sample) worst_sample = se;
+        if ((te < 0 ? -te : te) > (worst_tp < 0 ? -worst_tp : worst_tp)) worst_tp = te;
+    }
+    SEGGER_SYSVIEW_PrintfHost("BENCH true-peak read of 0 dBTP sines 1..19 kHz: samples %s%u.%02u dB, detector %s%u.%02u dB",
+                              BENCH_X100(worst_sample), BENCH_X100(worst_tp));
+
+    /* 11 kHz at +5 dBTP into the -1 dBTP ceiling */
+    TruePeak_Init(&bench_tp, (float)SAMPLE_RATE, -1.0f, 50.0f, la);
+    float out_hist[TP_TAPS] = {0};
+    float out_tp = 0.0f;
+    const float w = 2.0f * (float)M_PI * 11000.0f / (float)SAMPLE_RATE;
+    for (uint32_t b = 0; b < 100; b++) {
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            l_buf_out[i] = 1.78f * sinf(w * ((float)(b * BLOCK_SIZE_FLOAT + i) + 0.37f));
+            r_buf_out[i] = 0.0f;
+        }
+        TruePeak_ProcessBlock(&bench_tp, l_buf_out, r_buf_out, bench_tx, BLOCK_SIZE_FLOAT);
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            memmove(out_hist, &out_hist[1], (TP_TAPS - 1) * sizeof(float));
+            out_hist[TP_TAPS - 1] = bench_unpack(&bench_tx[4 * i]);
+            float p = TruePeak_Detect(&bench_tp, out_hist);
+            if (p > out_tp) out_tp = p;
+        }
+    }
+    int32_t out_dB = (int32_t)lrintf(2000.0f * log10f(out_tp));
+    SEGGER_SYSVIEW_PrintfHost("BENCH true-peak limiter -1 dBTP, 11 kHz at +5 dBTP: %s%u.%02u dBTP out, latency %u frames",
+                              BENCH_X100(out_dB), TruePeak_Latency(&bench_tp));
+}
+
+#ifdef NEURAL_AMP_ENABLE
+/*Neural amp: fixed point CMSIS-NN path vs. the float evaluation of the same weights*/
+void FX_Bench_NeuralAmp(NeuralAmp_t* nam)
+{
+    if (!NeuralAmp_Init(nam, neural_amp_model, sizeof(neural_amp_model))) return;
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    uint32_t start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        NeuralAmp_ProcessBlock(nam, l_buf_in, l_buf_out, BLOCK_SIZE_FLOAT);
+    }
+    DSP_Bench_Report("nam", start, DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT);
+    NeuralAmp_Reset(nam);
+    float max_err = 0.0f;
+    for (uint32_t b = 0; b < 64; b++) {
+        NeuralAmp_ProcessBlock(nam, l_buf_in, l_buf_out, BLOCK_SIZE_FLOAT);
+        NeuralAmp_ReferenceBlock(nam, l_buf_in, r_buf_out, BLOCK_SIZE_FLOAT);
+        for (int i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            float err = fabsf(l_buf_out[i] - r_buf_out[i]);
+            if (err > max_err) max_err = err;
+        }
+    }
+    SEGGER_SYSVIEW_PrintfHost("BENCH nam: hidden %u, %u MACs/sample, max err vs float %u e-6",
+                              nam->hidden, NeuralAmp_MacsPerSample(nam), (uint32_t)(max_err * 1e6f));
+}
+#endif // NEURAL_AMP_ENABLE
+
+#ifdef CAB_ENABLE
+static float bench_cab_taps[CAB_IR_TAPS];
+
+/*Cabinet convolver at partition size 'part': cycles (average and worst block) and the max error
+against direct convolution for two impulses, y[n] = h[n] + 0.5 h[n - d].*/
+static void bench_cab(CabIR_t* ir, CabSim_t* cab, float* spectra, float* mem, const char* name, uint32_t part)
+{
+    const uint32_t d = 3 * part + 37;
+    const uint32_t latency = part - BLOCK_SIZE_FLOAT;
+    const uint32_t blocks = (CAB_IR_TAPS + d + latency) / BLOCK_SIZE_FLOAT + 1;
+    uint32_t seed = 12345;
+
+    for (uint32_t k = 0; k < CAB_IR_TAPS; k++) {
+        seed = seed * 196314165u + 907633515u;
+        bench_cab_taps[k] = (float)(int32_t)seed * (1.0f / 2147483648.0f) * expf(-4.0f * (float)k / CAB_IR_TAPS);
+    }
+    if (!CabIR_Init(ir, spectra, part, bench_cab_taps, CAB_IR_TAPS, 1.0f)) return;
+    CabSim_Init(cab, ir, mem);
+
+    float max_err = 0.0f;
+    uint32_t worst = 0;
+    for (uint32_t b = 0; b < blocks; b++) {
+        for (uint32_t i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            uint32_t n = b * BLOCK_SIZE_FLOAT + i;
+            r_buf_in[i] = (n == 0) ? 1.0f : (n == d) ? 0.5f : 0.0f;
+        }
+        uint32_t start = DSP_Bench_Start();
+        CabSim_ProcessBlock(cab, r_buf_in, r_buf_out, BLOCK_SIZE_FLOAT);
+        uint32_t cycles = DSP_Bench_Start() - start;
+        if (cycles > worst) worst = cycles;
+        for (uint32_t i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            int32_t n = (int32_t)(b * BLOCK_SIZE_FLOAT + i) - (int32_t)latency;
+            float ref = 0.0f;
+            if (n >= 0 && n < CAB_IR_TAPS) ref += bench_cab_taps[n];
+            if (n >= (int32_t)d && n - (int32_t)d < CAB_IR_TAPS) ref += 0.5f * bench_cab_taps[n - d];
+            float err = fabsf(r_buf_out[i] - ref);
+            if (err > max_err) max_err = err;
+        }
+    }
+
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    CabSim_Reset(cab);
+    uint32_t start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        CabSim_ProcessBlock(cab, l_buf_in, l_buf_out, BLOCK_SIZE_FLOAT);
+    }
+    DSP_Bench_Report(name, start, DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT);
+    SEGGER_SYSVIEW_PrintfHost("BENCH %s: worst block %u cycles, max err vs direct %u e-9",
+                              name, worst, (uint32_t)(max_err * 1e9f));
+}
+
+/*Cabinet (CAB_IR_TAPS) at the partition sizes whose channel fits 'mem'*/
+void FX_Bench_Cab(CabIR_t* ir, CabSim_t* cab, float* spectra, float* mem, uint32_t size)
+{
+    static const struct { const char* name; uint32_t part; } cab_cfg[] = {
+        {"cab P64", 64}, {"cab P128", 128}, {"cab P256", 256}, {"cab P512", 512},
+    };
+    for (uint32_t c = 0; c < sizeof(cab_cfg) / sizeof(cab_cfg[0]); c++) {
+        if (CAB_CHANNEL_SIZE(CAB_IR_TAPS, cab_cfg[c].part) <= size) {
+            bench_cab(ir, cab, spectra, mem, cab_cfg[c].name, cab_cfg[c].part);
+        }
+    }
+}
+#endif // CAB_ENABLE
+
+#ifdef CONVREV_ENABLE
+/*Convolution reverb with the full CONVREV_IR_TAPS IR and the idle loop emulated by draining
+the background after every block: foreground cycles per block (average, worst), the largest
+single background item (what a pending block may wait for), the worst background total of a
+block, overruns and the max error against h[n] + 0.5 h[n - d].*/
+void FX_Bench_ConvReverb(ConvReverb_t* cr, float* pool)
+{
+    const uint32_t d = 1237;
+    const uint32_t blocks = (CONVREV_IR_TAPS + d) / BLOCK_SIZE_FLOAT + 1;
+    float* h = &pool[CONVREV_MEM_SIZE(CONVREV_IR_TAPS)];
+
+    ConvReverb_GenerateIR(h, CONVREV_IR_TAPS, CONVREV_RT60, 0.5f);
+    if (!ConvReverb_Init(cr, pool, CONVREV_MEM_SIZE(CONVREV_IR_TAPS), h, CONVREV_IR_TAPS, 1.0f)) return;
+
+    float max_err = 0.0f;
+    uint32_t fg_worst = 0, fg_total = 0, item_worst = 0, bg_worst = 0;
+    for (uint32_t b = 0; b < blocks; b++) {
+        for (uint32_t i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            uint32_t n = b * BLOCK_SIZE_FLOAT + i;
+            l_buf_out[i] = r_buf_out[i] = (n == 0) ? 1.0f : (n == d) ? 0.5f : 0.0f;
+        }
+        uint32_t start = DSP_Bench_Start();
+        ConvReverb_ProcessBlock(cr, l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT);
+        uint32_t cycles = DSP_Bench_Start() - start;
+        fg_total += cycles;
+        if (cycles > fg_worst) fg_worst = cycles;
+
+        uint32_t bg = 0;
+        for (;;) {
+            start = DSP_Bench_Start();
+            uint8_t busy = ConvReverb_Background(cr);
+            cycles = DSP_Bench_Start() - start;
+            if (!busy) break;
+            bg += cycles;
+            if (cycles > item_worst) item_worst = cycles;
+        }
+        if (bg > bg_worst) bg_worst = bg;
+
+        for (uint32_t i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+            uint32_t n = b * BLOCK_SIZE_FLOAT + i;
+            float ref = 0.0f;
+            if (n < CONVREV_IR_TAPS) ref += h[n];
+            if (n >= d && n - d < CONVREV_IR_TAPS) ref += 0.5f * h[n - d];
+            float err = fabsf(l_buf_out[i] - ref);
+            if (err > max_err) max_err = err;
+        }
+    }
+
+    SEGGER_SYSVIEW_PrintfHost("BENCH convrev %u taps: block avg %u worst %u cycles, bg item worst %u, bg block worst %u",
+                              CONVREV_IR_TAPS, fg_total / blocks, fg_worst, item_worst, bg_worst);
+    SEGGER_SYSVIEW_PrintfHost("BENCH convrev: %u overruns, max err vs direct %u e-9",
+                              ConvReverb_Overruns(cr), (uint32_t)(max_err * 1e9f));
+}
+#endif // CONVREV_ENABLE
+
+#ifdef TUNER_ENABLE
+/*Tuner: the audio side (the ring copy, cycles/frame), the largest idle step and the worst
+error over the open strings of a guitar, plain saw tones between which the idle loop is
+drained after every block as on the target.*/
+void FX_Bench_Tuner(Tuner_t* tuner)
+{
+    static const float strings[] = {82.41f, 110.0f, 146.83f, 196.0f, 246.94f, 329.63f};
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    const uint32_t blocks = (TUNER_RING + TUNER_HOP) / BLOCK_SIZE_FLOAT;
+
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    Tuner_Init(tuner, 440.0f, TUNER_MIN_DB);
+    uint32_t start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        Tuner_Push(tuner, l_buf_in, BLOCK_SIZE_FLOAT);
+    }
+    DSP_Bench_Report("tuner push", start, frames);
+
+    uint32_t step_worst = 0, misses = 0;
+    int32_t err_worst = 0;
+    for (uint32_t s = 0; s < sizeof(strings) / sizeof(strings[0]); s++) {
+        Tuner_Init(tuner, 440.0f, TUNER_MIN_DB);
+        float phase = 0.0f;
+        const float inc = strings[s] / (float)SAMPLE_RATE;
+        for (uint32_t b = 0; b < blocks; b++) {
+            for (uint32_t i = 0; i < BLOCK_SIZE_FLOAT; i++) {
+                l_buf_out[i] = 0.5f * (2.0f * phase - 1.0f);
+                phase += inc;
+                if (phase >= 1.0f) phase -= 1.0f;
+            }
+            Tuner_Push(tuner, l_buf_out, BLOCK_SIZE_FLOAT);
+            for (;;) {
+                start = DSP_Bench_Start();
+                uint8_t busy = Tuner_Background(tuner);
+                uint32_t cycles = DSP_Bench_Start() - start;
+                if (!busy) break;
+                if (cycles > step_worst) step_worst = cycles;
+            }
+        }
+        const Tuner_Result_t* res = Tuner_GetResult(tuner);
+        if (!res->valid) {
+            misses++;
+            continue;
+        }
+        int32_t err = (int32_t)lrintf(1200.0f * log2f(res->hz / strings[s]) * 100.0f);
+        if ((err < 0 ? -err : err) > (err_worst < 0 ? -err_worst : err_worst)) err_worst = err;
+    }
+
+    SEGGER_SYSVIEW_PrintfHost("BENCH tuner: idle step worst %u cycles, block period %u",
+                              step_worst, 180000000u / SAMPLE_RATE * BLOCK_SIZE_FLOAT);
+    SEGGER_SYSVIEW_PrintfHost("BENCH tuner: open strings worst %s%u.%02u cents, %u missed",
+                              BENCH_X100(err_worst), misses);
+}
+#endif // TUNER_ENABLE
+
+#ifdef HARMONIZER_ENABLE
+/*Harmonizer with 1..HARM_MAX_VOICES voices: cost per voice from the slope, the line write
+and the dry mix cancel out of it. Then one voice an octave up on a 375 Hz sine (128 samples
+a period, so both tones sit on whole cycles of the window): its level at 750 Hz and what
+is left at 375 Hz, against the input.*/
+void FX_Bench_Harmonizer(Harmonizer_t* harm)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    const uint32_t budget = 180000000u / SAMPLE_RATE;
+    uint32_t cost[HARM_MAX_VOICES + 1];
+    static const char* const harm_names[HARM_MAX_VOICES + 1] = {
+        "harm 0 voices", "harm 1 voice", "harm 2 voices", "harm 3 voices", "harm 4 voices",
+    };
+
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    for (uint32_t v = 0; v <= HARM_MAX_VOICES; v++) {
+        Harmonizer_Init(harm, 1.0f);
+        for (uint32_t k = 0; k < v; k++) {
+            Harmonizer_SetVoice(harm, k, -12.0f + 7.0f * (float)k, 0.5f, 0.0f);
+        }
+        uint32_t start = DSP_Bench_Start();
+        for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+            memcpy(l_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+            memcpy(r_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+            Harmonizer_ProcessBlock(harm, l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT);
+        }
+        cost[v] = DSP_Bench_Report(harm_names[v], start, frames);
+    }
+    uint32_t per_voice = (cost[HARM_MAX_VOICES] - cost[0]) / HARM_MAX_VOICES;
+    SEGGER_SYSVIEW_PrintfHost("BENCH harm: %u.%02u cycles/frame per voice, %u voices %u.%u%% of %u",
+                              per_voice / 100u, per_voice % 100u, HARM_MAX_VOICES,
+                              cost[HARM_MAX_VOICES] / budget, (cost[HARM_MAX_VOICES] * 10u / budget) % 10u, budget);
+
+    // The grain rate spreads the voice into sidebands around 750 Hz: its level is the whole
+    // output, the single bin only shows what was not shifted. 3840 samples hold whole cycles
+    DSP_Goertzel_t in, left;
+    DSP_Goertzel_Init(&in, 375.0f);
+    DSP_Goertzel_Init(&left, 375.0f);
+    Harmonizer_Init(harm, 0.0f);
+    Harmonizer_SetVoice(harm, 0, 12.0f, 1.0f, 0.0f);
+    float p_out = DSP_Bench_Tone(harm_run, harm, 375.0f, 0.25f, 4800, 3840, &in, &left, 1);
+    // Centre pan: each side carries the voice at -3 dB
+    const float p_in = 0.25f * 0.25f * 0.5f;
+    int32_t level = (int32_t)lrintf(100.0f * log10f(2.0f * p_out / p_in + 1e-20f));
+    int32_t res = (int32_t)lrintf(100.0f * log10f(DSP_Goertzel_Power(&left) / DSP_Goertzel_Power(&in) * 2.0f + 1e-20f));
+    SEGGER_SYSVIEW_PrintfHost("BENCH harm: +12 on 375 Hz, voice level %d.%u dB, 375 Hz left %d.%u dB",
+                              level / 10, (uint32_t)(level < 0 ? -level : level) % 10u,
+                              res / 10, (uint32_t)(res < 0 ? -res : res) % 10u);
+}
+#endif // HARMONIZER_ENABLE
+
+#ifdef MOD_ENABLE
+/*The full modulation matrix (every LFO, both envelopes fed, every route and destination)
+once per block*/
+void FX_Bench_ModMatrix(void)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    static Mod_t bench_mod;
+
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    Mod_Init(&bench_mod, (float)SAMPLE_RATE);
+    for (uint32_t k = 0; k < MOD_MAX_LFOS; k++) {
+        Mod_SetLFO(&bench_mod, k, (Mod_Shape_t)(k % 4u), 0.5f + (float)k, 0.0f);
+    }
+    for (uint32_t k = 0; k < MOD_MAX_ENVS; k++) {
+        Mod_SetEnvelope(&bench_mod, k, 5.0f, 150.0f, -60.0f);
+    }
+    for (uint32_t d = 0; d < MOD_MAX_DESTS; d++) {
+        Mod_SetDest(&bench_mod, d, 0.5f, 0.0f, 1.0f, MOD_SMOOTH_MS);
+    }
+    for (uint32_t i = 0; i < MOD_MAX_ROUTES; i++) {
+        Mod_Route(&bench_mod, i % MOD_SOURCES, (i * 3u) % MOD_MAX_DESTS, 0.1f);
+    }
+    uint32_t start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        for (uint32_t k = 0; k < MOD_MAX_ENVS; k++) {
+            Mod_FeedEnvelope(&bench_mod, k, l_buf_in, l_buf_in, BLOCK_SIZE_FLOAT);
+        }
+        Mod_Update(&bench_mod, BLOCK_SIZE_FLOAT);
+    }
+    uint32_t matrix = DSP_Bench_Report("mod matrix", start, frames);
+    SEGGER_SYSVIEW_PrintfHost("BENCH mod matrix: %u LFOs, %u envelopes, %u routes, %u dests, %u cycles/block",
+                              MOD_MAX_LFOS, MOD_MAX_ENVS, bench_mod.routes, bench_mod.dests,
+                              matrix * BLOCK_SIZE_FLOAT / 100u);
+}
+#endif // MOD_ENABLE
+
+#if defined(PHASER_ENABLE) || defined(AUTOWAH_ENABLE)
+/*Swept filters: Fast_Tan against tanf over the prewarp range, the phaser's allpass chain
+per stage from the slope over 4..TPT_MAX_STAGES stages (stereo, coefficients per block),
+the auto-wah per frame, and the wah's band pass gain at its centre (0 dB expected).*/
+void FX_Bench_Swept(void)
+{
+    const uint32_t frames = DSP_BENCH_BLOCKS * BLOCK_SIZE_FLOAT;
+    static Phaser_t bench_ph;
+    static AutoWah_t bench_wah;
+    volatile float sink = 0.0f;
+    float max_err = 0.0f;
+    uint32_t start;
+
+    DSP_Bench_FillInput(l_buf_in, BLOCK_SIZE_FLOAT);
+    start = DSP_Bench_Start();
+    for (uint32_t k = 0; k < frames; k++) {
+        sink += tanf(1.45f * (float)(k & 1023u) / 1024.0f);
+    }
+    DSP_Bench_Report("tanf", start, frames);
+    start = DSP_Bench_Start();
+    for (uint32_t k = 0; k < frames; k++) {
+        sink += Fast_Tan(1.45f * (float)(k & 1023u) / 1024.0f);
+    }
+    DSP_Bench_Report("Fast_Tan", start, frames);
+    for (uint32_t k = 1; k <= 1024u; k++) {
+        float x = 1.45f * (float)k / 1024.0f;
+        float err = fabsf(Fast_Tan(x) / tanf(x) - 1.0f);
+        if (err > max_err) max_err = err;
+    }
+    SEGGER_SYSVIEW_PrintfHost("BENCH Fast_Tan: max relative error %u e-6 up to 0.46 fs", (uint32_t)(max_err * 1e6f));
+
+    uint32_t cost[2];
+    for (uint32_t c = 0; c < 2; c++) {
+        uint32_t stages = c == 0 ? 4 : TPT_MAX_STAGES;
+        Phaser_Init(&bench_ph, (float)SAMPLE_RATE, stages, 200.0f, 2500.0f, 0.5f, 0.5f);
+        start = DSP_Bench_Start();
+        for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+            float pos = (float)(b & 63u) / 64.0f;
+            memcpy(l_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+            memcpy(r_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+            Phaser_ProcessBlock(&bench_ph, l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT, pos, 1.0f - pos);
+        }
+        cost[c] = DSP_Bench_Report(c == 0 ? "phaser 4 stages" : "phaser max stages", start, frames);
+    }
+    uint32_t per_stage = (cost[1] - cost[0]) / (TPT_MAX_STAGES - 4);
+    SEGGER_SYSVIEW_PrintfHost("BENCH phaser: %u.%02u cycles/frame per stage (stereo), %u stages %u.%02u",
+                              per_stage / 100u, per_stage % 100u, TPT_MAX_STAGES, cost[1] / 100u, cost[1] % 100u);
+
+    AutoWah_Init(&bench_wah, (float)SAMPLE_RATE, 350.0f, 2200.0f, 4.0f, 1.0f);
+    start = DSP_Bench_Start();
+    for (uint32_t b = 0; b < DSP_BENCH_BLOCKS; b++) {
+        memcpy(l_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+        memcpy(r_buf_out, l_buf_in, BLOCK_SIZE_FLOAT * sizeof(float));
+        AutoWah_ProcessBlock(&bench_wah, l_buf_out, r_buf_out, BLOCK_SIZE_FLOAT, (float)(b & 63u) / 64.0f);
+    }
+    DSP_Bench_Report("autowah", start, frames);
+
+    // Centre at the middle of the sweep, sqrt(350 * 2200) Hz
+    const float hz = sqrtf(350.0f * 2200.0f);
+    DSP_Goertzel_t in, out;
+    DSP_Goertzel_Init(&in, hz);
+    DSP_Goertzel_Init(&out, hz);
+    AutoWah_Init(&bench_wah, (float)SAMPLE_RATE, 350.0f, 2200.0f, 4.0f, 1.0f);
+    DSP_Bench_Tone(wah_centre, &bench_wah, hz, 0.25f, 4800, 4800, &in, &out, 1);
+    int32_t at = (int32_t)lrintf(1000.0f * log10f(DSP_Goertzel_Power(&out) / DSP_Goertzel_Power(&in) + 1e-20f)); // x100
+    SEGGER_SYSVIEW_PrintfHost("BENCH autowah: gain at the centre %s%u.%02u dB", BENCH_X100(at));
+    (void)sink;
+}
+#endif // PHASER_ENABLE || AUTOWAH_ENABLE
+
+#endif // DSP_BENCH_ENABLE
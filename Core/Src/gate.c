@@ -0,0 +1,97 @@
+#include "gate.h"
+#include "arm_math.h"
+#include <string.h>
+#include <math.h>
+
+// Gain change per block for a full ramp over 'ms', a step of 1 under one block
+static float block_step(float ms, float sample_rate) {
+    float blocks = ms * 0.001f * sample_rate / (float)BLOCK_SIZE_FLOAT;
+    return blocks > 1.0f ? 1.0f / blocks : 1.0f;
+}
+
+static float block_power(const float* l, const float* r, uint32_t n) {
+    float pl, pr;
+    arm_power_f32(l, n, &pl);
+    arm_power_f32(r, n, &pr);
+    return (pl + pr) / (float)(2 * n);
+}
+
+void Gate_Init(Gate_t* g, float sample_rate, float open_dB, float hysteresis_dB,
+               float hold_ms, float attack_ms, float release_ms) {
+    memset(g, 0, sizeof(Gate_t));
+    g->state = GATE_CLOSED;
+    g->openLevel = powf(10.0f, open_dB / 10.0f);
+    g->closeLevel = powf(10.0f, (open_dB - hysteresis_dB) / 10.0f);
+    g->holdBlocks = (uint32_t)(hold_ms * 0.001f * sample_rate / (float)BLOCK_SIZE_FLOAT + 0.5f);
+    g->attackStep = block_step(attack_ms, sample_rate);
+    g->releaseStep = block_step(release_ms, sample_rate);
+    g->gain = 0.0f;
+}
+
+void Gate_SetTail(Gate_t* g, float sample_rate, float silence_dB, float tail_ms) {
+    g->silenceLevel = powf(10.0f, silence_dB / 10.0f);
+    g->tailBlocks = (uint32_t)(tail_ms * 0.001f * sample_rate / (float)BLOCK_SIZE_FLOAT + 0.5f);
+    g->quietCount = 0;
+    g->idle = 0;
+}
+
+void Gate_ProcessBlock(Gate_t* g, float* l, float* r, uint32_t n) {
+    float level = block_power(l, r, n);
+
+    if (level > g->openLevel) {
+        g->state = GATE_OPEN;
+        g->holdCount = g->holdBlocks;
+        g->idle = 0;
+        g->quietCount = 0;
+    } else if (g->state == GATE_OPEN || g->state == GATE_HOLD) {
+        if (level >= g->closeLevel) {
+            g->holdCount = g->holdBlocks;
+        } else if (g->holdCount > 0) {
+            g->holdCount--;
+            g->state = GATE_HOLD;
+        } else {
+            g->state = GATE_RELEASE;
+        }
+    }
+
+    float g0 = g->gain;
+    float g1 = g0;
+    if (g->state == GATE_RELEASE) {
+        g1 = g0 - g->releaseStep;
+        if (g1 <= 0.0f) {
+            g1 = 0.0f;
+            g->state = GATE_CLOSED;
+        }
+    } else if (g->state != GATE_CLOSED) {
+        g1 = g0 + g->attackStep;
+        if (g1 > 1.0f) g1 = 1.0f;
+    }
+    g->gain = g1;
+
+    if (g0 == 1.0f && g1 == 1.0f) return;
+    if (g0 == 0.0f && g1 == 0.0f) {
+        memset(l, 0, n * sizeof(float));
+        memset(r, 0, n * sizeof(float));
+        return;
+    }
+    const float step = (g1 - g0) / (float)n;
+    float gi = g0;
+    for (uint32_t i = 0; i < n; i++) {
+        gi += step;
+        l[i] *= gi;
+        r[i] *= gi;
+    }
+}
+
+void Gate_WatchTail(Gate_t* g, const float* l, const float* r, uint32_t n) {
+    if (g->state != GATE_CLOSED) {
+        g->quietCount = 0;
+        return;
+    }
+    if (block_power(l, r, n) < g->silenceLevel) {
+        if (g->quietCount < g->tailBlocks) g->quietCount++;
+        if (g->quietCount >= g->tailBlocks) g->idle = 1;
+    } else {
+        g->quietCount = 0;
+    }
+}
@@ -0,0 +1,73 @@
+#include "halfband.h"
+#include "kaiser.h"
+#include <string.h>
+
+// Shared work buffer: history followed by the new block (audio runs single threaded)
+static float hb_work[4 * HB_MAX_K + 2 * HB_MAX_BLOCK];
+
+void HalfBand_Init(HalfBand_t* hb, uint32_t K, float kaiser_beta) {
+    if (K > HB_MAX_K) K = HB_MAX_K;
+    if (K < 1) K = 1;
+    hb->K = K;
+
+    float sum = 0.0f;
+    for (uint32_t j = 0; j < K; j++) {
+        hb->g[j] = Kaiser_Sinc((float)(2 * j + 1), 0.5f, (float)(2 * K), kaiser_beta);
+        sum += hb->g[j];
+    }
+    // Unity DC gain: 0.5 + 2 * sum(g) = 1
+    for (uint32_t j = 0; j < K; j++) {
+        hb->g[j] *= 0.25f / sum;
+    }
+    HalfBand_Reset(hb);
+}
+
+void HalfBand_Reset(HalfBand_t* hb) {
+    memset(hb->hist, 0, sizeof(hb->hist));
+}
+
+void HalfBand_Up(HalfBand_t* hb, const float* in, float* out, uint32_t n) {
+    const uint32_t K = hb->K;
+    const uint32_t H = 2 * K;
+    float* x = hb_work;
+
+    memcpy(x, hb->hist, H * sizeof(float));
+    memcpy(x + H, in, n * sizeof(float));
+
+    for (uint32_t m = 0; m < n; m++) {
+        // FIR phase: taps around x[m+K]..x[m+K+1], centre phase is a pure delay
+        const float* a = &x[m + K + 1];
+        const float* b = &x[m + K];
+        float acc = 0.0f;
+        for (uint32_t j = 0; j < K; j++) {
+            acc += hb->g[j] * (a[j] + b[-(int32_t)j]);
+        }
+        out[2 * m] = 2.0f * acc;
+        out[2 * m + 1] = x[m + K + 1];
+    }
+
+    memcpy(hb->hist, x + n, H * sizeof(float));
+}
+
+void HalfBand_Down(HalfBand_t* hb, const float* in, float* out, uint32_t n) {
+    const uint32_t K = hb->K;
+    const uint32_t H = 4 * K - 2;
+    const uint32_t c = 2 * K - 1;
+    float* v = hb_work;
+
+    memcpy(v, hb->hist, H * sizeof(float));
+    memcpy(v + H, in, 2 * n * sizeof(float));
+
+    for (uint32_t m = 0; m < n; m++) {
+        // Filter evaluated at every second input only, zero taps skipped
+        const float* centre = &v[H + 2 * m + 1 - c];
+        float acc = 0.5f * centre[0];
+        for (uint32_t j = 0; j < K; j++) {
+            int32_t k = (int32_t)(2 * j + 1);
+            acc += hb->g[j] * (centre[k] + centre[-k]);
+        }
+        out[m] = acc;
+    }
+
+    memcpy(hb->hist, v + 2 * n, H * sizeof(float));
+}
@@ -0,0 +1,75 @@
+#include "harmonizer.h"
+#include "pitch_shift.h"
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void Harmonizer_Init(Harmonizer_t* h, float dry) {
+    memset(h, 0, sizeof(Harmonizer_t));
+    h->dry = dry;
+}
+
+void Harmonizer_SetVoice(Harmonizer_t* h, uint32_t v, float semitones, float level, float pan) {
+    if (v >= HARM_MAX_VOICES) return;
+    if (semitones < -12.0f) semitones = -12.0f;
+    if (semitones > 12.0f) semitones = 12.0f;
+    if (pan < -1.0f) pan = -1.0f;
+    if (pan > 1.0f) pan = 1.0f;
+
+    Harmonizer_Voice_t* vo = &h->voice[v];
+    float ratio = powf(2.0f, semitones / 12.0f);
+    vo->inc = PitchShift_Inc(ratio, (float)HARM_GRAIN);
+    float a = 0.25f * (float)M_PI * (pan + 1.0f);
+    vo->gainL = level * cosf(a);
+    vo->gainR = level * sinf(a);
+    if (v >= h->voices) h->voices = v + 1;
+}
+
+void Harmonizer_SetVoices(Harmonizer_t* h, uint32_t voices) {
+    h->voices = voices > HARM_MAX_VOICES ? HARM_MAX_VOICES : voices;
+}
+
+void Harmonizer_ProcessBlock(Harmonizer_t* h, float* l, float* r, uint32_t n) {
+    float* wl = h->wetL;
+    float* wr = h->wetR;
+    const uint32_t w0 = h->pos;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t p = w0 + i;
+        if (p >= HARM_LINE) p -= HARM_LINE;
+        h->line[p] = 0.5f * (l[i] + r[i]);
+    }
+    h->pos = (w0 + n) % HARM_LINE;
+    memset(wl, 0, n * sizeof(float));
+    memset(wr, 0, n * sizeof(float));
+
+    // Sample i sits at w0 + i: reading from one past it, HARM_LINE - 1 - d is d samples older
+    const float scale = (float)HARM_GRAIN * (1.0f / 4294967296.0f);
+    const float newest = (float)(HARM_LINE - 1);
+    for (uint32_t v = 0; v < h->voices; v++) {
+        Harmonizer_Voice_t* vo = &h->voice[v];
+        const float gl = vo->gainL, gr = vo->gainR;
+        const uint32_t inc = (uint32_t)vo->inc;
+        uint32_t phase = vo->phase;
+        uint32_t p = w0 + 1;
+        if (p >= HARM_LINE) p -= HARM_LINE;
+
+        for (uint32_t i = 0; i < n; i++) {
+            float s = PitchShift_Read(h->line, HARM_LINE, p, newest, scale, phase);
+            wl[i] += gl * s;
+            wr[i] += gr * s;
+            phase += inc;
+            if (++p == HARM_LINE) p = 0;
+        }
+        vo->phase = phase;
+    }
+
+    const float dry = h->dry;
+    for (uint32_t i = 0; i < n; i++) {
+        l[i] = dry * l[i] + wl[i];
+        r[i] = dry * r[i] + wr[i];
+    }
+}
@@ -0,0 +1,26 @@
+#include "kaiser.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Zeroth order modified Bessel function, series expansion
+static float bessel_i0(float x) {
+    float sum = 1.0f, term = 1.0f;
+    for (int k = 1; k < 32; k++) {
+        float t = x / (2.0f * k);
+        term *= t * t;
+        sum += term;
+        if (term < sum * 1e-9f) break;
+    }
+    return sum;
+}
+
+float Kaiser_Sinc(float d, float fc, float half, float beta) {
+    float r = d / half;
+    float w = bessel_i0(beta * sqrtf(fmaxf(0.0f, 1.0f - r * r))) / bessel_i0(beta);
+    if (d == 0.0f) return w;
+    float x = (float)M_PI * fc * d;
+    return sinf(x) / x * w;
+}
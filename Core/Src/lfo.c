@@ -0,0 +1,10 @@
+#include "lfo.h"
+#include <math.h>
+
+float lfo_sine_table[LFO_TABLE_SIZE + 1];
+
+void LFO_InitTable(void) {
+    for (uint32_t i = 0; i <= LFO_TABLE_SIZE; i++) {
+        lfo_sine_table[i] = sinf(6.28318531f * (float)i / (float)LFO_TABLE_SIZE);
+    }
+}
@@ -0,0 +1,249 @@
+#include "looper.h"
+#include <string.h>
+
+// ---------- Memory-mapped pool ----------
+
+static void mem_read(void* ctx, uint32_t offset, float* dst, uint32_t count) {
+    memcpy(dst, (float*)ctx + offset, count * sizeof(float));
+}
+
+static void mem_write(void* ctx, uint32_t offset, const float* src, uint32_t count) {
+    memcpy((float*)ctx + offset, src, count * sizeof(float));
+}
+
+void Looper_PoolFromMemory(Looper_Pool_t* pool, float* mem, uint32_t size) {
+    pool->read = mem_read;
+    pool->write = mem_write;
+    pool->ctx = mem;
+    pool->size = size;
+}
+
+// ---------- Block streaming ----------
+
+static inline uint32_t wrap_block(Looper_t* lp, uint32_t b) {
+    return (b >= lp->loopBlocks) ? b - lp->loopBlocks : b;
+}
+
+// Block b was undone but not yet copied back from the undo region
+static uint8_t restore_pending(Looper_t* lp, uint32_t b) {
+    if (lp->restoreDone >= lp->restoreLen) return 0;
+    uint32_t rel = b + lp->loopBlocks - lp->restoreStart;
+    if (rel >= lp->loopBlocks) rel -= lp->loopBlocks;
+    return (rel >= lp->restoreDone) && (rel < lp->restoreLen);
+}
+
+static void fetch_block(Looper_t* lp, uint32_t b, float* dst) {
+    uint32_t base = restore_pending(lp, b) ? lp->undoOffset : 0;
+    lp->pool.read(lp->pool.ctx, base + b * LOOPER_BLOCK, dst, LOOPER_BLOCK);
+}
+
+// Copy a few undone blocks back into the loop region per call
+static void restore_step(Looper_t* lp) {
+    for (uint32_t k = 0; k < LOOPER_RESTORE_BLOCKS && lp->restoreDone < lp->restoreLen; k++) {
+        uint32_t off = wrap_block(lp, lp->restoreStart + lp->restoreDone) * LOOPER_BLOCK;
+        lp->pool.read(lp->pool.ctx, lp->undoOffset + off, lp->scratch, LOOPER_BLOCK);
+        lp->pool.write(lp->pool.ctx, off, lp->scratch, LOOPER_BLOCK);
+        lp->restoreDone++;
+    }
+}
+
+static void swap_buffers(Looper_t* lp) {
+    float* tmp = lp->cur;
+    lp->cur = lp->next;
+    lp->next = tmp;
+}
+
+// Restart playback at block 0 with block 1 already prefetched
+static void rewind(Looper_t* lp) {
+    lp->blockIdx = 0;
+    lp->pos = 0;
+    fetch_block(lp, 0, lp->cur);
+    fetch_block(lp, 1, lp->next);
+}
+
+static void close_recording(Looper_t* lp) {
+    lp->loopBlocks = lp->blockIdx;
+    lp->blockIdx = 0;
+    lp->pos = 0;
+    // next holds a copy of block 0 taken at its flush, no read needed
+    swap_buffers(lp);
+    fetch_block(lp, 1, lp->next);
+    lp->state = LOOPER_PLAY;
+}
+
+static void finish_block(Looper_t* lp) {
+    uint32_t off = lp->blockIdx * LOOPER_BLOCK;
+
+    if (lp->dirty) {
+        if (lp->state == LOOPER_OVERDUB && lp->layerLen < lp->loopBlocks) {
+            // Keep the previous layer for undo, blocks are backed up in playback order
+            lp->pool.write(lp->pool.ctx, lp->undoOffset + off, lp->cur, LOOPER_BLOCK);
+            lp->layerLen++;
+        }
+        for (uint32_t i = 0; i < LOOPER_BLOCK; i++) {
+            lp->acc[i] += lp->cur[i];
+        }
+        lp->pool.write(lp->pool.ctx, off, lp->acc, LOOPER_BLOCK);
+        if (lp->state == LOOPER_RECORD && lp->blockIdx == 0) {
+            memcpy(lp->next, lp->acc, sizeof(lp->acc));
+        }
+        memset(lp->acc, 0, sizeof(lp->acc));
+        lp->dirty = 0;
+    }
+
+    if (lp->state == LOOPER_RECORD) {
+        lp->blockIdx++;
+        if (lp->blockIdx >= lp->maxBlocks) {
+            close_recording(lp); // pool full
+        }
+        return;
+    }
+
+    lp->blockIdx = wrap_block(lp, lp->blockIdx + 1);
+    swap_buffers(lp);
+    fetch_block(lp, wrap_block(lp, lp->blockIdx + 1), lp->next);
+}
+
+// ---------- Transport ----------
+
+static void clear(Looper_t* lp) {
+    lp->state = LOOPER_EMPTY;
+    lp->loopBlocks = 0;
+    lp->blockIdx = 0;
+    lp->pos = 0;
+    lp->dirty = 0;
+    lp->layerStart = lp->layerLen = 0;
+    lp->restoreStart = lp->restoreLen = lp->restoreDone = 0;
+    memset(lp->bufA, 0, sizeof(lp->bufA));
+    memset(lp->bufB, 0, sizeof(lp->bufB));
+    memset(lp->acc, 0, sizeof(lp->acc));
+}
+
+// Applied on loop block boundaries only; returns 0 to keep the command pending
+static uint8_t apply_command(Looper_t* lp, Looper_Cmd_t cmd) {
+    uint8_t restoring = lp->restoreDone < lp->restoreLen;
+
+    switch (cmd) {
+        case LOOPER_CMD_CLEAR:
+            clear(lp);
+            break;
+        case LOOPER_CMD_RECORD:
+            if (lp->state == LOOPER_EMPTY) {
+                lp->state = LOOPER_RECORD;
+                lp->blockIdx = 0;
+                memset(lp->cur, 0, LOOPER_BLOCK * sizeof(float));
+                break;
+            }
+            if (lp->state == LOOPER_RECORD) {
+                if (lp->blockIdx < LOOPER_MIN_BLOCKS) return 0;
+                close_recording(lp);
+            }
+            if (restoring) return 0; // overdub would race the undo restore
+            lp->state = LOOPER_OVERDUB;
+            lp->layerStart = lp->blockIdx;
+            lp->layerLen = 0;
+            break;
+        case LOOPER_CMD_PLAY:
+            if (lp->state == LOOPER_RECORD) {
+                if (lp->blockIdx < LOOPER_MIN_BLOCKS) return 0;
+                close_recording(lp);
+            } else if (lp->state == LOOPER_STOP || lp->state == LOOPER_OVERDUB) {
+                lp->state = LOOPER_PLAY; // a stopped loop is already rewound
+            }
+            break;
+        case LOOPER_CMD_STOP:
+            if (lp->state == LOOPER_RECORD) {
+                if (lp->blockIdx < LOOPER_MIN_BLOCKS) return 0;
+                close_recording(lp);
+            }
+            if (lp->state != LOOPER_EMPTY) {
+                lp->state = LOOPER_STOP;
+                rewind(lp); // prefetch the restart now, not on PLAY
+            }
+            break;
+        case LOOPER_CMD_UNDO:
+            if (lp->state == LOOPER_OVERDUB) {
+                lp->state = LOOPER_PLAY;
+            }
+            if (lp->layerLen == 0 || restoring) break;
+            lp->restoreStart = lp->layerStart;
+            lp->restoreLen = lp->layerLen;
+            lp->restoreDone = 0;
+            lp->layerLen = 0;
+            if (lp->state == LOOPER_PLAY) {
+                // Re-read the two buffered blocks so the undo is heard right away
+                fetch_block(lp, lp->blockIdx, lp->cur);
+                fetch_block(lp, wrap_block(lp, lp->blockIdx + 1), lp->next);
+            } else if (lp->state == LOOPER_STOP) {
+                rewind(lp);
+            }
+            break;
+        default:
+            break;
+    }
+    return 1;
+}
+
+// ---------- API ----------
+
+void Looper_Init(Looper_t* lp, const Looper_Pool_t* pool, float level) {
+    lp->pool = *pool;
+    lp->maxBlocks = (pool->size / 2) / LOOPER_BLOCK;
+    lp->undoOffset = lp->maxBlocks * LOOPER_BLOCK;
+    lp->pending = LOOPER_CMD_NONE;
+    lp->halfSpeed = 0;
+    lp->level = level;
+    lp->cur = lp->bufA;
+    lp->next = lp->bufB;
+    clear(lp);
+}
+
+void Looper_Command(Looper_t* lp, Looper_Cmd_t cmd) {
+    lp->pending = cmd;
+}
+
+void Looper_SetHalfSpeed(Looper_t* lp, uint8_t enable) {
+    lp->halfSpeed = enable;
+}
+
+void Looper_ProcessBlock(Looper_t* lp, float* l, float* r, uint32_t n) {
+    if (lp->pos == 0 && lp->pending != LOOPER_CMD_NONE) {
+        if (apply_command(lp, lp->pending)) {
+            lp->pending = LOOPER_CMD_NONE;
+        }
+    }
+    restore_step(lp);
+
+    if (lp->state == LOOPER_EMPTY || lp->state == LOOPER_STOP) {
+        return; // dry
+    }
+
+    // Half speed: every loop sample spans two output samples
+    const uint32_t step = lp->halfSpeed ? 1 : 2;
+    const float inGain = lp->halfSpeed ? 0.25f : 0.5f;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t idx = lp->pos >> 1;
+
+        if (lp->state == LOOPER_RECORD || lp->state == LOOPER_OVERDUB) {
+            lp->acc[idx] += (l[i] + r[i]) * inGain;
+            lp->dirty = 1;
+        }
+
+        if (lp->state != LOOPER_RECORD) {
+            float y = lp->cur[idx];
+            if (lp->pos & 1) {
+                float y1 = (idx + 1 < LOOPER_BLOCK) ? lp->cur[idx + 1] : lp->next[0];
+                y = 0.5f * (y + y1);
+            }
+            l[i] += lp->level * y;
+            r[i] += lp->level * y;
+        }
+
+        lp->pos += step;
+        if (lp->pos >= 2 * LOOPER_BLOCK) {
+            lp->pos = 0;
+            finish_block(lp);
+        }
+    }
+}
@@ -127,6 +127,7 @@ int main(void)
   while (1)
   {
     processAudio();
+    audio_Background();
   }
 	/* USER CODE END WHILE */
   /* USER CODE BEGIN 3 */
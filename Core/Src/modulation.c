@@ -0,0 +1,117 @@
+#include "modulation.h"
+#include "lfo.h"
+#include "fast_math.h"
+#include "arm_math.h"
+#include <string.h>
+#include <math.h>
+
+// One-pole coefficient for a time constant of 'ms' updated every 'frames' samples
+static float block_coeff(float ms, float sample_rate, float frames) {
+    if (ms <= 0.0f) return 1.0f;
+    return 1.0f - expf(-frames * 1000.0f / (ms * sample_rate));
+}
+
+void Mod_Init(Mod_t* m, float sample_rate) {
+    memset(m, 0, sizeof(Mod_t));
+    m->sample_rate = sample_rate;
+}
+
+void Mod_SetLFO(Mod_t* m, uint32_t k, Mod_Shape_t shape, float hz, float phase) {
+    if (k >= MOD_MAX_LFOS) return;
+    Mod_LFO_t* lfo = &m->lfo[k];
+    lfo->shape = shape;
+    lfo->inc = (uint32_t)(hz * (4294967296.0f / m->sample_rate));
+    lfo->phase = (uint32_t)((phase - floorf(phase)) * 4294967296.0f);
+}
+
+void Mod_SetEnvelope(Mod_t* m, uint32_t k, float attack_ms, float release_ms, float floor_dB) {
+    if (k >= MOD_MAX_ENVS) return;
+    Mod_Env_t* e = &m->env[k];
+    e->attack = block_coeff(attack_ms, m->sample_rate, (float)BLOCK_SIZE_FLOAT);
+    e->release = block_coeff(release_ms, m->sample_rate, (float)BLOCK_SIZE_FLOAT);
+    e->floor = floor_dB / (0.5f * FAST_DB_PER_LOG2); // power, so 3 dB per log2
+    e->level = e->floor;
+}
+
+void Mod_FeedEnvelope(Mod_t* m, uint32_t k, const float* l, const float* r, uint32_t n) {
+    Mod_Env_t* e = &m->env[k];
+    float pl, pr;
+    arm_power_f32(l, n, &pl);
+    arm_power_f32(r, n, &pr);
+    float x = Fast_Log2((pl + pr) / (float)(2 * n) + 1e-20f);
+    if (x < e->floor) x = e->floor;
+    e->level += (x > e->level ? e->attack : e->release) * (x - e->level);
+    float v = 1.0f - e->level / e->floor;
+    m->src[MOD_SRC_ENV(k)] = v > 1.0f ? 1.0f : v;
+}
+
+void Mod_SetDest(Mod_t* m, uint32_t d, float base, float min, float max, float smooth_ms) {
+    if (d >= MOD_MAX_DESTS) return;
+    Mod_Dest_t* dst = &m->dest[d];
+    dst->min = min;
+    dst->max = max;
+    dst->coeff = block_coeff(smooth_ms, m->sample_rate, (float)BLOCK_SIZE_FLOAT);
+    Mod_SetBase(m, d, base);
+    dst->target = dst->base;
+    dst->prev = dst->base;
+    dst->value = dst->base;
+    if (d >= m->dests) m->dests = d + 1;
+}
+
+void Mod_SetBase(Mod_t* m, uint32_t d, float base) {
+    Mod_Dest_t* dst = &m->dest[d];
+    if (base < dst->min) base = dst->min;
+    if (base > dst->max) base = dst->max;
+    dst->base = base;
+}
+
+uint8_t Mod_Route(Mod_t* m, uint32_t src, uint32_t dst, float depth) {
+    if (src >= MOD_SOURCES || dst >= MOD_MAX_DESTS) return 0;
+    for (uint32_t i = 0; i < m->routes; i++) {
+        if (m->route[i].src == src && m->route[i].dst == dst) {
+            m->route[i].depth = depth;
+            return 1;
+        }
+    }
+    if (m->routes == MOD_MAX_ROUTES) return 0;
+    m->route[m->routes].src = (uint8_t)src;
+    m->route[m->routes].dst = (uint8_t)dst;
+    m->route[m->routes].depth = depth;
+    m->routes++;
+    return 1;
+}
+
+static float lfo_shape(Mod_Shape_t shape, uint32_t phase) {
+    float p = (float)phase * (1.0f / 4294967296.0f);
+    switch (shape) {
+        case MOD_TRIANGLE: return 4.0f * fabsf(p - 0.5f) - 1.0f;
+        case MOD_SAW:      return 2.0f * p - 1.0f;
+        case MOD_SQUARE:   return p < 0.5f ? 1.0f : -1.0f;
+        case MOD_SINE:
+        default:           return LFO_SineAt(phase);
+    }
+}
+
+void Mod_Update(Mod_t* m, uint32_t n) {
+    for (uint32_t k = 0; k < MOD_MAX_LFOS; k++) {
+        Mod_LFO_t* lfo = &m->lfo[k];
+        lfo->phase += lfo->inc * n;
+        m->src[MOD_SRC_LFO(k)] = lfo_shape(lfo->shape, lfo->phase);
+    }
+
+    Mod_Dest_t* dest = m->dest;
+    for (uint32_t d = 0; d < m->dests; d++) {
+        dest[d].target = dest[d].base;
+    }
+    for (uint32_t i = 0; i < m->routes; i++) {
+        const Mod_Route_t* r = &m->route[i];
+        dest[r->dst].target += r->depth * m->src[r->src];
+    }
+    for (uint32_t d = 0; d < m->dests; d++) {
+        float t = dest[d].target;
+        if (t < dest[d].min) t = dest[d].min;
+        if (t > dest[d].max) t = dest[d].max;
+        dest[d].prev = dest[d].value;
+        dest[d].value += dest[d].coeff * (t - dest[d].value);
+    }
+}
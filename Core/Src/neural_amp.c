@@ -0,0 +1,159 @@
+#include "neural_amp.h"
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+#include <string.h>
+#include <math.h>
+
+static inline int16_t sat16(int32_t v) {
+    return (int16_t)__SSAT(v, 16);
+}
+
+static const uint8_t* blob_array(const uint8_t** p, uint32_t count, uint32_t elemSize) {
+    const uint8_t* a = *p;
+    *p += (count * elemSize + 3u) & ~3u;
+    return a;
+}
+
+uint8_t NeuralAmp_Init(NeuralAmp_t* na, const uint8_t* blob, uint32_t size) {
+    const NeuralAmp_Header_t* hdr = (const NeuralAmp_Header_t*)blob;
+    na->model = NULL;
+    na->hidden = 0;
+
+    if (((uintptr_t)blob & 3u) != 0 || size < sizeof(NeuralAmp_Header_t)) return 0;
+    if (hdr->magic != NEURAL_AMP_MAGIC || hdr->size > size) return 0;
+    if (hdr->hidden == 0 || hdr->hidden > NEURAL_AMP_MAX_HIDDEN) return 0;
+    if ((hdr->weightBits != 8 && hdr->weightBits != 16) || hdr->actIntBits > 3) return 0;
+    if (hdr->recOutShift == 0 || hdr->inOutShift == 0 || hdr->outOutShift == 0) return 0;
+
+    const uint32_t H = hdr->hidden;
+    const uint32_t es = hdr->weightBits / 8;
+    const uint8_t* p = blob + sizeof(NeuralAmp_Header_t);
+    na->recW = blob_array(&p, 3 * H * (H + 1), es);
+    na->recB = blob_array(&p, 3 * H, es);
+    na->inW = blob_array(&p, H, es);
+    na->inB = blob_array(&p, H, es);
+    na->outW = blob_array(&p, H, es);
+    na->outB = blob_array(&p, 1, es);
+    if ((uint32_t)(p - blob) != hdr->size) return 0;
+
+    na->model = hdr;
+    na->hidden = H;
+    NeuralAmp_Reset(na);
+    return 1;
+}
+
+void NeuralAmp_Reset(NeuralAmp_t* na) {
+    memset(na->v, 0, sizeof(na->v));
+    memset(na->ref, 0, sizeof(na->ref));
+}
+
+// Output = sat16((W v + (bias << bias_shift)) >> out_shift), weights row major
+static void fully_connected(const NeuralAmp_t* na, const int16_t* v, const void* w, const void* b,
+                            uint16_t dim, uint16_t rows, uint16_t biasShift, uint16_t outShift, int16_t* out) {
+    if (na->model->weightBits == 8) {
+        arm_fully_connected_mat_q7_vec_q15(v, w, dim, rows, biasShift, outShift, b, out, NULL);
+    } else {
+        arm_fully_connected_q15(v, w, dim, rows, biasShift, outShift, b, out, NULL);
+    }
+}
+
+void NeuralAmp_ProcessBlock(NeuralAmp_t* na, const float* in, float* out, uint32_t n) {
+    const NeuralAmp_Header_t* m = na->model;
+    if (m == NULL) {
+        if (out != in) memcpy(out, in, n * sizeof(float));
+        return;
+    }
+
+    const uint32_t H = na->hidden;
+    int16_t* h = na->v;
+    int16_t* r = na->gates;
+    int16_t* z = &na->gates[H];
+    int16_t* hn = &na->gates[2 * H];
+
+    for (uint32_t i = 0; i < n; i++) {
+        float s = in[i];
+        if (s > 32767.0f / 32768.0f) s = 32767.0f / 32768.0f;
+        if (s < -1.0f) s = -1.0f;
+        int16_t x = (int16_t)(s * 32768.0f);
+        h[H] = x;
+
+        // Gate pre-activations from [h, x], candidate input part from x alone
+        fully_connected(na, h, na->recW, na->recB, H + 1, 3 * H, m->recBiasShift, m->recOutShift, na->gates);
+        fully_connected(na, &h[H], na->inW, na->inB, 1, H, m->inBiasShift, m->inOutShift, na->cand);
+        arm_nn_activations_direct_q15(na->gates, 2 * H, m->actIntBits, ARM_SIGMOID);
+
+        // n = tanh(Wx + b + r * (Wh + b))
+        arm_nn_mult_q15(r, hn, na->tmp, 15, H);
+        for (uint32_t k = 0; k < H; k++) {
+            na->cand[k] = sat16(na->cand[k] + na->tmp[k]);
+        }
+        arm_nn_activations_direct_q15(na->cand, H, m->actIntBits, ARM_TANH);
+
+        // h = n + z * (h - n)
+        for (uint32_t k = 0; k < H; k++) {
+            int32_t d = h[k] - na->cand[k];
+            h[k] = sat16(na->cand[k] + ((z[k] * d + (1 << 14)) >> 15));
+        }
+
+        int16_t y;
+        fully_connected(na, h, na->outW, na->outB, H, 1, m->outBiasShift, m->outOutShift, &y);
+        if (m->skip) y = sat16(y + x);
+        out[i] = (float)y * (1.0f / 32768.0f);
+    }
+}
+
+// Weight k of a blob array as a float, scale 2^-frac
+static inline float blob_value(const NeuralAmp_t* na, const void* a, uint32_t k, float scale) {
+    if (na->model->weightBits == 8) return (float)((const int8_t*)a)[k] * scale;
+    return (float)((const int16_t*)a)[k] * scale;
+}
+
+void NeuralAmp_ReferenceBlock(NeuralAmp_t* na, const float* in, float* out, uint32_t n) {
+    const NeuralAmp_Header_t* m = na->model;
+    if (m == NULL) {
+        if (out != in) memcpy(out, in, n * sizeof(float));
+        return;
+    }
+
+    // Q formats back from the shifts: out_shift = wf + 15 - out_frac, bias_shift = wf + 15 - bf
+    const uint32_t H = na->hidden;
+    const int32_t preFrac = 15 - m->actIntBits;
+    const int32_t recWf = m->recOutShift + preFrac - 15, inWf = m->inOutShift + preFrac - 15;
+    const int32_t outWf = m->outOutShift;
+    const float recW = ldexpf(1.0f, -recWf), recB = ldexpf(1.0f, m->recBiasShift - recWf - 15);
+    const float inW = ldexpf(1.0f, -inWf), inB = ldexpf(1.0f, m->inBiasShift - inWf - 15);
+    const float outW = ldexpf(1.0f, -outWf), outB = ldexpf(1.0f, m->outBiasShift - outWf - 15);
+    float pre[3 * NEURAL_AMP_MAX_HIDDEN];
+
+    for (uint32_t i = 0; i < n; i++) {
+        float x = in[i];
+        if (x > 32767.0f / 32768.0f) x = 32767.0f / 32768.0f;
+        if (x < -1.0f) x = -1.0f;
+
+        for (uint32_t k = 0; k < 3 * H; k++) {
+            float acc = blob_value(na, na->recB, k, recB) + blob_value(na, na->recW, k * (H + 1) + H, recW) * x;
+            for (uint32_t j = 0; j < H; j++) {
+                acc += blob_value(na, na->recW, k * (H + 1) + j, recW) * na->ref[j];
+            }
+            pre[k] = acc;
+        }
+        for (uint32_t k = 0; k < H; k++) {
+            float r = 1.0f / (1.0f + expf(-pre[k]));
+            float z = 1.0f / (1.0f + expf(-pre[H + k]));
+            float c = tanhf(blob_value(na, na->inW, k, inW) * x + blob_value(na, na->inB, k, inB) + r * pre[2 * H + k]);
+            na->ref[k] = c + z * (na->ref[k] - c);
+        }
+
+        float y = blob_value(na, na->outB, 0, outB);
+        for (uint32_t j = 0; j < H; j++) {
+            y += blob_value(na, na->outW, j, outW) * na->ref[j];
+        }
+        if (m->skip) y += x;
+        out[i] = y;
+    }
+}
+
+uint32_t NeuralAmp_MacsPerSample(const NeuralAmp_t* na) {
+    const uint32_t H = na->hidden;
+    return 3 * H * (H + 1) + 2 * H;
+}
@@ -0,0 +1,24 @@
+#include "phaser.h"
+#include <string.h>
+#include <math.h>
+
+void Phaser_Init(Phaser_t* ph, float sample_rate, uint32_t stages, float min_hz, float max_hz,
+                 float feedback, float mix) {
+    memset(ph, 0, sizeof(Phaser_t));
+    if (stages < 1) stages = 1;
+    if (stages > TPT_MAX_STAGES) stages = TPT_MAX_STAGES;
+    if (feedback < -0.9f) feedback = -0.9f;
+    if (feedback > 0.9f) feedback = 0.9f;
+    ph->stages = stages;
+    ph->sample_rate = sample_rate;
+    ph->minHz = min_hz;
+    ph->octaves = log2f(max_hz / min_hz);
+    ph->feedback = feedback;
+    ph->mix = mix;
+}
+
+void Phaser_ProcessBlock(Phaser_t* ph, float* l, float* r, uint32_t n, float posL, float posR) {
+    float gl = TPT_G(ph->minHz * Fast_Exp2(posL * ph->octaves), ph->sample_rate);
+    float gr = TPT_G(ph->minHz * Fast_Exp2(posR * ph->octaves), ph->sample_rate);
+    TPT_AllpassChain(ph->stateL, ph->stateR, ph->stages, gl, gr, ph->feedback, ph->mix, ph->last, l, r, n);
+}
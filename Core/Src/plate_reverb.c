@@ -0,0 +1,206 @@
+#include "plate_reverb.h"
+#include "delay.h"
+#include <stddef.h>
+
+// Dattorro's lengths, at 29761 Hz
+#define PLATE_REF_RATE 29761.0f
+static const uint32_t diffuser_len[4] = {142, 107, 379, 277};
+static const float diffuser_g[4] = {0.75f, 0.75f, 0.625f, 0.625f};
+static const uint32_t mod_ap_len[2] = {672, 908};
+static const uint32_t delay1_len[2] = {4453, 4217};
+static const uint32_t ap2_len[2] = {1800, 2656};
+static const uint32_t delay2_len[2] = {3720, 3163};
+#define PLATE_EXCURSION 16.0f
+#define PLATE_LFO_HZ 1.0f
+#define PLATE_MOD_G (-0.7f)   // decay diffusion 1, sign reversed as in the paper
+#define PLATE_BANDWIDTH 0.9995f
+#define PLATE_OUT_SCALE 0.6f
+
+// Output taps (Table 2): line, delay; signs + + - + - - - for both channels
+enum { T_D1L, T_AP2L, T_D2L, T_D1R, T_AP2R, T_D2R };
+static const struct { uint8_t line; uint16_t delay; } tap_l[PLATE_TAPS] = {
+    {T_D1R, 266}, {T_D1R, 2974}, {T_AP2R, 1913}, {T_D2R, 1996}, {T_D1L, 1990}, {T_AP2L, 187}, {T_D2L, 1066},
+};
+static const struct { uint8_t line; uint16_t delay; } tap_r[PLATE_TAPS] = {
+    {T_D1L, 353}, {T_D1L, 3627}, {T_AP2L, 1228}, {T_D2L, 2673}, {T_D1R, 2111}, {T_AP2R, 335}, {T_D2R, 121},
+};
+
+static uint32_t scaled(uint32_t len, float k) {
+    uint32_t s = (uint32_t)((float)len * k + 0.5f);
+    return s ? s : 1;
+}
+
+// Modulated allpass lines hold the swing plus the two interpolation points
+static uint32_t mod_ap_size(uint32_t side, float k, float rate) {
+    return scaled(mod_ap_len[side], k) + (uint32_t)(PLATE_EXCURSION * rate / PLATE_REF_RATE) + 2;
+}
+
+uint32_t Plate_PoolSize(float rate, float size) {
+    const float k = size * rate / PLATE_REF_RATE;
+    uint32_t total = 0;
+    for (uint32_t d = 0; d < 4; d++) total += scaled(diffuser_len[d], k);
+    for (uint32_t s = 0; s < 2; s++) {
+        total += mod_ap_size(s, k, rate) + scaled(delay1_len[s], k) + scaled(ap2_len[s], k) + scaled(delay2_len[s], k);
+    }
+    return total;
+}
+
+static uint8_t line_init(Reverb_Line_t* line, Reverb_Pool_t* pools, uint32_t poolCount, uint32_t len, float g) {
+    line->buf = Reverb_PoolListAlloc(pools, poolCount, len);
+    line->len = len;
+    line->pos = 0;
+    line->g = g;
+    return line->buf != NULL;
+}
+
+static const Reverb_Line_t* tap_line(const Plate_t* pl, uint8_t id) {
+    switch (id) {
+    case T_D1L:  return &pl->delay1[0];
+    case T_AP2L: return &pl->ap2[0];
+    case T_D2L:  return &pl->delay2[0];
+    case T_D1R:  return &pl->delay1[1];
+    case T_AP2R: return &pl->ap2[1];
+    default:     return &pl->delay2[1];
+    }
+}
+
+uint8_t Plate_Init(Plate_t* pl, Reverb_Pool_t* pools, uint32_t poolCount, float rate, float size,
+                   float decay, float damping, float wet) {
+    const float k = size * rate / PLATE_REF_RATE;
+    pl->ready = 0;
+
+    for (uint32_t d = 0; d < 4; d++) {
+        if (!line_init(&pl->diffuser[d], pools, poolCount, scaled(diffuser_len[d], k), diffuser_g[d])) return 0;
+    }
+    for (uint32_t s = 0; s < 2; s++) {
+        if (!line_init(&pl->modAp[s], pools, poolCount, mod_ap_size(s, k, rate), PLATE_MOD_G)) return 0;
+        if (!line_init(&pl->delay1[s], pools, poolCount, scaled(delay1_len[s], k), 0.0f)) return 0;
+        if (!line_init(&pl->ap2[s], pools, poolCount, scaled(ap2_len[s], k), 0.5f)) return 0;
+        if (!line_init(&pl->delay2[s], pools, poolCount, scaled(delay2_len[s], k), 0.0f)) return 0;
+        pl->modCenter[s] = (float)scaled(mod_ap_len[s], k);
+        pl->damp[s] = 0.0f;
+    }
+    pl->excursion = PLATE_EXCURSION * rate / PLATE_REF_RATE;
+
+    // Taps scale with the lines but must stay inside them
+    for (uint32_t t = 0; t < PLATE_TAPS; t++) {
+        pl->tapL[t].line = tap_line(pl, tap_l[t].line);
+        pl->tapL[t].delay = scaled(tap_l[t].delay, k);
+        if (pl->tapL[t].delay >= pl->tapL[t].line->len) pl->tapL[t].delay = pl->tapL[t].line->len - 1;
+        pl->tapR[t].line = tap_line(pl, tap_r[t].line);
+        pl->tapR[t].delay = scaled(tap_r[t].delay, k);
+        if (pl->tapR[t].delay >= pl->tapR[t].line->len) pl->tapR[t].delay = pl->tapR[t].line->len - 1;
+    }
+
+    pl->lfo.phase = 0;
+    LFO_SetRate(&pl->lfo, PLATE_LFO_HZ, rate);
+    pl->bandwidth = PLATE_BANDWIDTH;
+    pl->bwState = 0.0f;
+    Plate_SetDecay(pl, decay);
+    Plate_SetDamping(pl, damping);
+    Plate_SetWet(pl, wet);
+    pl->ready = 1;
+    return 1;
+}
+
+// Decay diffusion 2 follows the decay as in the paper: decay + 0.15, within 0.25..0.5
+void Plate_SetDecay(Plate_t* pl, float decay) {
+    if (decay < 0.0f) decay = 0.0f;
+    if (decay > 0.99f) decay = 0.99f;
+    pl->decay = decay;
+    float g = decay + 0.15f;
+    if (g < 0.25f) g = 0.25f;
+    if (g > 0.5f) g = 0.5f;
+    pl->ap2[0].g = g;
+    pl->ap2[1].g = g;
+}
+
+void Plate_SetDamping(Plate_t* pl, float damping) {
+    if (damping < 0.0f) damping = 0.0f;
+    if (damping > 1.0f) damping = 1.0f;
+    pl->damping = damping;
+}
+
+void Plate_SetWet(Plate_t* pl, float wet) {
+    pl->wet = wet;
+}
+
+static inline void line_advance(Reverb_Line_t* line) {
+    if (++line->pos == line->len) line->pos = 0;
+}
+
+// Plain delay: returns the sample len ago and stores x
+static inline float delay_step(Reverb_Line_t* line, float x) {
+    float y = line->buf[line->pos];
+    line->buf[line->pos] = x;
+    line_advance(line);
+    return y;
+}
+
+static inline float allpass_step(Reverb_Line_t* a, float x, float delayed) {
+    float y = delayed - a->g * x;
+    a->buf[a->pos] = y * a->g + x;
+    line_advance(a);
+    return y;
+}
+
+// Sample written 'delay' samples ago (1 <= delay < len)
+static inline float tap_read(const Plate_Tap_t* t) {
+    const Reverb_Line_t* line = t->line;
+    uint32_t i = line->pos >= t->delay ? line->pos - t->delay : line->pos + line->len - t->delay;
+    return line->buf[i];
+}
+
+static inline float taps_sum(const Plate_Tap_t* t) {
+    return (tap_read(&t[0]) + tap_read(&t[1])) - tap_read(&t[2]) + tap_read(&t[3])
+         - (tap_read(&t[4]) + tap_read(&t[5]) + tap_read(&t[6]));
+}
+
+/*The input side (bandwidth filter and diffusers) has no feedback and runs over the whole
+block; the tank runs per sample since its halves feed each other.*/
+void Plate_ProcessBlock(Plate_t* pl, float* l, float* r, uint32_t n) {
+    if (!pl->ready) return;
+    const float wet = pl->wet * PLATE_OUT_SCALE;
+    const float dry = 1.0f - pl->wet;
+    const float decay = pl->decay;
+    const float damping = pl->damping;
+    float* x = pl->mono;
+
+    float bw = pl->bwState;
+    for (uint32_t i = 0; i < n; i++) {
+        bw += pl->bandwidth * (0.5f * (l[i] + r[i]) - bw);
+        x[i] = bw;
+    }
+    pl->bwState = bw;
+    for (uint32_t d = 0; d < 4; d++) {
+        Reverb_AllpassBlock(&pl->diffuser[d], x, n);
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        float yl = taps_sum(pl->tapL);
+        float yr = taps_sum(pl->tapR);
+
+        // Each half starts with the decayed end of the other
+        float endL = pl->delay2[0].buf[pl->delay2[0].pos];
+        float endR = pl->delay2[1].buf[pl->delay2[1].pos];
+        float mod = pl->excursion * LFO_SineAt(pl->lfo.phase);
+        float modQ = pl->excursion * LFO_SineAt(pl->lfo.phase + 0x40000000u);
+        pl->lfo.phase += pl->lfo.inc;
+
+        for (uint32_t s = 0; s < 2; s++) {
+            Reverb_Line_t* ap = &pl->modAp[s];
+            float in = x[i] + decay * (s ? endL : endR);
+            float d = pl->modCenter[s] + (s ? modQ : mod);
+            float v = allpass_step(ap, in, Delay_ReadFrac(ap->buf, ap->len, ap->pos, (float)ap->len - d));
+            v = delay_step(&pl->delay1[s], v);
+            pl->damp[s] += (1.0f - damping) * (v - pl->damp[s]);
+            v = pl->damp[s] * decay;
+            Reverb_Line_t* a2 = &pl->ap2[s];
+            v = allpass_step(a2, v, a2->buf[a2->pos]);
+            delay_step(&pl->delay2[s], v);
+        }
+
+        l[i] = dry * l[i] + wet * yl;
+        r[i] = dry * r[i] + wet * yr;
+    }
+}
@@ -0,0 +1,151 @@
+#include "reduced_rate.h"
+#include "kaiser.h"
+#include <string.h>
+
+#define RR_HB_K 8
+#define RR_HB_BETA 7.0f
+#define RR_THIRD_BETA 6.0f
+
+// Offsets of the non-zero third-band taps: every k not a multiple of 3
+static const uint8_t third_k[RR_THIRD_PAIRS] = {1, 2, 4, 5, 7, 8, 10, 11, 13, 14, 16, 17, 19, 20, 22, 23};
+
+/*Kaiser windowed sinc with its cut-off at a third of the band. The centre tap is exactly
+1/3, the others are scaled for unity DC gain, which also gives each interpolator phase
+a DC gain of 1/3 so the interpolated output has no ripple at the low rate.*/
+static void third_design(ReducedRate_t* rr) {
+    float h[2 * RR_THIRD_HALF + 1];
+    const float half = (float)(RR_THIRD_HALF + 1);
+    float sum = 0.0f;
+
+    for (int32_t k = -RR_THIRD_HALF; k <= RR_THIRD_HALF; k++) {
+        float v = 0.0f;
+        if (k % 3 != 0) {
+            v = Kaiser_Sinc((float)k, 1.0f / 3.0f, half, RR_THIRD_BETA) / 3.0f;
+        }
+        h[k + RR_THIRD_HALF] = v;
+        sum += v;
+    }
+    for (uint32_t k = 0; k < 2 * RR_THIRD_HALF + 1; k++) {
+        h[k] *= (2.0f / 3.0f) / sum;
+    }
+    h[RR_THIRD_HALF] = 1.0f / 3.0f;
+
+    for (uint32_t m = 0; m < RR_THIRD_PAIRS; m++) {
+        rr->g3[m] = h[RR_THIRD_HALF + third_k[m]];
+        // Phase p output: 3 h[p + 3m - 24] times the low rate sample m back
+        rr->poly[0][m] = 3.0f * h[1 + 3 * m];
+        rr->poly[1][m] = 3.0f * h[2 + 3 * m];
+    }
+}
+
+void ReducedRate_Init(ReducedRate_t* rr, uint32_t factor, ReducedRate_Process_t process, void* fx, float mix) {
+    if (factor < 1) factor = 1;
+    if (factor > RR_MAX_FACTOR) factor = RR_MAX_FACTOR;
+    rr->factor = factor;
+    rr->process = process;
+    rr->fx = fx;
+    rr->mix = mix;
+
+    HalfBand_Init(&rr->down, RR_HB_K, RR_HB_BETA);
+    HalfBand_Init(&rr->upL, RR_HB_K, RR_HB_BETA);
+    HalfBand_Init(&rr->upR, RR_HB_K, RR_HB_BETA);
+    third_design(rr);
+    rr->phase = 0;
+    memset(rr->hist, 0, sizeof(rr->hist));
+    memset(rr->lowL, 0, sizeof(rr->lowL));
+    memset(rr->lowR, 0, sizeof(rr->lowR));
+}
+
+void ReducedRate_SetMix(ReducedRate_t* rr, float mix) {
+    rr->mix = mix;
+}
+
+float ReducedRate_Rate(const ReducedRate_t* rr) {
+    return (float)SAMPLE_RATE / (float)rr->factor;
+}
+
+uint32_t ReducedRate_Latency(const ReducedRate_t* rr) {
+    if (rr->factor == 2) return 4 * RR_HB_K - 3;
+    if (rr->factor == 3) return 2 * RR_THIRD_HALF;
+    return 0;
+}
+
+// Low rate samples where (phase + i) % 3 == 0, centre 24 fine samples back
+static uint32_t third_down(ReducedRate_t* rr, const float* x, float* low, uint32_t n) {
+    const uint32_t H = 2 * RR_THIRD_HALF;
+    float* w = rr->hist;
+    uint32_t count = 0;
+
+    memcpy(&w[H], x, n * sizeof(float));
+    for (uint32_t i = (3 - rr->phase) % 3; i < n; i += 3) {
+        const float* c = &w[H + i - RR_THIRD_HALF];
+        float acc = c[0] * (1.0f / 3.0f);
+        for (uint32_t m = 0; m < RR_THIRD_PAIRS; m++) {
+            acc += rr->g3[m] * (c[-(int32_t)third_k[m]] + c[third_k[m]]);
+        }
+        low[count++] = acc;
+    }
+    memmove(w, &w[n], H * sizeof(float));
+    return count;
+}
+
+// low: RR_LOW_HIST history then 'count' new samples; keeps the last RR_LOW_HIST
+static void third_up(const ReducedRate_t* rr, float* low, uint32_t count, float* out, uint32_t n) {
+    uint32_t j = RR_LOW_HIST - 1; // newest low rate sample at or before the output
+    uint32_t p = rr->phase;
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (p == 0) {
+            j++;
+            out[i] = low[j - RR_THIRD_HALF / 3]; // centre tap only
+        } else {
+            const float* g = rr->poly[p - 1];
+            float acc = 0.0f;
+            for (uint32_t m = 0; m < RR_THIRD_PAIRS; m++) {
+                acc += g[m] * low[j - m];
+            }
+            out[i] = acc;
+        }
+        if (++p == 3) p = 0;
+    }
+    memmove(low, &low[count], RR_LOW_HIST * sizeof(float));
+}
+
+void ReducedRate_ProcessBlock(ReducedRate_t* rr, float* l, float* r, uint32_t n) {
+    const float dry = 1.0f - rr->mix;
+    float* lowL = &rr->lowL[RR_LOW_HIST];
+    float* lowR = &rr->lowR[RR_LOW_HIST];
+
+    if (rr->factor == 1) {
+        memcpy(rr->wetL, l, n * sizeof(float));
+        memcpy(rr->wetR, r, n * sizeof(float));
+        if (rr->process) rr->process(rr->fx, rr->wetL, rr->wetR, n);
+    } else {
+        for (uint32_t i = 0; i < n; i++) {
+            rr->wetL[i] = 0.5f * (l[i] + r[i]);
+        }
+        uint32_t m;
+        if (rr->factor == 2) {
+            m = n / 2;
+            HalfBand_Down(&rr->down, rr->wetL, lowL, m);
+        } else {
+            m = third_down(rr, rr->wetL, lowL, n);
+        }
+        memcpy(lowR, lowL, m * sizeof(float));
+        if (rr->process && m > 0) rr->process(rr->fx, lowL, lowR, m);
+
+        if (rr->factor == 2) {
+            HalfBand_Up(&rr->upL, lowL, rr->wetL, m);
+            HalfBand_Up(&rr->upR, lowR, rr->wetR, m);
+        } else {
+            third_up(rr, rr->lowL, m, rr->wetL, n);
+            third_up(rr, rr->lowR, m, rr->wetR, n);
+            rr->phase = (rr->phase + n) % 3;
+        }
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        l[i] = dry * l[i] + rr->mix * rr->wetL[i];
+        r[i] = dry * r[i] + rr->mix * rr->wetR[i];
+    }
+}
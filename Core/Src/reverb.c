@@ -1,137 +1,310 @@
 #include "reverb.h"
-#include "dsp_configuration.h"
-
-#ifdef REVERB_ENABLE
-//Schroeder delays from 25k->96k interpolated
-//*2 delay extension -> not more possible without external ram
-#define l_CB0 3460*2
-#define l_CB1 2988*2
-#define l_CB2 3882*2
-#define l_CB3 4312*2
-#define l_AP0 480*2
-#define l_AP1 161*2
-#define l_AP2 46*2
-
-//define wet 0.0 <-> 1.0
-static float wet = 0.25f;
-//define time delay 0.0 <-> 1.0 (max)
-static float time = 0.7f;
-
-//define pointer limits = delay time
-static int cf0_lim, cf1_lim, cf2_lim, cf3_lim, ap0_lim, ap1_lim, ap2_lim;
-//define buffer for comb- and allpassfilters
-static float  cfbuf1[l_CB1], cfbuf2[l_CB2], apbuf0[l_AP0];
-/*Send these to CCM RAM to make more ram space to include other effects on normal RAM*/
-__attribute__((section(".ccmram")))static float cfbuf0[l_CB0] = {}, cfbuf3[l_CB3] = {}, apbuf2[l_AP2] = {}, apbuf1[l_AP1] = {};
-//feedback defines as of Schroeder
-static float cf0_g = 0.805f, cf1_g=0.827f, cf2_g=0.783f, cf3_g=0.764f;
-static float ap0_g = 0.7f, ap1_g = 0.7f, ap2_g = 0.7f;
-//buffer-pointer
-static int cf0_p=0, cf1_p=0, cf2_p=0, cf3_p=0, ap0_p=0, ap1_p=0, ap2_p=0;
-
-static float Do_Comb0(float inSample);
-static float Do_Comb1(float inSample);
-static float Do_Comb2(float inSample);
-static float Do_Comb3(float inSample);
-static float Do_Allpass0(float inSample);
-static float Do_Allpass1(float inSample);
-static float Do_Allpass2(float inSample);
-static float Process_Reverb(float inSample);
-
-static float Do_Comb0(float inSample) {
-	float readback = cfbuf0[cf0_p];
-	float new = readback*cf0_g + inSample;
-	cfbuf0[cf0_p] = new;
-	cf0_p++;
-	if (cf0_p==cf0_lim) cf0_p = 0;
-	return readback;
-}
-
-static float Do_Comb1(float inSample) {
-	float readback = cfbuf1[cf1_p];
-	float new = readback*cf1_g + inSample;
-	cfbuf1[cf1_p] = new;
-	cf1_p++;
-	if (cf1_p==cf1_lim) cf1_p = 0;
-	return readback;
-}
-
-static float Do_Comb2(float inSample) {
-	float readback = cfbuf2[cf2_p];
-	float new = readback*cf2_g + inSample;
-	cfbuf2[cf2_p] = new;
-	cf2_p++;
-	if (cf2_p==cf2_lim) cf2_p = 0;
-	return readback;
-}
-
-static float Do_Comb3(float inSample) {
-	float readback = cfbuf3[cf3_p];
-	float new = readback*cf3_g + inSample;
-	cfbuf3[cf3_p] = new;
-	cf3_p++;
-	if (cf3_p==cf3_lim) cf3_p = 0;
-	return readback;
-}
-
-
-static float Do_Allpass0(float inSample) {
-	float readback = apbuf0[ap0_p];
-	readback += (-ap0_g) * inSample;
-	float new = readback*ap0_g + inSample;
-	apbuf0[ap0_p] = new;
-	ap0_p++;
-	if (ap0_p == ap0_lim) ap0_p=0;
-	return readback;
-}
-
-static float Do_Allpass1(float inSample) {
-	float readback = apbuf1[ap1_p];
-	readback += (-ap1_g) * inSample;
-	float new = readback*ap1_g + inSample;
-	apbuf1[ap1_p] = new;
-	ap1_p++;
-	if (ap1_p == ap1_lim) ap1_p=0;
-	return readback;
-}
-
-static float Do_Allpass2(float inSample) {
-	float readback = apbuf2[ap2_p];
-	readback += (-ap2_g) * inSample;
-	float new = readback*ap2_g + inSample;
-	apbuf2[ap2_p] = new;
-	ap2_p++;
-	if (ap2_p == ap2_lim) ap2_p=0;
-	return readback;
-}
-
-static float Process_Reverb(float inSample) {
-	float newsample = (Do_Comb0(inSample) + Do_Comb1(inSample) + Do_Comb2(inSample) + Do_Comb3(inSample))/4.0f;
-	newsample = Do_Allpass0(newsample);
-	newsample = Do_Allpass1(newsample);
-	newsample = Do_Allpass2(newsample);
-	return newsample;
-}
-#endif // REVERB_ENABLE
-
-float Do_Reverb(float inSample) {
-    float sum = inSample;
-#ifdef REVERB_ENABLE
-	sum = (1.0f-wet)*sum + wet*Process_Reverb(sum);
-#endif // REVERB_ENABLE
-
-    return sum;
-}
-
-void Reverb_Init(void)
-{
-#ifdef REVERB_ENABLE
-    cf0_lim = (int)(time*l_CB0);
-	cf1_lim = (int)(time*l_CB1);
-	cf2_lim = (int)(time*l_CB2);
-	cf3_lim = (int)(time*l_CB3);
-	ap0_lim = (int)(time*l_AP0);
-	ap1_lim = (int)(time*l_AP1);
-	ap2_lim = (int)(time*l_AP2);
-#endif // REVERB_ENABLE
-}
\ No newline at end of file
+#include "arm_math.h"
+#include <string.h>
+#include <math.h>
+
+// Schroeder (1962): combs 29.7/37.1/41.1/43.7 ms, allpasses 5.0/1.7 ms plus a short diffuser
+static const uint32_t default_comb_len[] = {
+    (uint32_t)(0.0297f * SAMPLE_RATE), (uint32_t)(0.0371f * SAMPLE_RATE),
+    (uint32_t)(0.0411f * SAMPLE_RATE), (uint32_t)(0.0437f * SAMPLE_RATE),
+};
+static const uint32_t default_allpass_len[] = {
+    (uint32_t)(0.0050f * SAMPLE_RATE), (uint32_t)(0.0017f * SAMPLE_RATE), (uint32_t)(0.0005f * SAMPLE_RATE),
+};
+static const float default_allpass_g[] = {0.7f, 0.7f, 0.7f};
+
+const Reverb_Config_t Reverb_DefaultConfig = {
+    default_comb_len, 4,
+    default_allpass_len, default_allpass_g, 3,
+    23,
+    (float)SAMPLE_RATE,
+    0,
+};
+
+#define Q15_SCALE (32768.0f / REVERB_Q15_HEADROOM)
+
+// Nearest from floor up, towards zero below it: the half step is picked before the one
+// conversion (which truncates), then saturated
+static inline int16_t to_q15(float v, float floor) {
+    float half = (v >= floor) ? 0.5f : (v <= -floor) ? -0.5f : 0.0f;
+    return (int16_t)__SSAT((int32_t)(v + half), 16);
+}
+
+// Past the largest value a rounded loop of gain g can hold without decaying
+static float limit_cycle_floor(float g) {
+    return (float)(int32_t)(0.5f / (1.0f - g)) + 1.0f;
+}
+
+void Reverb_PoolInit(Reverb_Pool_t* pool, float* mem, uint32_t size) {
+    pool->mem = mem;
+    pool->size = size;
+    pool->used = 0;
+}
+
+float* Reverb_PoolAlloc(Reverb_Pool_t* pool, uint32_t count) {
+    if (pool->size - pool->used < count) return NULL;
+    float* p = &pool->mem[pool->used];
+    pool->used += count;
+    memset(p, 0, count * sizeof(float));
+    return p;
+}
+
+float* Reverb_PoolListAlloc(Reverb_Pool_t* pools, uint32_t poolCount, uint32_t count) {
+    for (uint32_t p = 0; p < poolCount; p++) {
+        float* mem = Reverb_PoolAlloc(&pools[p], count);
+        if (mem != NULL) return mem;
+    }
+    return NULL;
+}
+
+// A configured length at the running rate
+static uint32_t scaled_len(uint32_t len, const Reverb_Config_t* cfg, float rate) {
+    uint32_t s = (uint32_t)((float)len * rate / cfg->rate + 0.5f);
+    return s ? s : 1;
+}
+
+// Pool floats for a line of len samples
+static uint32_t line_floats(uint32_t len, uint8_t q15) {
+    return q15 ? (len + 1) / 2 : len;
+}
+
+uint32_t Reverb_PoolSize(const Reverb_Config_t* cfg, float rate) {
+    uint32_t size = 0;
+    uint32_t spread = scaled_len(cfg->spread, cfg, rate);
+    for (uint32_t ch = 0; ch < 2; ch++) {
+        uint32_t extra = ch ? spread : 0;
+        for (uint32_t k = 0; k < cfg->combs; k++) size += line_floats(scaled_len(cfg->combLen[k], cfg, rate) + extra, cfg->q15);
+        for (uint32_t k = 0; k < cfg->allpasses; k++) size += line_floats(scaled_len(cfg->allpassLen[k], cfg, rate) + extra, cfg->q15);
+    }
+    return size;
+}
+
+static uint8_t line_init(Reverb_Line_t* line, Reverb_Pool_t* pool, uint32_t len, uint8_t q15, float g) {
+    line->buf = Reverb_PoolAlloc(pool, line_floats(len, q15));
+    line->len = len;
+    line->pos = 0;
+    line->g = g;
+    line->floor = limit_cycle_floor(g);
+    return line->buf != NULL;
+}
+
+uint8_t Reverb_Init(Reverb_t* rv, Reverb_Pool_t* pool, const Reverb_Config_t* cfg, float rate, float rt60_s, float wet) {
+    rv->combs = 0;
+    rv->rate = rate;
+    rv->q15 = cfg->q15;
+    rv->allpasses = 0;
+    if (cfg->combs == 0 || cfg->combs > REVERB_MAX_COMBS || cfg->allpasses > REVERB_MAX_ALLPASS) return 0;
+
+    for (uint32_t ch = 0; ch < 2; ch++) {
+        uint32_t extra = ch ? scaled_len(cfg->spread, cfg, rate) : 0;
+        for (uint32_t k = 0; k < cfg->combs; k++) {
+            if (!line_init(&rv->comb[ch][k], pool, scaled_len(cfg->combLen[k], cfg, rate) + extra, cfg->q15, 0.0f)) return 0;
+        }
+        for (uint32_t k = 0; k < cfg->allpasses; k++) {
+            if (!line_init(&rv->allpass[ch][k], pool, scaled_len(cfg->allpassLen[k], cfg, rate) + extra, cfg->q15,
+                           cfg->allpassG[k])) return 0;
+        }
+    }
+    rv->combs = cfg->combs;
+    rv->allpasses = cfg->allpasses;
+    rv->combScale = 1.0f / (float)cfg->combs;
+    Reverb_SetDecay(rv, rt60_s);
+    Reverb_SetWet(rv, wet);
+    return 1;
+}
+
+void Reverb_SetDecay(Reverb_t* rv, float rt60_s) {
+    for (uint32_t ch = 0; ch < 2; ch++) {
+        for (uint32_t k = 0; k < rv->combs; k++) {
+            Reverb_Line_t* c = &rv->comb[ch][k];
+            c->g = powf(10.0f, -3.0f * (float)c->len / (rt60_s * rv->rate));
+            c->floor = limit_cycle_floor(c->g);
+        }
+    }
+}
+
+void Reverb_SetWet(Reverb_t* rv, float wet) {
+    rv->wet = wet;
+}
+
+// Samples until the first of the lines wraps, at most n
+static inline uint32_t run_length(const Reverb_Line_t* const* lines, uint32_t count, uint32_t n) {
+    for (uint32_t k = 0; k < count; k++) {
+        uint32_t left = lines[k]->len - lines[k]->pos;
+        if (left < n) n = left;
+    }
+    return n;
+}
+
+// Four combs at once: out += sum of the comb outputs
+static void comb4(Reverb_Line_t* c, const float* in, float* out, uint32_t n) {
+    const Reverb_Line_t* lines[4] = {&c[0], &c[1], &c[2], &c[3]};
+    const float g0 = c[0].g, g1 = c[1].g, g2 = c[2].g, g3 = c[3].g;
+
+    while (n > 0) {
+        uint32_t run = run_length(lines, 4, n);
+        float* b0 = &c[0].buf[c[0].pos];
+        float* b1 = &c[1].buf[c[1].pos];
+        float* b2 = &c[2].buf[c[2].pos];
+        float* b3 = &c[3].buf[c[3].pos];
+        for (uint32_t i = 0; i < run; i++) {
+            float x = in[i];
+            float y0 = b0[i], y1 = b1[i], y2 = b2[i], y3 = b3[i];
+            b0[i] = y0 * g0 + x;
+            b1[i] = y1 * g1 + x;
+            b2[i] = y2 * g2 + x;
+            b3[i] = y3 * g3 + x;
+            out[i] += (y0 + y1) + (y2 + y3);
+        }
+        for (uint32_t k = 0; k < 4; k++) {
+            c[k].pos += run;
+            if (c[k].pos == c[k].len) c[k].pos = 0;
+        }
+        in += run;
+        out += run;
+        n -= run;
+    }
+}
+
+static void comb1(Reverb_Line_t* c, const float* in, float* out, uint32_t n) {
+    const Reverb_Line_t* lines[1] = {c};
+    while (n > 0) {
+        uint32_t run = run_length(lines, 1, n);
+        float* b = &c->buf[c->pos];
+        for (uint32_t i = 0; i < run; i++) {
+            float y = b[i];
+            b[i] = y * c->g + in[i];
+            out[i] += y;
+        }
+        c->pos += run;
+        if (c->pos == c->len) c->pos = 0;
+        in += run;
+        out += run;
+        n -= run;
+    }
+}
+
+// y = buf - g x, buf = x + g y: (z^-D - g) / (1 - g z^-D), in place
+void Reverb_AllpassBlock(Reverb_Line_t* a, float* x, uint32_t n) {
+    const Reverb_Line_t* lines[1] = {a};
+    const float g = a->g;
+    while (n > 0) {
+        uint32_t run = run_length(lines, 1, n);
+        float* b = &a->buf[a->pos];
+        for (uint32_t i = 0; i < run; i++) {
+            float y = b[i] - g * x[i];
+            b[i] = y * g + x[i];
+            x[i] = y;
+        }
+        a->pos += run;
+        if (a->pos == a->len) a->pos = 0;
+        x += run;
+        n -= run;
+    }
+}
+
+/*Q15 lines: same loops on signals already scaled by Q15_SCALE, so the heads only convert*/
+static void comb4_q15(Reverb_Line_t* c, const float* in, float* out, uint32_t n) {
+    const Reverb_Line_t* lines[4] = {&c[0], &c[1], &c[2], &c[3]};
+    const float g0 = c[0].g, g1 = c[1].g, g2 = c[2].g, g3 = c[3].g;
+    const float f0 = c[0].floor, f1 = c[1].floor, f2 = c[2].floor, f3 = c[3].floor;
+
+    while (n > 0) {
+        uint32_t run = run_length(lines, 4, n);
+        int16_t* b0 = &c[0].q15[c[0].pos];
+        int16_t* b1 = &c[1].q15[c[1].pos];
+        int16_t* b2 = &c[2].q15[c[2].pos];
+        int16_t* b3 = &c[3].q15[c[3].pos];
+        for (uint32_t i = 0; i < run; i++) {
+            float x = in[i];
+            float y0 = (float)b0[i], y1 = (float)b1[i], y2 = (float)b2[i], y3 = (float)b3[i];
+            b0[i] = to_q15(y0 * g0 + x, f0);
+            b1[i] = to_q15(y1 * g1 + x, f1);
+            b2[i] = to_q15(y2 * g2 + x, f2);
+            b3[i] = to_q15(y3 * g3 + x, f3);
+            out[i] += (y0 + y1) + (y2 + y3);
+        }
+        for (uint32_t k = 0; k < 4; k++) {
+            c[k].pos += run;
+            if (c[k].pos == c[k].len) c[k].pos = 0;
+        }
+        in += run;
+        out += run;
+        n -= run;
+    }
+}
+
+static void comb1_q15(Reverb_Line_t* c, const float* in, float* out, uint32_t n) {
+    const Reverb_Line_t* lines[1] = {c};
+    while (n > 0) {
+        uint32_t run = run_length(lines, 1, n);
+        int16_t* b = &c->q15[c->pos];
+        for (uint32_t i = 0; i < run; i++) {
+            float y = (float)b[i];
+            b[i] = to_q15(y * c->g + in[i], c->floor);
+            out[i] += y;
+        }
+        c->pos += run;
+        if (c->pos == c->len) c->pos = 0;
+        in += run;
+        out += run;
+        n -= run;
+    }
+}
+
+static void allpass_q15(Reverb_Line_t* a, float* x, uint32_t n) {
+    const Reverb_Line_t* lines[1] = {a};
+    const float g = a->g;
+    while (n > 0) {
+        uint32_t run = run_length(lines, 1, n);
+        int16_t* b = &a->q15[a->pos];
+        for (uint32_t i = 0; i < run; i++) {
+            float y = (float)b[i] - g * x[i];
+            b[i] = to_q15(y * g + x[i], a->floor);
+            x[i] = y;
+        }
+        a->pos += run;
+        if (a->pos == a->len) a->pos = 0;
+        x += run;
+        n -= run;
+    }
+}
+
+static void channel_block(Reverb_t* rv, uint32_t ch, const float* in, float* out, uint32_t n) {
+    uint32_t k = 0;
+    memset(out, 0, n * sizeof(float));
+    for (; k + 4 <= rv->combs; k += 4) {
+        if (rv->q15) comb4_q15(&rv->comb[ch][k], in, out, n);
+        else comb4(&rv->comb[ch][k], in, out, n);
+    }
+    for (; k < rv->combs; k++) {
+        if (rv->q15) comb1_q15(&rv->comb[ch][k], in, out, n);
+        else comb1(&rv->comb[ch][k], in, out, n);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] *= rv->combScale;
+    }
+    for (k = 0; k < rv->allpasses; k++) {
+        if (rv->q15) allpass_q15(&rv->allpass[ch][k], out, n);
+        else Reverb_AllpassBlock(&rv->allpass[ch][k], out, n);
+    }
+}
+
+void Reverb_ProcessBlock(Reverb_t* rv, float* l, float* r, uint32_t n) {
+    if (rv->combs == 0) return;
+    const float dry = 1.0f - rv->wet;
+    const float in_gain = rv->q15 ? 0.5f * Q15_SCALE : 0.5f;
+    const float wet = rv->q15 ? rv->wet / Q15_SCALE : rv->wet;
+
+    for (uint32_t i = 0; i < n; i++) {
+        rv->mono[i] = in_gain * (l[i] + r[i]);
+    }
+    channel_block(rv, 0, rv->mono, rv->out, n);
+    for (uint32_t i = 0; i < n; i++) {
+        l[i] = dry * l[i] + wet * rv->out[i];
+    }
+    channel_block(rv, 1, rv->mono, rv->out, n);
+    for (uint32_t i = 0; i < n; i++) {
+        r[i] = dry * r[i] + wet * rv->out[i];
+    }
+}
@@ -0,0 +1,91 @@
+#include "shimmer.h"
+#include "eq.h"
+#include "pitch_shift.h"
+#include <string.h>
+#include <math.h>
+
+static uint32_t window_len(float rate) {
+    return (uint32_t)(rate * SHIMMER_WINDOW_MS / 1000.0f);
+}
+
+uint32_t Shimmer_PoolSize(float rate) {
+    return window_len(rate) + 2;
+}
+
+uint8_t Shimmer_Init(Shimmer_t* sh, Reverb_Pool_t* pools, uint32_t poolCount, float rate,
+                     ReducedRate_Process_t process, void* fx, float semitones, float feedback) {
+    sh->ready = 0;
+    sh->process = process;
+    sh->fx = fx;
+    sh->rate = rate;
+    sh->window = (float)window_len(rate);
+    sh->len = window_len(rate) + 2;
+    sh->line = Reverb_PoolListAlloc(pools, poolCount, sh->len);
+    if (sh->line == NULL) return 0;
+    sh->pos = 0;
+    sh->phase = 0;
+    memset(sh->loop, 0, sizeof(sh->loop));
+    memset(sh->lpfState, 0, sizeof(sh->lpfState));
+    Shimmer_SetPitch(sh, semitones);
+    Shimmer_SetFeedback(sh, feedback);
+    sh->ready = 1;
+    return 1;
+}
+
+void Shimmer_SetPitch(Shimmer_t* sh, float semitones) {
+    if (semitones < -24.0f) semitones = -24.0f;
+    if (semitones > 24.0f) semitones = 24.0f;
+    float ratio = powf(2.0f, semitones / 12.0f);
+    sh->inc = PitchShift_Inc(ratio, sh->window);
+
+    float fc = 0.45f * sh->rate / (ratio > 1.0f ? ratio : 1.0f);
+    if (fc > 8000.0f) fc = 8000.0f;
+    EQ_Design(sh->lpfCoeffs, EQ_LOW_PASS, fc, 0.70710678f, 0.0f, sh->rate);
+    arm_biquad_cascade_df2T_init_f32(&sh->lpf, 1, sh->lpfCoeffs, sh->lpfState);
+}
+
+void Shimmer_SetFeedback(Shimmer_t* sh, float feedback) {
+    if (feedback < 0.0f) feedback = 0.0f;
+    if (feedback > 0.9f) feedback = 0.9f;
+    sh->feedback = feedback;
+}
+
+void Shimmer_ProcessBlock(Shimmer_t* sh, float* l, float* r, uint32_t n) {
+    if (!sh->ready) {
+        sh->process(sh->fx, l, r, n);
+        return;
+    }
+    float* s = sh->loop;
+
+    // Reverb input: the dry mono sum plus last block's shifted tail
+    for (uint32_t i = 0; i < n; i++) {
+        float x = 0.5f * (l[i] + r[i]) + sh->feedback * s[i];
+        l[i] = x;
+        r[i] = x;
+    }
+    sh->process(sh->fx, l, r, n);
+
+    // The clamp only bites on a feedback above the reverb's bound (see SHIMMER_FEEDBACK)
+    for (uint32_t i = 0; i < n; i++) {
+        float x = 0.5f * (l[i] + r[i]);
+        if (x > 2.0f) x = 2.0f;
+        if (x < -2.0f) x = -2.0f;
+        s[i] = x;
+    }
+    arm_biquad_cascade_df2T_f32(&sh->lpf, s, s, n);
+
+    // Heads d and d + window/2 samples old, d = window * phase; pos is the oldest sample
+    const float scale = sh->window * (1.0f / 4294967296.0f);
+    const float newest = (float)(sh->len - 1);
+    uint32_t phase = sh->phase;
+    uint32_t pos = sh->pos;
+    for (uint32_t i = 0; i < n; i++) {
+        sh->line[pos] = s[i];
+        if (++pos == sh->len) pos = 0;
+
+        s[i] = PitchShift_Read(sh->line, sh->len, pos, newest, scale, phase);
+        phase += (uint32_t)sh->inc;
+    }
+    sh->phase = phase;
+    sh->pos = pos;
+}
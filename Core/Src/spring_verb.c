@@ -1,51 +1,123 @@
 #include "spring_verb.h"
+#include "eq.h"
 #include <string.h>
 #include <math.h>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+// Round trip times (ms) of the springs of a long tank, the last is SPRING_MAX_LEN; stereo weights
+static const uint32_t spring_delay_ms[SPRING_MAX] = {39, 47, 58, 66};
+static const float spring_gain_l[SPRING_MAX] = {1.0f, -0.8f, 0.6f, -0.5f};
+static const float spring_gain_r[SPRING_MAX] = {0.7f, 1.0f, -0.8f, 0.5f};
 
-void SpringReverb_Init(SpringReverb *rv, float *buffer, uint32_t bufferSize, float feedback, float mix) {
-    rv->delayBuffer = buffer;
-    rv->bufferSize = bufferSize;
-    rv->writePos = 0;
-    rv->feedback = feedback;
-    rv->mix = mix;
-    rv->allpass_z1 = 0.0f;
-    rv->allpass_coeff = 0.5f;
+// Loop low-pass just under the top of the dispersive band, fs / 2K
+#define SPRING_LPF_HZ (0.9f * SPRING_RATE / (2.0f * SPRING_STRETCH))
+#define SPRING_HB_K 6
+#define SPRING_HB_BETA 6.0f
+
+static uint32_t spring_len(uint32_t s) {
+    return spring_delay_ms[s] * SPRING_RATE / 1000;
+}
+
+uint32_t SpringReverb_MemSize(uint32_t springs, uint32_t sections) {
+    uint32_t size = 0;
+    for (uint32_t s = 0; s < springs && s < SPRING_MAX; s++) {
+        size += spring_len(s) + sections * SPRING_STRETCH;
+    }
+    return size;
+}
+
+uint8_t SpringReverb_Init(SpringReverb *rv, float *buffer, uint32_t bufferSize,
+                          uint32_t springs, uint32_t sections, float rt60_s, float mix) {
+    rv->springs = 0;
+    if (springs < 1 || springs > SPRING_MAX || sections > SPRING_MAX_SECTIONS) return 0;
+    if (SpringReverb_MemSize(springs, sections) > bufferSize) return 0;
     memset(buffer, 0, bufferSize * sizeof(float));
+
+    for (uint32_t s = 0; s < springs; s++) {
+        SpringLine *sp = &rv->spring[s];
+        sp->len = spring_len(s);
+        sp->line = buffer;
+        sp->pos = 0;
+        sp->state = buffer + sp->len;
+        buffer += sp->len + sections * SPRING_STRETCH;
+        sp->gainL = spring_gain_l[s];
+        sp->gainR = spring_gain_r[s];
+        EQ_Design(sp->lpfCoeffs, EQ_LOW_PASS, SPRING_LPF_HZ, 0.70710678f, 0.0f, (float)SPRING_RATE);
+        arm_biquad_cascade_df2T_init_f32(&sp->lpf, 1, sp->lpfCoeffs, sp->lpfState);
+    }
+    HalfBand_Init(&rv->down, SPRING_HB_K, SPRING_HB_BETA);
+    HalfBand_Init(&rv->upL, SPRING_HB_K, SPRING_HB_BETA);
+    HalfBand_Init(&rv->upR, SPRING_HB_K, SPRING_HB_BETA);
+
+    rv->springs = springs;
+    rv->sections = sections;
+    SpringReverb_SetParams(rv, rt60_s, mix, 0.6f);
+    return 1;
 }
 
-void SpringReverb_SetParams(SpringReverb *rv, float feedback, float mix, float allpass_ms, float fs) {
-    rv->feedback = feedback;
+void SpringReverb_SetParams(SpringReverb *rv, float rt60_s, float mix, float dispersion) {
+    if (dispersion < 0.0f) dispersion = 0.0f;
+    if (dispersion > 0.9f) dispersion = 0.9f;
+    rv->a = dispersion;
     rv->mix = mix;
-    float delaySamples = (allpass_ms / 1000.0f) * fs;
-    // Convert to allpass coefficient
-    rv->allpass_coeff = (delaySamples - 1.0f) / (delaySamples + 1.0f);
+    for (uint32_t s = 0; s < rv->springs; s++) {
+        SpringLine *sp = &rv->spring[s];
+        sp->g = powf(10.0f, -3.0f * (float)sp->len / (rt60_s * SPRING_RATE));
+    }
 }
 
-static inline float allpass_process(SpringReverb *rv, float x) {
-    float y = -rv->allpass_coeff * x + rv->allpass_z1;
-    rv->allpass_z1 = x + rv->allpass_coeff * y;
-    return y;
+/*Stretched allpasses in direct form II, one section over the whole block at a time:
+v[n] = x[n] - a v[n-K], y[n] = a v[n] + v[n-K]. w holds the K states ahead of the
+block so the inner loop has no wrap; the last K values are the next states.*/
+static void allpass_cascade(float *state, uint32_t sections, float a, float *x, float *w, uint32_t m) {
+    for (uint32_t s = 0; s < sections; s++, state += SPRING_STRETCH) {
+        for (uint32_t k = 0; k < SPRING_STRETCH; k++) w[k] = state[k];
+        for (uint32_t i = 0; i < m; i++) {
+            float v = x[i] - a * w[i];
+            w[i + SPRING_STRETCH] = v;
+            x[i] = a * v + w[i];
+        }
+        for (uint32_t k = 0; k < SPRING_STRETCH; k++) state[k] = w[m + k];
+    }
 }
 
-float SpringReverb_ProcessSample(SpringReverb *rv, float in) {
-    // Read position (circular buffer)
-    uint32_t readPos = (rv->writePos + 1) % rv->bufferSize;
-    float delayed = rv->delayBuffer[readPos];
+void SpringReverb_ProcessBlock(SpringReverb *rv, float *l, float *r, uint32_t n) {
+    if (rv->springs == 0) return;
+    const uint32_t m = n / 2;
+    const float dry = 1.0f - rv->mix;
+
+    for (uint32_t i = 0; i < n; i++) {
+        rv->outL[i] = 0.5f * (l[i] + r[i]);
+    }
+    HalfBand_Down(&rv->down, rv->outL, rv->x, m);
+    memset(rv->outL, 0, m * sizeof(float));
+    memset(rv->outR, 0, m * sizeof(float));
 
-    // Apply allpass (spring "boingy" feel)
-    delayed = allpass_process(rv, delayed);
+    for (uint32_t s = 0; s < rv->springs; s++) {
+        SpringLine *sp = &rv->spring[s];
+        uint32_t pos = sp->pos;
 
-    // Feedback into delay buffer
-    rv->delayBuffer[rv->writePos] = in + delayed * rv->feedback;
+        // Input plus the decayed round trip, read before the block overwrites it
+        for (uint32_t i = 0; i < m; i++) {
+            rv->u[i] = rv->x[i] + sp->g * sp->line[pos];
+            if (++pos == sp->len) pos = 0;
+        }
+        allpass_cascade(sp->state, rv->sections, rv->a, rv->u, rv->w, m);
+        arm_biquad_cascade_df2T_f32(&sp->lpf, rv->u, rv->u, m);
 
-    // Advance circular buffer
-    rv->writePos++;
-    if (rv->writePos >= rv->bufferSize) rv->writePos = 0;
+        pos = sp->pos;
+        for (uint32_t i = 0; i < m; i++) {
+            sp->line[pos] = rv->u[i];
+            if (++pos == sp->len) pos = 0;
+            rv->outL[i] += sp->gainL * rv->u[i];
+            rv->outR[i] += sp->gainR * rv->u[i];
+        }
+        sp->pos = pos;
+    }
 
-    // Mix dry + wet
-    return (1.0f - rv->mix) * in + rv->mix * delayed;
+    HalfBand_Up(&rv->upL, rv->outL, rv->outL, m);
+    HalfBand_Up(&rv->upR, rv->outR, rv->outR, m);
+    for (uint32_t i = 0; i < n; i++) {
+        l[i] = dry * l[i] + rv->mix * rv->outL[i];
+        r[i] = dry * r[i] + rv->mix * rv->outR[i];
+    }
 }
@@ -0,0 +1,57 @@
+#include "tpt.h"
+
+void TPT_SVF_Bandpass(TPT_SVF_t* fl, TPT_SVF_t* fr, float mix, float* l, float* r, uint32_t n) {
+    const float a1 = fl->a1, a2 = fl->a2, a3 = fl->a3;
+    const float b1 = fr->a1, b2 = fr->a2, b3 = fr->a3;
+    const float gl = mix * fl->k, gr = mix * fr->k;
+    float ic1l = fl->ic1, ic2l = fl->ic2;
+    float ic1r = fr->ic1, ic2r = fr->ic2;
+
+    for (uint32_t i = 0; i < n; i++) {
+        float v3l = l[i] - ic2l;
+        float v3r = r[i] - ic2r;
+        float v1l = a1 * ic1l + a2 * v3l;  // band pass, peak gain Q
+        float v1r = b1 * ic1r + b2 * v3r;
+        float v2l = ic2l + a2 * ic1l + a3 * v3l;
+        float v2r = ic2r + b2 * ic1r + b3 * v3r;
+        ic1l = 2.0f * v1l - ic1l;
+        ic1r = 2.0f * v1r - ic1r;
+        ic2l = 2.0f * v2l - ic2l;
+        ic2r = 2.0f * v2r - ic2r;
+        l[i] += gl * v1l - mix * l[i];
+        r[i] += gr * v1r - mix * r[i];
+    }
+    fl->ic1 = ic1l;
+    fl->ic2 = ic2l;
+    fr->ic1 = ic1r;
+    fr->ic2 = ic2r;
+}
+
+void TPT_AllpassChain(float* sl, float* sr, uint32_t stages, float gl, float gr, float feedback,
+                      float mix, float* last, float* l, float* r, uint32_t n) {
+    const float Gl = gl / (1.0f + gl);
+    const float Gr = gr / (1.0f + gr);
+    float yl = last[0], yr = last[1];
+
+    // Both channels in one pass: the stages are a serial chain, the other channel fills its latency
+    for (uint32_t i = 0; i < n; i++) {
+        float al = l[i] + feedback * yl;
+        float ar = r[i] + feedback * yr;
+        for (uint32_t k = 0; k < stages; k++) {
+            float vl = (al - sl[k]) * Gl;
+            float vr = (ar - sr[k]) * Gr;
+            float lpl = vl + sl[k];
+            float lpr = vr + sr[k];
+            sl[k] = lpl + vl;
+            sr[k] = lpr + vr;
+            al = 2.0f * lpl - al;
+            ar = 2.0f * lpr - ar;
+        }
+        yl = al;
+        yr = ar;
+        l[i] += mix * (yl - l[i]);
+        r[i] += mix * (yr - r[i]);
+    }
+    last[0] = yl;
+    last[1] = yr;
+}
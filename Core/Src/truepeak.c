@@ -0,0 +1,204 @@
+#include "truepeak.h"
+#include "kaiser.h"
+#include "arm_math.h"
+#include <string.h>
+#include <math.h>
+
+#define TP_BETA 6.0f
+#define TP_H (TP_TAPS / 2)
+
+// Windowed sinc at distance d samples, window half width TP_H
+static float tap(float d) {
+    return Kaiser_Sinc(d, 1.0f, (float)TP_H, TP_BETA);
+}
+
+void TruePeak_Init(TruePeak_t* tp, float sample_rate, float ceiling_dB, float release_ms, uint32_t lookahead) {
+    memset(tp, 0, sizeof(TruePeak_t));
+    if (lookahead > TP_MAX_LOOKAHEAD) lookahead = TP_MAX_LOOKAHEAD;
+    tp->ceiling = powf(10.0f, ceiling_dB / 20.0f);
+    tp->releaseCoeff = release_ms > 0.0f ? 1.0f - expf(-1000.0f / (release_ms * sample_rate)) : 1.0f;
+    tp->lookahead = lookahead;
+    tp->delay = TP_H + lookahead;
+
+    // hist[k] sits k - (TP_H - 1) samples after the interval start
+    float c1[TP_TAPS], c2[TP_TAPS];
+    float s1 = 0.0f, s2 = 0.0f;
+    for (uint32_t k = 0; k < TP_TAPS; k++) {
+        float pos = (float)k - (float)(TP_H - 1);
+        c1[k] = tap(0.25f - pos);
+        c2[k] = tap(0.5f - pos);
+        s1 += c1[k];
+        s2 += c2[k];
+    }
+    float l1 = 0.0f, l2 = 0.0f;
+    for (uint32_t k = 0; k < TP_H; k++) {
+        float a = c1[k] / s1;
+        float b = c1[TP_TAPS - 1 - k] / s1;
+        tp->even[k] = 0.5f * (a + b);
+        tp->odd[k] = 0.5f * (a - b);
+        tp->half[k] = c2[k] / s2;
+        l1 += fabsf(a) + fabsf(b);
+        l2 += 2.0f * fabsf(tp->half[k]);
+    }
+    // Largest interpolated value a window of samples up to 1 in magnitude can reach
+    tp->reach = l1 > l2 ? l1 : l2;
+    if (tp->reach < 1.0f) tp->reach = 1.0f;
+
+    for (uint32_t k = 0; k < TP_MAX_LOOKAHEAD + 2; k++) tp->req[k] = 1.0f;
+    for (uint32_t k = 0; k < TP_MAX_LOOKAHEAD + 1; k++) tp->avg[k] = 1.0f;
+    tp->held = 1.0f;
+    tp->env = 1.0f;
+    tp->minGain = 1.0f;
+    tp->idle = 1;
+}
+
+uint32_t TruePeak_Latency(const TruePeak_t* tp) {
+    return tp->delay;
+}
+
+float TruePeak_Detect(const TruePeak_t* tp, const float* x) {
+    float y1 = 0.0f, y2 = 0.0f, y3 = 0.0f;
+    for (uint32_t k = 0; k < TP_H; k++) {
+        float u = x[k] + x[TP_TAPS - 1 - k];
+        float v = x[k] - x[TP_TAPS - 1 - k];
+        float e = tp->even[k] * u;
+        float o = tp->odd[k] * v;
+        y1 += e + o;
+        y3 += e - o;
+        y2 += tp->half[k] * u;
+    }
+    float p = fabsf(x[TP_H - 1]);
+    y1 = fabsf(y1); y2 = fabsf(y2); y3 = fabsf(y3);
+    if (y1 > p) p = y1;
+    if (y2 > p) p = y2;
+    if (y3 > p) p = y3;
+    return p;
+}
+
+// Minimum of the ring, and how many frames ago it was written
+static void rescan(TruePeak_t* tp) {
+    const uint32_t W = tp->lookahead + 2;
+    uint32_t p = tp->reqPos;
+    float m = 1.0f;
+    uint32_t age = 0;
+    for (uint32_t a = 0; a < W; a++) {
+        p = (p == 0 ? W : p) - 1;
+        if (tp->req[p] < m) {
+            m = tp->req[p];
+            age = a;
+        }
+    }
+    tp->held = m;
+    tp->heldAge = age;
+}
+
+static inline void pack(uint16_t* tx, float x) {
+    int32_t s = __SSAT((int32_t)lrintf(x * TP_INT24_SCALE), 24);
+    uint32_t w = (uint32_t)s << 8;
+    tx[0] = (uint16_t)(w >> 16);
+    tx[1] = (uint16_t)(w & 0xFFFF);
+}
+
+// Frame in, the frame TP_H + L back out at gain g, packed into tx[0..3]
+static inline void play(TruePeak_t* tp, float l, float r, float g, uint16_t* tx) {
+    uint32_t d = tp->delayPos;
+    float ol = tp->delayL[d];
+    float or_ = tp->delayR[d];
+    tp->delayL[d] = l;
+    tp->delayR[d] = r;
+    if (++d == tp->delay) d = 0;
+    tp->delayPos = d;
+
+    pack(&tx[0], g * ol);
+    pack(&tx[2], g * or_);
+}
+
+void TruePeak_ProcessBlock(TruePeak_t* tp, const float* l, const float* r, uint16_t* tx, uint32_t n) {
+    const uint32_t W = tp->lookahead + 2;
+    const uint32_t A = tp->lookahead + 1;
+    const float invA = 1.0f / (float)A;
+    const float ceiling = tp->ceiling;
+    float minGain = 1.0f;
+
+    memcpy(&tp->histL[TP_TAPS - 1], l, n * sizeof(float));
+    memcpy(&tp->histR[TP_TAPS - 1], r, n * sizeof(float));
+
+    if (tp->idle) {
+        float pl, pr;
+        uint32_t at;
+        arm_absmax_f32(tp->histL, TP_TAPS - 1 + n, &pl, &at);
+        arm_absmax_f32(tp->histR, TP_TAPS - 1 + n, &pr, &at);
+        if ((pl > pr ? pl : pr) * tp->reach <= ceiling) {
+            // No interval of the block can reach the ceiling: delay and pack at unity
+            for (uint32_t i = 0; i < n; i++) {
+                play(tp, l[i], r[i], 1.0f, &tx[4 * i]);
+            }
+            memmove(tp->histL, &tp->histL[n], (TP_TAPS - 1) * sizeof(float));
+            memmove(tp->histR, &tp->histR[n], (TP_TAPS - 1) * sizeof(float));
+            tp->minGain = 1.0f;
+            return;
+        }
+    }
+
+    float sum = (float)A;
+    if (!tp->idle) {
+        arm_mean_f32(tp->avg, A, &sum);
+        sum *= (float)A;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        // Gain the interval that just became visible asks for
+        float pl = TruePeak_Detect(tp, &tp->histL[i]);
+        float pr = TruePeak_Detect(tp, &tp->histR[i]);
+        float pk = pl > pr ? pl : pr;
+        float g = 1.0f;
+
+        // Idle, every ring holds unity: an interval under the ceiling changes nothing
+        if (!tp->idle || pk > ceiling) {
+            tp->idle = 0;
+            float q = pk > ceiling ? ceiling / pk : 1.0f;
+
+            tp->req[tp->reqPos] = q;
+            if (++tp->reqPos == W) tp->reqPos = 0;
+            if (q <= tp->held) {
+                tp->held = q;
+                tp->heldAge = 0;
+            } else if (++tp->heldAge >= W) {
+                rescan(tp);
+            }
+
+            float env = tp->env;
+            if (tp->held < env) {
+                env = tp->held;
+            } else {
+                // The release stalls a few ulp short of its target, finish it there
+                float next = env + tp->releaseCoeff * (tp->held - env);
+                env = next == env ? tp->held : next;
+            }
+            tp->env = env;
+            sum += env - tp->avg[tp->avgPos];
+            tp->avg[tp->avgPos] = env;
+            if (++tp->avgPos == A) tp->avgPos = 0;
+            g = sum * invA;
+            if (g < minGain) minGain = g;
+
+            // Back to idle once the average has held unity for a whole look-ahead
+            if (env == 1.0f && tp->held == 1.0f) {
+                if (++tp->quiet >= A) {
+                    tp->idle = 1;
+                    tp->quiet = 0;
+                    sum = (float)A;
+                    g = 1.0f;
+                }
+            } else {
+                tp->quiet = 0;
+            }
+        }
+
+        play(tp, l[i], r[i], g, &tx[4 * i]);
+    }
+
+    memmove(tp->histL, &tp->histL[n], (TP_TAPS - 1) * sizeof(float));
+    memmove(tp->histR, &tp->histR[n], (TP_TAPS - 1) * sizeof(float));
+    tp->minGain = minGain;
+}
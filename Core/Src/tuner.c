@@ -0,0 +1,188 @@
+#include "tuner.h"
+#include "kaiser.h"
+#include "SEGGER_SYSVIEW.h"
+#include <string.h>
+#include <math.h>
+
+#define TUNER_BETA 5.0f
+#define TUNER_CUTOFF_HZ 4500.0f
+#define TUNER_MAX_PEAKS 16
+
+enum {
+    TUNER_STEP_SNAPSHOT,
+    TUNER_STEP_FORWARD,
+    TUNER_STEP_INVERSE,
+    TUNER_STEP_PICK,
+    TUNER_STEP_REPORT
+};
+
+static const char* const note_names[12] = {
+    "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
+};
+
+void Tuner_Init(Tuner_t* t, float a4, float min_dB) {
+    memset(t, 0, sizeof(Tuner_t));
+    t->rate = (float)SAMPLE_RATE / TUNER_DECIMATION;
+    t->a4 = a4;
+    t->minPower = powf(10.0f, min_dB / 10.0f);
+    arm_rfft_fast_init_f32(&t->fft, TUNER_FFT);
+
+    // Anti-alias low-pass for the decimation, Kaiser windowed sinc, unity DC gain
+    const float wc = 2.0f * TUNER_CUTOFF_HZ / (float)SAMPLE_RATE;
+    const float half = (float)(TUNER_FIR_TAPS - 1) * 0.5f;
+    float sum = 0.0f;
+    for (uint32_t k = 0; k < TUNER_FIR_TAPS; k++) {
+        t->fir[k] = Kaiser_Sinc((float)k - half, wc, half, TUNER_BETA);
+        sum += t->fir[k];
+    }
+    for (uint32_t k = 0; k < TUNER_FIR_TAPS; k++) {
+        t->fir[k] /= sum;
+    }
+}
+
+void Tuner_Push(Tuner_t* t, const float* x, uint32_t n) {
+    uint32_t first = TUNER_RING - t->pos;
+    if (first > n) first = n;
+    memcpy(&t->ring[t->pos], x, first * sizeof(float));
+    memcpy(t->ring, &x[first], (n - first) * sizeof(float));
+    t->pos = (t->pos + n) & (TUNER_RING - 1);
+    t->fresh += n;
+}
+
+const Tuner_Result_t* Tuner_GetResult(const Tuner_t* t) {
+    return &t->result;
+}
+
+// Decimated window into x, zero padded; the NSDF denominators; 0 if too quiet
+static uint8_t snapshot(Tuner_t* t) {
+    const uint32_t start = t->pos; // oldest sample
+    float* x = t->x;
+
+    for (uint32_t j = 0; j < TUNER_WINDOW; j++) {
+        uint32_t p = start + j * TUNER_DECIMATION;
+        float acc = 0.0f;
+        for (uint32_t k = 0; k < TUNER_FIR_TAPS; k++) {
+            acc += t->fir[k] * t->ring[(p + k) & (TUNER_RING - 1)];
+        }
+        x[j] = acc;
+    }
+    memset(&x[TUNER_WINDOW], 0, (TUNER_FFT - TUNER_WINDOW) * sizeof(float));
+
+    // m(tau) = sum over the overlap of x[j]^2 + x[j + tau]^2
+    float e;
+    arm_power_f32(x, TUNER_WINDOW, &e);
+    t->m[0] = 2.0f * e;
+    for (uint32_t tau = 1; tau <= TUNER_MAX_LAG; tau++) {
+        float a = x[tau - 1];
+        float b = x[TUNER_WINDOW - tau];
+        t->m[tau] = t->m[tau - 1] - a * a - b * b;
+    }
+    return e / (float)TUNER_WINDOW >= t->minPower;
+}
+
+static void report(Tuner_t* t) {
+    const Tuner_Result_t* res = &t->result;
+    if (!res->valid) {
+        SEGGER_SYSVIEW_PrintfHost("TUNER --");
+        return;
+    }
+    int32_t c = (int32_t)lrintf(res->cents);
+    uint32_t hz10 = (uint32_t)lrintf(res->hz * 10.0f);
+    SEGGER_SYSVIEW_PrintfHost("TUNER %s%d %s%d cents, %u.%u Hz, clarity %u%%",
+                              note_names[res->note % 12], res->note / 12 - 1, c < 0 ? "" : "+", c,
+                              hz10 / 10u, hz10 % 10u, (uint32_t)(res->clarity * 100.0f));
+}
+
+// NSDF into X, first key maximum above TUNER_PEAK_K of the highest, parabolic refinement
+static void pick(Tuner_t* t) {
+    float* n = t->X;
+    Tuner_Result_t* res = &t->result;
+    const uint32_t minLag = (uint32_t)(t->rate / TUNER_MAX_HZ);
+
+    for (uint32_t tau = 0; tau <= TUNER_MAX_LAG; tau++) {
+        n[tau] = t->m[tau] > 0.0f ? 2.0f * t->x[tau] / t->m[tau] : 0.0f;
+    }
+
+    uint32_t peak[TUNER_MAX_PEAKS];
+    uint32_t peaks = 0;
+    float highest = 0.0f;
+    uint32_t tau = 1;
+    while (tau < TUNER_MAX_LAG && n[tau] > 0.0f) tau++; // past the lobe at lag 0
+    while (tau < TUNER_MAX_LAG && peaks < TUNER_MAX_PEAKS) {
+        while (tau < TUNER_MAX_LAG && n[tau] <= 0.0f) tau++;
+        uint32_t best = tau;
+        while (tau < TUNER_MAX_LAG && n[tau] > 0.0f) {
+            if (n[tau] > n[best]) best = tau;
+            tau++;
+        }
+        if (best >= minLag && best < TUNER_MAX_LAG && n[best] > 0.0f) {
+            peak[peaks++] = best;
+            if (n[best] > highest) highest = n[best];
+        }
+    }
+
+    res->valid = 0;
+    for (uint32_t p = 0; p < peaks; p++) {
+        uint32_t k = peak[p];
+        if (n[k] < TUNER_PEAK_K * highest) continue;
+        float a = n[k - 1], b = n[k], c = n[k + 1];
+        float den = a - 2.0f * b + c;
+        float d = den != 0.0f ? 0.5f * (a - c) / den : 0.0f;
+        float clarity = b - 0.25f * (a - c) * d;
+        if (clarity < TUNER_MIN_CLARITY) break;
+
+        res->hz = t->rate / ((float)k + d);
+        float midi = 69.0f + 12.0f * log2f(res->hz / t->a4);
+        res->note = (int32_t)lrintf(midi);
+        res->cents = 100.0f * (midi - (float)res->note);
+        res->clarity = clarity > 1.0f ? 1.0f : clarity;
+        res->valid = res->note >= 0;
+        break;
+    }
+}
+
+uint8_t Tuner_Background(Tuner_t* t) {
+    switch (t->step) {
+        case TUNER_STEP_SNAPSHOT:
+            if (t->fresh < TUNER_HOP) return 0;
+            t->sinceReport += t->fresh;
+            t->fresh = 0;
+            if (snapshot(t)) {
+                t->step = TUNER_STEP_FORWARD;
+            } else {
+                t->result.valid = 0;
+                t->step = TUNER_STEP_REPORT;
+            }
+            break;
+        case TUNER_STEP_FORWARD:
+            arm_rfft_fast_f32(&t->fft, t->x, t->X, 0);
+            t->step++;
+            break;
+        case TUNER_STEP_INVERSE: {
+            // Packed format: X[0] DC, X[1] Nyquist, then re/im pairs
+            float* X = t->X;
+            X[0] *= X[0];
+            X[1] *= X[1];
+            for (uint32_t k = 2; k < TUNER_FFT; k += 2) {
+                X[k] = X[k] * X[k] + X[k + 1] * X[k + 1];
+                X[k + 1] = 0.0f;
+            }
+            arm_rfft_fast_f32(&t->fft, X, t->x, 1);
+            t->step++;
+            break;
+        }
+        case TUNER_STEP_PICK:
+            pick(t);
+            t->step++;
+            break;
+        case TUNER_STEP_REPORT:
+        default:
+            if (t->sinceReport * 1000u >= TUNER_REPORT_MS * (uint32_t)SAMPLE_RATE) {
+                t->sinceReport = 0;
+                report(t);
+            }
+            t->step = TUNER_STEP_SNAPSHOT;
+            break;
+    }
+    return 1;
+}
@@ -0,0 +1,24 @@
+#include "waveshaper.h"
+
+void Waveshaper_Init(Waveshaper_t* ws, WS_Curve_t curve, WS_Interp_t interp) {
+    if (curve >= WS_CURVE_COUNT) {
+        curve = WS_CURVE_TANH;
+    }
+    ws->table = &ws_tables[curve];
+    ws->interp = interp;
+}
+
+void Waveshaper_ProcessBlock(const Waveshaper_t* ws, const float* in, float* out, uint32_t n) {
+    const WS_Table_t* t = ws->table;
+
+    // Interpolation is chosen once per block, the loops stay branch free
+    if (ws->interp == WS_INTERP_CUBIC) {
+        for (uint32_t i = 0; i < n; i++) {
+            out[i] = WS_LookupCubic(t, in[i]);
+        }
+    } else {
+        for (uint32_t i = 0; i < n; i++) {
+            out[i] = WS_LookupLinear(t, in[i]);
+        }
+    }
+}
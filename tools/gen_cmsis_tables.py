@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Generate the CMSIS-DSP float tables the vendored tree is missing.
+
+Drivers/CMSIS/DSP ships without Source/CommonTables/arm_common_tables.c, so the
+cmsis_dsp library builds the tables it needs here. Only the real FFT lengths
+passed with --rfft are emitted (plus the complex FFT of half that length they run
+on); the matching ARM_TABLE_* switches are set by cmake/cmsis_dsp/CMakeLists.txt
+with ARM_DSP_CONFIG_TABLES, so arm_const_structs.c and the init functions only
+reference tables that exist.
+
+Float CFFT layout (arm_cfft_f32): lengths 8^k run the radix-8 butterfly directly,
+2*8^k and 4*8^k first split into 2 or 4 interleaved sub-FFTs. Bin m = p*q + h then
+ends up at h*(N/p) + octal_reverse(q), and the bit reversal table is that
+permutation written as a sequence of swaps (byte offsets of complex samples).
+"""
+import argparse
+import math
+import os
+
+FAST_MATH_TABLE_SIZE = 512  # arm_math_types.h
+
+def cfft_permutation(n):
+    k = n.bit_length() - 1
+    split = (1, 2, 4)[k % 3]
+    sub = n // split
+    digits = (k - k % 3) // 3
+
+    def octal_reverse(q):
+        r = 0
+        for _ in range(digits):
+            r = r * 8 + q % 8
+            q //= 8
+        return r
+
+    return [(m % split) * sub + octal_reverse(m // split) for m in range(n)]
+
+def bitrev_swaps(n):
+    """Gather out[m] = in[pos[m]] in place, one swap per cycle step."""
+    pos = cfft_permutation(n)
+    done = [False] * n
+    table = []
+    for s in range(n):
+        j = s
+        while not done[j]:
+            done[j] = True
+            if pos[j] != s:
+                table += [j * 8, pos[j] * 8]
+            j = pos[j]
+    return table
+
+def cfft_twiddles(n):
+    vals = []
+    for i in range(n):
+        vals += [math.cos(2.0 * math.pi * i / n), math.sin(2.0 * math.pi * i / n)]
+    return vals
+
+def rfft_twiddles(n):
+    """Split stage factor j*exp(-j*2*pi*i/n), stored as (sin, cos)."""
+    vals = []
+    for i in range(n // 2):
+        vals += [math.sin(2.0 * math.pi * i / n), math.cos(2.0 * math.pi * i / n)]
+    return vals
+
+def write_array(out, ctype, name, vals, fmt, per_line):
+    out.write("const %s %s[%d] = {\n" % (ctype, name, len(vals)))
+    for i in range(0, len(vals), per_line):
+        out.write("    " + ", ".join(fmt % v for v in vals[i:i + per_line]) + ",\n")
+    out.write("};\n\n")
+
+def write_source(path, rfft_lengths):
+    with open(path, 'w') as out:
+        out.write("/* Generated by tools/gen_cmsis_tables.py, do not edit */\n")
+        out.write('#include "arm_math_types.h"\n#include "arm_common_tables.h"\n\n')
+        for n in sorted({L // 2 for L in rfft_lengths}):
+            write_array(out, "float32_t", "twiddleCoef_%d" % n, cfft_twiddles(n), "%.9ef", 6)
+            write_array(out, "uint16_t", "armBitRevIndexTable%d" % n, bitrev_swaps(n), "%d", 12)
+        for L in sorted(rfft_lengths):
+            write_array(out, "float32_t", "twiddleCoef_rfft_%d" % L, rfft_twiddles(L), "%.9ef", 6)
+        sines = [math.sin(2.0 * math.pi * i / FAST_MATH_TABLE_SIZE) for i in range(FAST_MATH_TABLE_SIZE + 1)]
+        write_array(out, "float32_t", "sinTable_f32", sines, "%.9ef", 6)
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__)
+    ap.add_argument("--out", required=True, help="output directory")
+    ap.add_argument("--rfft", type=int, nargs="+", required=True,
+                    help="arm_rfft_fast_f32 lengths (32..4096, powers of two)")
+    args = ap.parse_args()
+
+    for L in args.rfft:
+        if L < 32 or L > 4096 or L & (L - 1):
+            raise SystemExit("unsupported rfft length %d" % L)
+    os.makedirs(args.out, exist_ok=True)
+    write_source(os.path.join(args.out, "cmsis_dsp_tables.c"), args.rfft)
+
+if __name__ == "__main__":
+    main()
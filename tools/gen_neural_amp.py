@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+"""Quantise a GRU amp model into the flash blob read by Core/Src/neural_amp.c.
+
+The model is a single layer GRU (input 1, hidden 8..16) followed by a linear output
+layer, optionally added to the input (skip). Weights are read from the JSON format of
+Automated-GuitarAmpModelling / GuitarML ("model_data" + PyTorch "state_dict" with
+rec.weight_ih_l0, rec.weight_hh_l0, rec.bias_ih_l0, rec.bias_hh_l0, lin.weight,
+lin.bias). Without --model a built-in demo model is used: a chain of saturating
+stages with level dependent smoothing, no training data required.
+
+Fixed point layout (matches neural_amp.c, power-of-two scales for the CMSIS-NN q15
+kernels): audio, hidden state and gates in Q15, gate pre-activations in
+Q(15 - ACT_INT_BITS). Each weight matrix gets the largest Q format that holds its
+values and cannot overflow the 32-bit accumulator.
+
+--report runs the float model and a bit exact model of the integer inference on a
+test signal and prints per-sample MACs, a cycle estimate and the error. The measured
+cycles come from the DSP_BENCH_ENABLE bench on the target ("BENCH nam").
+"""
+import argparse
+import json
+import math
+import os
+import re
+import struct
+
+MAGIC = 0x314D414E  # "NAM1"
+ACT_INT_BITS = 3    # CMSIS-NN q15 activation tables span +-8
+ACC_BITS = 31
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+NNTABLES = os.path.join(HERE, "..", "Drivers", "CMSIS", "NN", "Source", "NNSupportFunctions", "arm_nntables.c")
+
+# ---------- Models ----------
+
+def load_model(path):
+    with open(path) as f:
+        js = json.load(f)
+    md = js.get("model_data", {})
+    sd = js["state_dict"]
+    if md.get("unit_type", "GRU") != "GRU" or md.get("num_layers", 1) != 1 or md.get("input_size", 1) != 1:
+        raise SystemExit("%s: only single layer GRU models with one input are supported" % path)
+    H = len(sd["rec.weight_hh_l0"][0])
+    return {
+        "H": H,
+        "w_ih": [row[0] for row in sd["rec.weight_ih_l0"]],  # 3H, gates r, z, n
+        "w_hh": sd["rec.weight_hh_l0"],                       # 3H x H
+        "b_ih": sd["rec.bias_ih_l0"],
+        "b_hh": sd["rec.bias_hh_l0"],
+        "w_out": sd["lin.weight"][0],
+        "b_out": sd["lin.bias"][0],
+        "skip": int(md.get("skip", 0)),
+    }
+
+def demo_model(H):
+    """Stage i = tanh(g_i x + c h_(i-1) + bias_i), smoothed by z (more with level)."""
+    w_ih, b_ih = [0.0] * (3 * H), [0.0] * (3 * H)
+    b_hh = [0.0] * (3 * H)
+    w_hh = [[0.0] * H for _ in range(3 * H)]
+    w_out = [0.0] * H
+    for i in range(H):
+        t = i / max(1, H - 1)
+        b_ih[i] = 4.0                                   # r ~ 1
+        a = 0.2 + 0.7 * t                               # one pole memory of the stage
+        b_ih[H + i] = math.log(a / (1.0 - a))
+        w_ih[H + i] = 0.5                               # sag: louder input, slower stage
+        w_ih[2 * H + i] = 1.5 * (4.0 ** t)              # drive 1.5 .. 6
+        b_ih[2 * H + i] = 0.25 if i % 2 else -0.15      # asymmetry, even harmonics
+        if i > 0:
+            w_hh[2 * H + i][i - 1] = 1.2                # cascade from the previous stage
+        w_out[i] = (0.5 / H) * (1.0 + 0.5 * math.cos(i))
+    b_out = -sum(w_out[i] * math.tanh(b_ih[2 * H + i]) for i in range(H))
+    return {"H": H, "w_ih": w_ih, "w_hh": w_hh, "b_ih": b_ih, "b_hh": b_hh,
+            "w_out": w_out, "b_out": b_out, "skip": 0}
+
+def float_step(m, h, x):
+    H = m["H"]
+    sig = lambda v: 1.0 / (1.0 + math.exp(-v))
+    g = [m["w_ih"][k] * x + m["b_ih"][k] for k in range(3 * H)]
+    gh = [sum(m["w_hh"][k][j] * h[j] for j in range(H)) + m["b_hh"][k] for k in range(3 * H)]
+    out = []
+    for i in range(H):
+        r = sig(g[i] + gh[i])
+        z = sig(g[H + i] + gh[H + i])
+        n = math.tanh(g[2 * H + i] + r * gh[2 * H + i])
+        out.append((1.0 - z) * n + z * h[i])
+    y = sum(m["w_out"][j] * out[j] for j in range(H)) + m["b_out"]
+    return out, y + (x if m["skip"] else 0.0)
+
+# ---------- Quantisation ----------
+
+def frac_bits(values, bits, rowsums=None, in_frac=15):
+    """Largest Q format that holds the values and keeps the accumulator in range."""
+    qmax = (1 << (bits - 1)) - 1
+    peak = max([abs(v) for v in values] + [1e-9])
+    f = int(math.floor(math.log2(qmax / peak)))
+    if rowsums is not None:
+        # |sum w v| < 2^(31 - in_frac - f) with |v| <= 1
+        f = min(f, int(math.floor(ACC_BITS - in_frac - math.log2(max(rowsums) + 1e-9))) - 1)
+    return min(f, 15)
+
+def quant(values, f, bits):
+    qmax = (1 << (bits - 1)) - 1
+    return [max(-qmax - 1, min(qmax, int(round(v * (1 << f))))) for v in values]
+
+def quantize(m, bits):
+    H = m["H"]
+    pre_frac = 15 - ACT_INT_BITS
+    # Gate FC on [h, x]: r and z take both biases, the candidate row only its hidden part
+    rec_w = []
+    for k in range(3 * H):
+        rec_w.append(list(m["w_hh"][k]) + [m["w_ih"][k] if k < 2 * H else 0.0])
+    rec_b = [m["b_ih"][k] + m["b_hh"][k] if k < 2 * H else m["b_hh"][k] for k in range(3 * H)]
+    in_w = m["w_ih"][2 * H:]
+    in_b = m["b_ih"][2 * H:]
+
+    layers = {}
+    for name, w, b, dim_out_frac in (("rec", rec_w, rec_b, pre_frac),
+                                     ("in", [[v] for v in in_w], in_b, pre_frac),
+                                     ("out", [list(m["w_out"])], [m["b_out"]], 15)):
+        flat = [v for row in w for v in row]
+        rows = [sum(abs(v) for v in row) + abs(bb) for row, bb in zip(w, b)]
+        wf = frac_bits(flat, bits, rows)
+        bf = min(frac_bits(b, bits), wf + 15)
+        out_shift = wf + 15 - dim_out_frac
+        if out_shift < 1:
+            raise SystemExit("%s layer: weights too large for the fixed point layout" % name)
+        layers[name] = {"w": quant(flat, wf, bits), "b": quant(b, bf, bits),
+                        "bias_shift": wf + 15 - bf, "out_shift": out_shift}
+    return {"H": H, "bits": bits, "skip": m["skip"], "layers": layers}
+
+# ---------- Bit exact integer model of neural_amp.c ----------
+
+def load_tables(path):
+    with open(path) as f:
+        src = f.read()
+    tables = {}
+    for name in ("sigmoidTable_q15", "tanhTable_q15"):
+        body = re.search(name + r"\[256\]\s*=\s*\{([^}]*)\}", src).group(1)
+        vals = [int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]+", body)]
+        tables[name] = [v - 0x10000 if v >= 0x8000 else v for v in vals]
+    return tables
+
+def sat16(v):
+    return max(-32768, min(32767, v))
+
+def fc(v, w, b, rows, bias_shift, out_shift):
+    dim = len(v)
+    rnd = 1 << (out_shift - 1)
+    return [sat16(((b[i] << bias_shift) + rnd + sum(v[j] * w[i * dim + j] for j in range(dim))) >> out_shift)
+            for i in range(rows)]
+
+def act(vals, table):
+    shift = 8 + 3 - ACT_INT_BITS
+    mask = 0x7FF >> ACT_INT_BITS
+    out = []
+    for v in vals:
+        idx = v >> shift
+        frac = v & mask
+        a = table[idx & 0xFF]
+        if idx != 0x7F:
+            b = table[(idx + 1) & 0xFF]
+            out.append(((mask + 1 - frac) * a + b * frac) >> shift)
+        else:
+            out.append(a)
+    return out
+
+def fixed_step(q, tables, h, xq):
+    H = q["H"]
+    L = q["layers"]
+    g = fc(h + [xq], L["rec"]["w"], L["rec"]["b"], 3 * H, L["rec"]["bias_shift"], L["rec"]["out_shift"])
+    c = fc([xq], L["in"]["w"], L["in"]["b"], H, L["in"]["bias_shift"], L["in"]["out_shift"])
+    rz = act(g[:2 * H], tables["sigmoidTable_q15"])
+    c = [sat16(c[i] + sat16((rz[i] * g[2 * H + i] + (1 << 14)) >> 15)) for i in range(H)]
+    n = act(c, tables["tanhTable_q15"])
+    h = [sat16(n[i] + ((rz[H + i] * (h[i] - n[i]) + (1 << 14)) >> 15)) for i in range(H)]
+    y = fc(h, L["out"]["w"], L["out"]["b"], 1, L["out"]["bias_shift"], L["out"]["out_shift"])[0]
+    if q["skip"]:
+        y = sat16(y + xq)
+    return h, y
+
+def to_q15(x):
+    x = struct.unpack("f", struct.pack("f", x))[0]  # the target converts float samples
+    x = max(-1.0, min(32767.0 / 32768.0, x))
+    return int(x * 32768.0)
+
+def test_signal(seconds, fs=48000):
+    """Plucked low E power chord at rising levels, 0.25 s per note."""
+    sig = []
+    note = int(0.25 * fs)
+    levels = (0.05, 0.2, 0.5, 1.0)
+    for k in range(int(seconds * fs)):
+        t = (k % note) / fs
+        lvl = levels[(k // note) % len(levels)]
+        v = math.sin(2 * math.pi * 82.41 * t) + 0.7 * math.sin(2 * math.pi * 123.47 * t) + 0.3 * math.sin(2 * math.pi * 164.81 * t)
+        sig.append(lvl * 0.5 * v * math.exp(-6.0 * t))
+    return sig
+
+def report(m, q, seconds):
+    H = q["H"]
+    macs = 3 * H * (H + 1) + H + H
+    elem = 3 * H + 2 * H   # activation lookups + gate arithmetic per sample
+    # Cortex-M4: ~1.5 cycles per MAC in the SMLAD loops (q15 weights), ~12 per element op
+    est = int(macs * (1.5 if q["bits"] == 16 else 1.75) + 12 * elem + 150)
+    print("GRU hidden %d, int%d weights, blob %d bytes" % (H, q["bits"], len(blob_bytes(q))))
+    print("MACs/sample %d, MACs/block(32) %d" % (macs, 32 * macs))
+    print("est. cycles/sample %d (%.1f%% of a 180 MHz core at 48 kHz per channel)"
+          % (est, 100.0 * est * 48000 / 180e6))
+
+    tables = load_tables(NNTABLES)
+    hf = [0.0] * H
+    hq = [0] * H
+    err_max = err_sq = sig_sq = 0.0
+    for x in test_signal(seconds):
+        xq = to_q15(x)
+        hf, yf = float_step(m, hf, x)
+        hq, yq = fixed_step(q, tables, hq, xq)
+        e = yq / 32768.0 - max(-1.0, min(1.0, yf))
+        err_max = max(err_max, abs(e))
+        err_sq += e * e
+        sig_sq += yf * yf
+    n = int(seconds * 48000)
+    snr = 10.0 * math.log10(sig_sq / max(err_sq, 1e-30))
+    print("error vs float model over %.2f s: max %.2e, rms %.2e, SNR %.1f dB"
+          % (seconds, err_max, math.sqrt(err_sq / n), snr))
+
+# ---------- Output ----------
+
+def blob_bytes(q):
+    H = q["H"]
+    L = q["layers"]
+    fmt = "<%dh" if q["bits"] == 16 else "<%db"
+    data = struct.pack("<II", MAGIC, 0)
+    data += struct.pack("<8B", H, q["bits"], ACT_INT_BITS, q["skip"],
+                        L["rec"]["bias_shift"], L["rec"]["out_shift"],
+                        L["in"]["bias_shift"], L["in"]["out_shift"])
+    data += struct.pack("<4B", L["out"]["bias_shift"], L["out"]["out_shift"], 0, 0)
+    for arr in (L["rec"]["w"], L["rec"]["b"], L["in"]["w"], L["in"]["b"], L["out"]["w"], L["out"]["b"]):
+        data += struct.pack(fmt % len(arr), *arr)
+        data += b"\0" * (-len(data) % 4)
+    return data[:4] + struct.pack("<I", len(data)) + data[8:]
+
+def write_files(out_dir, blob, desc):
+    with open(os.path.join(out_dir, "neural_amp_model.h"), "w") as out:
+        out.write("/* Generated by tools/gen_neural_amp.py, do not edit */\n")
+        out.write("#ifndef NEURAL_AMP_MODEL_H\n#define NEURAL_AMP_MODEL_H\n\n#include <stdint.h>\n\n")
+        out.write("// %s\n" % desc)
+        out.write("extern const uint8_t neural_amp_model[%d];\n\n" % len(blob))
+        out.write("#endif // NEURAL_AMP_MODEL_H\n")
+    with open(os.path.join(out_dir, "neural_amp_model.c"), "w") as out:
+        out.write("/* Generated by tools/gen_neural_amp.py, do not edit */\n")
+        out.write('#include "neural_amp_model.h"\n\n')
+        out.write("__attribute__((aligned(4))) const uint8_t neural_amp_model[%d] = {\n" % len(blob))
+        for i in range(0, len(blob), 16):
+            out.write("    " + ", ".join("0x%02x" % b for b in blob[i:i + 16]) + ",\n")
+        out.write("};\n")
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--out", help="output directory for neural_amp_model.c/.h")
+    ap.add_argument("--model", help="GRU model JSON, default: built-in demo model")
+    ap.add_argument("--hidden", type=int, default=12, help="hidden size of the demo model")
+    ap.add_argument("--bits", type=int, choices=(8, 16), default=16, help="weight width")
+    ap.add_argument("--bin", help="also write the raw blob, e.g. for a separate flash sector")
+    ap.add_argument("--report", action="store_true", help="print MACs, cycle estimate and error")
+    ap.add_argument("--seconds", type=float, default=0.5, help="test signal length for --report")
+    args = ap.parse_args()
+
+    m = load_model(args.model) if args.model else demo_model(args.hidden)
+    if not 1 <= m["H"] <= 16:
+        raise SystemExit("hidden size %d not supported (1..16)" % m["H"])
+    q = quantize(m, args.bits)
+    blob = blob_bytes(q)
+    desc = "%s, GRU hidden %d, int%d weights" % (os.path.basename(args.model) if args.model else "demo model",
+                                                 m["H"], args.bits)
+    if args.out:
+        os.makedirs(args.out, exist_ok=True)
+        write_files(args.out, blob, desc)
+    if args.bin:
+        with open(args.bin, "wb") as f:
+            f.write(blob)
+    if args.report:
+        report(m, q, args.seconds)
+
+if __name__ == "__main__":
+    main()
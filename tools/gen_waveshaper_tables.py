@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Generate the waveshaper lookup tables at build time: waveshaper_tables.h (the
+WS_Curve_t enum) and waveshaper_tables.c (the tables), both written into --out.
+
+Built-in curves are listed in CURVES. Extra curves can be passed as text files
+holding "x y" pairs (one per line, '#' comments allowed); they are resampled onto
+the table grid with linear interpolation and named after the file.
+
+Each table covers [-x_max, x_max] with `segments` uniform steps plus one guard
+point on each side for cubic interpolation. Inputs outside the range clamp.
+"""
+import argparse
+import math
+import os
+import re
+
+# ---------- Built-in curves ----------
+
+def diode_clipper(x):
+    """Shunt diode pair behind a series resistor: (x - v)/R = 2 Is sinh(v/Vt)."""
+    R, Is, Vt = 2.2e3, 2.52e-9, 1.752 * 25.85e-3  # 1N4148, ideality factor folded into Vt
+    v = 0.0
+    for _ in range(100):  # Newton on g(v) = (x - v)/R - 2 Is sinh(v/Vt)
+        s = 2.0 * Is * math.sinh(v / Vt)
+        g = (x - v) / R - s
+        dg = -1.0 / R - 2.0 * Is * math.cosh(v / Vt) / Vt
+        step = g / dg
+        v -= max(-0.05, min(0.05, step))
+        if abs(step) < 1e-12:
+            break
+    return v
+
+DIODE_NORM = diode_clipper(16.0)
+TUBE_BIAS = 0.3
+
+CURVES = [
+    # name, f(x), x_max, segments
+    ("TANH",   math.tanh, 8.0, 512),
+    ("ARCTAN", lambda x: 2.0 / math.pi * math.atan(x), 32.0, 2048),
+    ("DIODE",  lambda x: diode_clipper(x) / DIODE_NORM, 16.0, 1024),
+    # Biased tanh: positive half clips earlier and softer than the negative one
+    ("TUBE",   lambda x: (math.tanh(x + TUBE_BIAS) - math.tanh(TUBE_BIAS)) / (1.0 + math.tanh(TUBE_BIAS)), 8.0, 512),
+]
+
+USER_SEGMENTS = 512
+
+# ---------- User curves ----------
+
+def load_user_curve(path):
+    pts = []
+    with open(path) as f:
+        for line in f:
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            x, y = (float(v) for v in re.split(r'[\s,;]+', line)[:2])
+            pts.append((x, y))
+    if len(pts) < 2:
+        raise SystemExit("%s: need at least two points" % path)
+    pts.sort()
+
+    def f(x):
+        if x <= pts[0][0]:
+            return pts[0][1]
+        if x >= pts[-1][0]:
+            return pts[-1][1]
+        for (x0, y0), (x1, y1) in zip(pts, pts[1:]):
+            if x0 <= x <= x1:
+                return y0 + (y1 - y0) * (x - x0) / (x1 - x0) if x1 > x0 else y0
+        return pts[-1][1]
+
+    x_max = max(abs(pts[0][0]), abs(pts[-1][0]))
+    name = re.sub(r'[^A-Za-z0-9]', '_', os.path.splitext(os.path.basename(path))[0]).upper()
+    return (name, f, x_max, USER_SEGMENTS)
+
+# ---------- Output ----------
+
+def table_values(f, x_max, segments):
+    h = 2.0 * x_max / segments
+    # one guard point beyond each end for the cubic interpolator
+    return [f(-x_max + k * h) for k in range(-1, segments + 2)]
+
+def write_header(path, curves):
+    with open(path, 'w') as out:
+        out.write("/* Generated by tools/gen_waveshaper_tables.py, do not edit */\n")
+        out.write("#ifndef WAVESHAPER_TABLES_H\n#define WAVESHAPER_TABLES_H\n\n")
+        out.write("typedef enum {\n")
+        for name, _, _, _ in curves:
+            out.write("    WS_CURVE_%s,\n" % name)
+        out.write("    WS_CURVE_COUNT\n} WS_Curve_t;\n\n")
+        out.write("#endif // WAVESHAPER_TABLES_H\n")
+
+def write_source(path, curves):
+    with open(path, 'w') as out:
+        out.write("/* Generated by tools/gen_waveshaper_tables.py, do not edit */\n")
+        out.write('#include "waveshaper.h"\n\n')
+        for name, f, x_max, segments in curves:
+            vals = table_values(f, x_max, segments)
+            out.write("static const float ws_%s[%d] = {\n" % (name.lower(), len(vals)))
+            for i in range(0, len(vals), 6):
+                out.write("    " + ", ".join("%.9ef" % v for v in vals[i:i + 6]) + ",\n")
+            out.write("};\n\n")
+        out.write("const WS_Table_t ws_tables[WS_CURVE_COUNT] = {\n")
+        for name, _, x_max, segments in curves:
+            out.write("    {ws_%s, %du, %.9ef, %.9ef},\n"
+                      % (name.lower(), segments, x_max, segments / (2.0 * x_max)))
+        out.write("};\n")
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__)
+    ap.add_argument("--out", required=True, help="output directory")
+    ap.add_argument("user_curves", nargs="*", help="text files with 'x y' pairs")
+    args = ap.parse_args()
+
+    curves = CURVES + [load_user_curve(p) for p in args.user_curves]
+    os.makedirs(args.out, exist_ok=True)
+    write_header(os.path.join(args.out, "waveshaper_tables.h"), curves)
+    write_source(os.path.join(args.out, "waveshaper_tables.c"), curves)
+
+if __name__ == "__main__":
+    main()
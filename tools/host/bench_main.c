@@ -0,0 +1,7 @@
+#include "audio_processing.h"
+
+// audio_InitFX runs every enabled bench first (DSP_BENCH_ENABLE), then the chain bench
+int main(void) {
+    audio_InitFX();
+    return 0;
+}
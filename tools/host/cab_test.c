@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "cabsim.h"
+
+/*Cabinet convolver against direct convolution (in double) at every supported partition
+size, delayed by the latency of each. Two channels share one IR as in the firmware; the
+background variant is drained after every block. Errors are relative to the peak of the
+reference, each partition size has its own tolerance.*/
+
+#define N BLOCK_SIZE_FLOAT
+#define LEN (4 * CAB_IR_MAX)    // samples per run, several frames past the IR at every size
+#define CAB_IR_MAX 4096         // the CAB_IR_TAPS range is 1024..4096
+
+// Measured 1.6..3.1e-7 at every size (a few float roundings), -120 dB allowed
+static const struct { uint32_t part; float tol; } cab_cfg[] = {
+    {64, 1e-6f}, {128, 1e-6f}, {256, 1e-6f}, {512, 1e-6f},
+};
+
+static int failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: ", __func__, __LINE__); \
+        printf(__VA_ARGS__); \
+        putchar('\n'); \
+        failures++; \
+    } \
+} while (0)
+
+static float noise(uint32_t* seed) {
+    *seed = *seed * 196314165u + 907633515u;
+    return (float)(int32_t)*seed * (1.0f / 2147483648.0f);
+}
+
+// Decaying noise, peak around 1 like the built-in response
+static void make_ir(float* h, uint32_t taps) {
+    uint32_t seed = 12345;
+    for (uint32_t k = 0; k < taps; k++) h[k] = noise(&seed) * expf(-4.0f * (float)k / taps);
+}
+
+// Direct convolution of 'in' with h in double, LEN samples, 'delay' samples late
+static void direct(const float* h, uint32_t taps, const float* in, double* ref, uint32_t delay) {
+    memset(ref, 0, LEN * sizeof(double));
+    for (uint32_t j = 0; j + delay < LEN; j++) {
+        if (in[j] == 0.0f) continue;
+        for (uint32_t k = 0; k < taps && j + delay + k < LEN; k++) ref[j + delay + k] += (double)in[j] * h[k];
+    }
+}
+
+// Worst |output - ref| of one channel over LEN samples, relative to the peak of ref
+static float run(CabSim_t* cab, const float* in, const double* ref) {
+    float out[N], err = 0.0f;
+    double peak = 0.0;
+    for (uint32_t i = 0; i < LEN; i++) {
+        if (fabs(ref[i]) > peak) peak = fabs(ref[i]);
+    }
+    for (uint32_t b = 0; b < LEN / N; b++) {
+        CabSim_ProcessBlock(cab, &in[b * N], out, N);
+        while (CabSim_BackgroundStep(cab)) {}
+        for (uint32_t i = 0; i < N; i++) {
+            float e = (float)fabs(out[i] - ref[b * N + i]);
+            if (e > err) err = e;
+        }
+    }
+    return err / (float)peak;
+}
+
+/*Impulse pair on the left channel and noise on the right, both through one IR; then the
+background variant on the noise*/
+static void test_partitions(uint32_t taps) {
+    float* h = malloc(taps * sizeof(float));
+    float* imp = calloc(LEN, sizeof(float));
+    float* nse = malloc(LEN * sizeof(float));
+    double* ref = malloc(LEN * sizeof(double));
+    uint32_t seed = 1;
+    make_ir(h, taps);
+    for (uint32_t i = 0; i < LEN; i++) nse[i] = 0.5f * noise(&seed);
+
+    for (uint32_t c = 0; c < sizeof(cab_cfg) / sizeof(cab_cfg[0]); c++) {
+        const uint32_t P = cab_cfg[c].part;
+        const uint32_t d = 3 * P + 37;
+        CabIR_t ir;
+        CabSim_t left, right, bg;
+        float* spectra = malloc(CAB_IR_SIZE(taps, P) * sizeof(float));
+        float* mem = malloc((2 * CAB_CHANNEL_SIZE(taps, P) + CAB_BACKGROUND_SIZE(taps, P)) * sizeof(float));
+
+        CHECK(CabIR_Init(&ir, spectra, P, h, taps, 1.0f), "P%u: init failed", P);
+        CabSim_Init(&left, &ir, mem);
+        CabSim_Init(&right, &ir, mem + CAB_CHANNEL_SIZE(taps, P));
+        CabSim_InitBackground(&bg, &ir, mem + 2 * CAB_CHANNEL_SIZE(taps, P));
+
+        memset(imp, 0, LEN * sizeof(float));
+        imp[0] = 1.0f;
+        imp[d] = 0.5f;
+        direct(h, taps, imp, ref, P - N);
+        float err_imp = run(&left, imp, ref);
+        direct(h, taps, nse, ref, P - N);
+        float err_nse = run(&right, nse, ref);
+        direct(h, taps, nse, ref, 2 * P - N);
+        float err_bg = run(&bg, nse, ref);
+
+        CHECK(err_imp < cab_cfg[c].tol, "%u taps P%u impulses: err %g", taps, P, err_imp);
+        CHECK(err_nse < cab_cfg[c].tol, "%u taps P%u noise: err %g", taps, P, err_nse);
+        CHECK(err_bg < cab_cfg[c].tol, "%u taps P%u background: err %g", taps, P, err_bg);
+        CHECK(bg.overruns == 0, "%u taps P%u background: %u overruns", taps, P, bg.overruns);
+        printf("cab %u taps P%u: err %g / %g / %g (tol %g)\n", taps, P, err_imp, err_nse, err_bg, cab_cfg[c].tol);
+
+        free(mem);
+        free(spectra);
+    }
+    free(ref);
+    free(nse);
+    free(imp);
+    free(h);
+}
+
+int main(void) {
+    test_partitions(1024);
+    test_partitions(CAB_IR_MAX);
+    printf("cab: %d failures\n", failures);
+    return failures ? 1 : 0;
+}
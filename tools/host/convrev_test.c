@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "convreverb.h"
+
+/*Convolution reverb against direct convolution. The background levels are driven the way
+the idle loop drives them on the target, with a budget of work items between two blocks:
+unlimited, the few the schedule needs, and none. The output must match in every case (an
+overrun is finished in the audio path), but only a starved background may overrun.
+
+The audio path is timed too. Each block's time is the fastest of a few identical runs,
+which keeps the host scheduler out of the worst case.*/
+
+#define N BLOCK_SIZE_FLOAT
+#define ERR_MAX 1e-6f           // the IR is normalised to 0.5 energy
+#define UNLIMITED 0xFFFFFFFFu
+#define RUNS 3
+// Audio path bound: a quarter of the block period; the target core is slower than the host
+#define BLOCK_NS (1000000000ull * N / SAMPLE_RATE)
+#define FG_WORST_NS (BLOCK_NS / 4)
+
+static int failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: ", __func__, __LINE__); \
+        printf(__VA_ARGS__); \
+        putchar('\n'); \
+        failures++; \
+    } \
+} while (0)
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static float noise(uint32_t* seed) {
+    *seed = *seed * 1664525u + 1013904223u;
+    return (float)(int32_t)*seed * (0.5f / 2147483648.0f);
+}
+
+typedef struct {
+    float err;          // worst |output - direct|
+    uint32_t overruns;
+} Result_t;
+
+// Direct convolution of 'in' with h, len samples, only over the nonzero input
+static float* direct(const float* h, uint32_t taps, const float* in, uint32_t len) {
+    float* ref = calloc(len, sizeof(float));
+    for (uint32_t j = 0; j < len; j++) {
+        if (in[j] == 0.0f) continue;
+        for (uint32_t k = 0; k < taps && j + k < len; k++) ref[j + k] += in[j] * h[k];
+    }
+    return ref;
+}
+
+/*'in' (len samples) through the reverb fully wet over an IR of 'taps', 'budget' background
+items after each block, against 'ref'. 'fg' holds the fastest time per block over earlier runs.*/
+static Result_t run(const float* h, uint32_t taps, const float* in, const float* ref, uint32_t len,
+                    uint32_t budget, uint64_t* fg) {
+    Result_t res = {0};
+    float* mem = malloc(CONVREV_MEM_SIZE(taps) * sizeof(float));
+    ConvReverb_t* cr = malloc(sizeof(ConvReverb_t));
+    float l[N], r[N];
+
+    if (!ConvReverb_Init(cr, mem, CONVREV_MEM_SIZE(taps), h, taps, 1.0f)) {
+        CHECK(0, "init failed for %u taps", taps);
+        free(cr);
+        free(mem);
+        return res;
+    }
+    for (uint32_t b = 0; b < len / N; b++) {
+        memcpy(l, &in[b * N], sizeof(l));
+        memcpy(r, l, sizeof(r));
+        uint64_t t = now_ns();
+        ConvReverb_ProcessBlock(cr, l, r, N);
+        t = now_ns() - t;
+        if (fg && t < fg[b]) fg[b] = t;
+        for (uint32_t k = 0; k < budget && ConvReverb_Background(cr); k++) {}
+
+        for (uint32_t i = 0; i < N; i++) {
+            float err = fabsf(l[i] - ref[b * N + i]);
+            if (err > res.err) res.err = err;
+        }
+    }
+    res.overruns = ConvReverb_Overruns(cr);
+    free(cr);
+    free(mem);
+    return res;
+}
+
+// Two impulses through the configured IR: every level and the full tail
+static void test_impulses(void) {
+    const uint32_t taps = CONVREV_IR_TAPS, d = 1237;
+    const uint32_t len = ((taps + d) / N + 1) * N;
+    float* h = malloc(taps * sizeof(float));
+    float* in = calloc(len, sizeof(float));
+    uint64_t* fg = malloc(len / N * sizeof(uint64_t));
+    ConvReverb_GenerateIR(h, taps, CONVREV_RT60, 0.5f);
+    in[0] = 1.0f;
+    in[d] = 0.5f;
+    float* ref = direct(h, taps, in, len);
+
+    for (uint32_t b = 0; b < len / N; b++) fg[b] = UINT64_MAX;
+    Result_t res = {0};
+    for (uint32_t k = 0; k < RUNS; k++) {
+        res = run(h, taps, in, ref, len, UNLIMITED, fg);
+    }
+    uint64_t worst = 0;
+    for (uint32_t b = 0; b < len / N; b++) {
+        if (fg[b] > worst) worst = fg[b];
+    }
+    CHECK(res.overruns == 0, "drained background: %u overruns", res.overruns);
+    CHECK(res.err < ERR_MAX, "drained background: err %g", res.err);
+    CHECK(worst < FG_WORST_NS, "worst block %llu ns, bound %llu ns",
+          (unsigned long long)worst, (unsigned long long)FG_WORST_NS);
+    printf("convrev %u taps: err %g, worst block %llu ns (bound %llu)\n", taps, res.err,
+           (unsigned long long)worst, (unsigned long long)FG_WORST_NS);
+
+    /* The schedule: level 1 needs M1 + 2 items per P1 / N blocks, level 2 M2 + 2 per P2 / N.
+    At 1 s of IR that is 1 + 47 / 32 per block, so 3 items keep both levels ahead. */
+    res = run(h, taps, in, ref, len, 3, NULL);
+    CHECK(res.overruns == 0, "3 items per block: %u overruns", res.overruns);
+    CHECK(res.err < ERR_MAX, "3 items per block: err %g", res.err);
+
+    // No idle time at all: every frame overruns and is finished in the audio path
+    res = run(h, taps, in, ref, len, 0, NULL);
+    CHECK(res.overruns > 0, "starved background did not overrun");
+    CHECK(res.err < ERR_MAX, "starved background: err %g", res.err);
+
+    free(fg);
+    free(ref);
+    free(in);
+    free(h);
+}
+
+// Noise through a shorter IR that still reaches the last level
+static void test_noise(void) {
+    const uint32_t taps = 2 * CONVREV_P2 + 3 * CONVREV_P1 + 5;
+    const uint32_t len = 8 * CONVREV_P2;
+    float* h = malloc(taps * sizeof(float));
+    float* in = malloc(len * sizeof(float));
+    uint32_t seed = 1;
+    ConvReverb_GenerateIR(h, taps, 0.1f, 0.5f);
+    for (uint32_t i = 0; i < len; i++) in[i] = noise(&seed);
+    float* ref = direct(h, taps, in, len);
+
+    Result_t res = run(h, taps, in, ref, len, 3, NULL);
+    CHECK(res.overruns == 0, "noise: %u overruns", res.overruns);
+    CHECK(res.err < ERR_MAX, "noise: err %g", res.err);
+
+    free(ref);
+    free(in);
+    free(h);
+}
+
+int main(void) {
+    test_impulses();
+    test_noise();
+    printf("convrev: %d failures\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,11 @@
+#ifndef HOST_COMPAT_H
+#define HOST_COMPAT_H
+
+/*Forced include for the host build: what cmsis_compiler.h provides on the target but
+arm_math.h leaves out under __GNUC_PYTHON__*/
+
+#ifndef __COMPILER_BARRIER
+#define __COMPILER_BARRIER() __asm__ volatile("" ::: "memory")
+#endif
+
+#endif // HOST_COMPAT_H
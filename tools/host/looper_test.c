@@ -0,0 +1,331 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "looper.h"
+
+/*Looper state machine on a malloc-backed pool: every pool access goes through the
+callbacks below, so the test sees which blocks are read or written in each call and can
+check the prefetch contract as well as the audio. Loops are recorded from a ramp with a
+distinct value per sample, so a sample off at a boundary shows up as a mismatch.*/
+
+#define N LOOPER_BLOCK
+
+typedef struct {
+    float* mem;
+    uint32_t reads, writes;     // since the last reset_counts
+    uint32_t lastRead;          // offset of the last read
+} TestPool_t;
+
+static int failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: ", __func__, __LINE__); \
+        printf(__VA_ARGS__); \
+        putchar('\n'); \
+        failures++; \
+    } \
+} while (0)
+
+static void pool_read(void* ctx, uint32_t offset, float* dst, uint32_t count) {
+    TestPool_t* p = ctx;
+    memcpy(dst, p->mem + offset, count * sizeof(float));
+    p->reads++;
+    p->lastRead = offset;
+}
+
+static void pool_write(void* ctx, uint32_t offset, const float* src, uint32_t count) {
+    TestPool_t* p = ctx;
+    memcpy(p->mem + offset, src, count * sizeof(float));
+    p->writes++;
+}
+
+static void pool_init(TestPool_t* tp, Looper_Pool_t* pool, uint32_t loopBlocks) {
+    uint32_t size = 2 * loopBlocks * N;
+    memset(tp, 0, sizeof(*tp));
+    tp->mem = calloc(size, sizeof(float));
+    pool->read = pool_read;
+    pool->write = pool_write;
+    pool->ctx = tp;
+    pool->size = size;
+}
+
+static void reset_counts(TestPool_t* tp) {
+    tp->reads = tp->writes = 0;
+}
+
+// Recorded material: (l + r) / 2 of the input, distinct per sample and per take
+static float take(uint32_t t, uint32_t k) {
+    return (float)(t * 100000 + k + 1) * 1e-4f;
+}
+
+static void run_block(Looper_t* lp, float* l, float* r, const float* in) {
+    for (uint32_t i = 0; i < N; i++) {
+        l[i] = in ? in[i] : 0.0f;
+        r[i] = l[i];
+    }
+    Looper_ProcessBlock(lp, l, r, N);
+}
+
+// Records blocks of take t until PLAY closes the loop after 'blocks' blocks
+static void record(Looper_t* lp, uint32_t t, uint32_t blocks) {
+    float l[N], r[N], in[N];
+    Looper_Command(lp, LOOPER_CMD_RECORD);
+    for (uint32_t b = 0; b < blocks; b++) {
+        for (uint32_t i = 0; i < N; i++) in[i] = take(t, b * N + i);
+        run_block(lp, l, r, in);
+    }
+    Looper_Command(lp, LOOPER_CMD_PLAY);
+}
+
+// Plays 'blocks' blocks with silence in and checks the output against expect(k)
+static void expect_loop(Looper_t* lp, uint32_t start, uint32_t blocks, uint32_t loopLen,
+                        float (*expect)(uint32_t), const char* what) {
+    float l[N], r[N];
+    uint32_t bad = 0;
+    for (uint32_t b = 0; b < blocks; b++) {
+        run_block(lp, l, r, NULL);
+        for (uint32_t i = 0; i < N; i++) {
+            uint32_t k = (start + b * N + i) % loopLen;
+            float e = expect(k);
+            if ((l[i] != e || r[i] != e) && bad++ == 0) {
+                CHECK(0, "%s: block %u sample %u: %f, expected %f", what, b, i, l[i], e);
+            }
+        }
+    }
+}
+
+static float take0(uint32_t k) { return take(0, k); }
+static float take01(uint32_t k) { return take(0, k) + take(1, k); }
+
+static void test_record_and_wrap(void) {
+    TestPool_t tp;
+    Looper_Pool_t pool;
+    Looper_t* lp = malloc(sizeof(Looper_t));
+    float l[N], r[N], in[N];
+    pool_init(&tp, &pool, 8);
+    Looper_Init(lp, &pool, 1.0f);
+
+    // PLAY after a single block is held until the prefetch has two blocks to work with
+    Looper_Command(lp, LOOPER_CMD_RECORD);
+    for (uint32_t i = 0; i < N; i++) in[i] = take(0, i);
+    run_block(lp, l, r, in);
+    CHECK(l[0] == in[0], "input not dry while recording");
+    Looper_Command(lp, LOOPER_CMD_PLAY);
+    for (uint32_t i = 0; i < N; i++) in[i] = take(0, N + i);
+    run_block(lp, l, r, in);
+    CHECK(lp->state == LOOPER_RECORD, "PLAY closed a one block loop");
+    CHECK(lp->pending == LOOPER_CMD_PLAY, "PLAY dropped instead of held");
+
+    // Applied on the next block: playback starts at block 0 on the two recorded blocks
+    expect_loop(lp, 0, 2 * 5, 2 * N, take0, "short loop");
+    CHECK(lp->loopBlocks == 2, "loop of %u blocks, expected 2", lp->loopBlocks);
+
+    // A longer take wraps sample-exact as well
+    Looper_Command(lp, LOOPER_CMD_CLEAR);
+    run_block(lp, l, r, NULL);
+    record(lp, 0, 7);
+    expect_loop(lp, 0, 7 * 3, 7 * N, take0, "loop");
+    CHECK(lp->loopBlocks == 7, "loop of %u blocks, expected 7", lp->loopBlocks);
+
+    free(lp);
+    free(tp.mem);
+}
+
+static void test_prefetch(void) {
+    TestPool_t tp;
+    Looper_Pool_t pool;
+    Looper_t* lp = malloc(sizeof(Looper_t));
+    float l[N], r[N];
+    pool_init(&tp, &pool, 8);
+    Looper_Init(lp, &pool, 1.0f);
+    record(lp, 0, 5);
+
+    // Closing the loop reuses the copy of block 0: block 1 is read on the close, block 2
+    // at the end of block 0
+    reset_counts(&tp);
+    run_block(lp, l, r, NULL);
+    CHECK(tp.reads == 2 && tp.lastRead == 2 * N, "close: %u reads, last at block %u",
+          tp.reads, tp.lastRead / N);
+
+    // Steady playback: one read per block, two blocks ahead of the one playing, so a
+    // transfer started in one call has all of the next call to complete
+    for (uint32_t b = 1; b < 12; b++) {
+        reset_counts(&tp);
+        run_block(lp, l, r, NULL);
+        uint32_t want = (b + 2) % 5;
+        CHECK(tp.reads == 1 && tp.writes == 0, "block %u: %u reads, %u writes", b, tp.reads, tp.writes);
+        CHECK(tp.lastRead == want * N, "block %u prefetched block %u, expected %u",
+              b, tp.lastRead / N, want);
+    }
+
+    // STOP rewinds and prefetches, so the restart on PLAY costs no read
+    Looper_Command(lp, LOOPER_CMD_STOP);
+    float in[N];
+    for (uint32_t i = 0; i < N; i++) in[i] = 0.5f;
+    run_block(lp, l, r, in);
+    CHECK(lp->state == LOOPER_STOP && l[0] == 0.5f, "STOP not dry");
+    Looper_Command(lp, LOOPER_CMD_PLAY);
+    reset_counts(&tp);
+    run_block(lp, l, r, NULL);
+    CHECK(tp.reads == 1 && tp.lastRead == 2 * N, "restart: %u reads, last at block %u",
+          tp.reads, tp.lastRead / N);
+    CHECK(l[0] == take(0, 0) && l[N - 1] == take(0, N - 1), "restart not at block 0");
+
+    free(lp);
+    free(tp.mem);
+}
+
+static void test_overdub_undo(void) {
+    TestPool_t tp;
+    Looper_Pool_t pool;
+    Looper_t* lp = malloc(sizeof(Looper_t));
+    float l[N], r[N], in[N];
+    const uint32_t L = 6;
+    pool_init(&tp, &pool, 8);
+    Looper_Init(lp, &pool, 1.0f);
+    record(lp, 0, L);
+
+    // Play two blocks, then overdub a full turn starting from block 2
+    expect_loop(lp, 0, 2, L * N, take0, "before overdub");
+    Looper_Command(lp, LOOPER_CMD_RECORD);
+    for (uint32_t b = 0; b < L; b++) {
+        uint32_t blk = (2 + b) % L;
+        for (uint32_t i = 0; i < N; i++) in[i] = take(1, blk * N + i);
+        run_block(lp, l, r, in);
+        // The previous layer is played under the new one
+        CHECK(l[5] == in[5] + take(0, blk * N + 5), "overdub block %u monitor", b);
+        if (b == 0) CHECK(lp->state == LOOPER_OVERDUB, "not overdubbing");
+    }
+    Looper_Command(lp, LOOPER_CMD_PLAY);
+    expect_loop(lp, 2 * N, 2 * L, L * N, take01, "after overdub");
+
+    // The undo region holds the first take in playback order
+    for (uint32_t k = 0; k < L * N; k++) {
+        if (tp.mem[lp->undoOffset + k] != take(0, k)) {
+            CHECK(0, "undo region sample %u", k);
+            break;
+        }
+    }
+
+    // UNDO is heard on the very next block, while the pool is restored in the background
+    Looper_Command(lp, LOOPER_CMD_UNDO);
+    expect_loop(lp, 2 * N, 1, L * N, take0, "right after undo");
+    CHECK(lp->restoreDone < lp->restoreLen, "restore finished in one block");
+    expect_loop(lp, 3 * N, 2 * L - 1, L * N, take0, "after undo");
+    CHECK(lp->restoreDone == lp->restoreLen, "restore incomplete");
+    for (uint32_t k = 0; k < L * N; k++) {
+        if (tp.mem[k] != take(0, k)) {
+            CHECK(0, "loop region sample %u after restore", k);
+            break;
+        }
+    }
+
+    // Nothing left to undo: a second UNDO keeps the loop
+    Looper_Command(lp, LOOPER_CMD_UNDO);
+    expect_loop(lp, 2 * N, L, L * N, take0, "second undo");
+
+    // Overdub from STOP restarts at block 0 and keeps layering
+    Looper_Command(lp, LOOPER_CMD_STOP);
+    run_block(lp, l, r, NULL);
+    Looper_Command(lp, LOOPER_CMD_RECORD);
+    for (uint32_t b = 0; b < L; b++) {
+        for (uint32_t i = 0; i < N; i++) in[i] = take(1, b * N + i);
+        run_block(lp, l, r, in);
+    }
+    Looper_Command(lp, LOOPER_CMD_PLAY);
+    expect_loop(lp, 0, L, L * N, take01, "overdub from stop");
+
+    // CLEAR empties the loop, the input passes dry
+    Looper_Command(lp, LOOPER_CMD_CLEAR);
+    for (uint32_t i = 0; i < N; i++) in[i] = 0.25f;
+    run_block(lp, l, r, in);
+    CHECK(lp->state == LOOPER_EMPTY && lp->loopBlocks == 0 && l[3] == 0.25f, "CLEAR");
+
+    free(lp);
+    free(tp.mem);
+}
+
+static void test_half_speed(void) {
+    TestPool_t tp;
+    Looper_Pool_t pool;
+    Looper_t* lp = malloc(sizeof(Looper_t));
+    float l[N], r[N], in[N];
+    const uint32_t L = 3, S = L * N;
+    pool_init(&tp, &pool, 4);
+    Looper_Init(lp, &pool, 1.0f);
+    record(lp, 0, L);
+    expect_loop(lp, 0, L, S, take0, "normal speed");
+
+    // Every loop sample spans two output samples, odd ones interpolate, across block
+    // boundaries from the prefetched block and across the loop wrap from block 0
+    Looper_SetHalfSpeed(lp, 1);
+    uint32_t bad = 0;
+    for (uint32_t b = 0; b < 4 * L; b++) {
+        run_block(lp, l, r, NULL);
+        for (uint32_t i = 0; i < N; i++) {
+            uint32_t j = b * N + i;
+            uint32_t k = (j >> 1) % S;
+            float e = take(0, k);
+            if (j & 1) e = 0.5f * (e + take(0, (k + 1) % S));
+            if (l[i] != e && bad++ == 0) {
+                CHECK(0, "half speed output %u: %f, expected %f", j, l[i], e);
+            }
+        }
+    }
+    Looper_SetHalfSpeed(lp, 0);
+    expect_loop(lp, 0, L, S, take0, "back to normal speed");
+
+    // Overdub at half speed averages two input samples into one loop sample
+    Looper_SetHalfSpeed(lp, 1);
+    Looper_Command(lp, LOOPER_CMD_RECORD);
+    for (uint32_t b = 0; b < 2 * L; b++) {
+        for (uint32_t i = 0; i < N; i++) in[i] = take(1, (b * N + i) >> 1);
+        run_block(lp, l, r, in);
+    }
+    Looper_Command(lp, LOOPER_CMD_PLAY);
+    Looper_SetHalfSpeed(lp, 0);
+    expect_loop(lp, 0, L, S, take01, "half speed overdub");
+
+    free(lp);
+    free(tp.mem);
+}
+
+static void test_pool_full(void) {
+    TestPool_t tp;
+    Looper_Pool_t pool;
+    Looper_t* lp = malloc(sizeof(Looper_t));
+    float l[N], r[N], in[N];
+    pool_init(&tp, &pool, 4);
+    Looper_Init(lp, &pool, 1.0f);
+    CHECK(lp->maxBlocks == 4, "%u blocks per region", lp->maxBlocks);
+
+    // Recording closes itself when the loop region is full and plays from block 0
+    Looper_Command(lp, LOOPER_CMD_RECORD);
+    for (uint32_t b = 0; b < 4; b++) {
+        for (uint32_t i = 0; i < N; i++) in[i] = take(0, b * N + i);
+        run_block(lp, l, r, in);
+    }
+    CHECK(lp->state == LOOPER_PLAY && lp->loopBlocks == 4, "pool full: state %d, %u blocks",
+          lp->state, lp->loopBlocks);
+    expect_loop(lp, 0, 8, 4 * N, take0, "pool full loop");
+    for (uint32_t k = 0; k < 4 * N; k++) {
+        if (tp.mem[lp->undoOffset + k] != 0.0f) {
+            CHECK(0, "recording wrote into the undo region at %u", k);
+            break;
+        }
+    }
+
+    free(lp);
+    free(tp.mem);
+}
+
+int main(void) {
+    test_record_and_wrap();
+    test_prefetch();
+    test_overdub_undo();
+    test_half_speed();
+    test_pool_full();
+    printf("looper: %d failures\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "reverb.h"
+
+/*Schroeder reverb with Q15 lines against the same configuration in float. A burst of noise
+goes through both; the decay time is read from the energy drop between two 100 ms windows
+of the tail. The Q15 stores round to nearest, so the decay time must match the float one,
+and truncate near zero, so the tail must fall silent instead of hanging in a limit cycle.
+Runs at the full and half rate, at Schroeder's lengths and at twice them (REVERB_SIZE 2).*/
+
+#define N BLOCK_SIZE_FLOAT
+#define RT60_S REVERB_RT60
+#define RT60_TOL 0.05f          // relative, against the float reverb and against RT60_S
+#define SILENT_S (1.5f * RT60_S) // the Q15 tail must be all zeros by then
+#define ERR_MAX_DB -60.0f       // Q15 against float over the first second, re full scale
+
+static int failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: ", __func__, __LINE__); \
+        printf(__VA_ARGS__); \
+        putchar('\n'); \
+        failures++; \
+    } \
+} while (0)
+
+static float noise(uint32_t* seed) {
+    *seed = *seed * 196314165u + 907633515u;
+    return (float)(int32_t)*seed * (1.0f / 2147483648.0f);
+}
+
+// 60 dB over the drop between two windows 'span' seconds apart
+static float rt60(float e0, float e1, float span) {
+    return 60.0f * span / (10.0f * log10f(e0 / e1));
+}
+
+static void test_q15(float rate, float size) {
+    const uint32_t window = (uint32_t)(0.1f * rate) / N; // blocks
+    const uint32_t w_start = 2, w_end = w_start + (uint32_t)(5.0f * RT60_S);
+    const uint32_t windows = (uint32_t)(10.0f * SILENT_S) + 1;
+    Reverb_Config_t cfg = Reverb_DefaultConfig;
+    Reverb_t* rv = malloc(sizeof(Reverb_t));
+    Reverb_t* rq = malloc(sizeof(Reverb_t));
+    Reverb_Pool_t pool;
+    float l[N], r[N], ql[N], qr[N];
+    uint32_t seed = 1;
+
+    cfg.rate /= size;
+    uint32_t floats = Reverb_PoolSize(&cfg, rate);
+    cfg.q15 = 1;
+    floats += Reverb_PoolSize(&cfg, rate);
+    float* mem = malloc(floats * sizeof(float));
+    Reverb_PoolInit(&pool, mem, floats);
+    cfg.q15 = 0;
+    CHECK(Reverb_Init(rv, &pool, &cfg, rate, RT60_S, 1.0f), "float init");
+    cfg.q15 = 1;
+    CHECK(Reverb_Init(rq, &pool, &cfg, rate, RT60_S, 1.0f), "q15 init");
+
+    float e_float[2] = {0.0f, 0.0f}, e_q15[2] = {0.0f, 0.0f}, err_max = 0.0f;
+    uint32_t silent = 0;
+    for (uint32_t w = 0; w < windows && !silent; w++) {
+        float ef = 0.0f, eq = 0.0f, ee = 0.0f, tail = 0.0f;
+        for (uint32_t b = 0; b < window; b++) {
+            for (uint32_t i = 0; i < N; i++) {
+                l[i] = r[i] = ql[i] = qr[i] = (w == 0) ? 0.25f * noise(&seed) : 0.0f;
+            }
+            Reverb_ProcessBlock(rv, l, r, N);
+            Reverb_ProcessBlock(rq, ql, qr, N);
+            for (uint32_t i = 0; i < N; i++) {
+                ef += l[i] * l[i];
+                eq += ql[i] * ql[i];
+                ee += (l[i] - ql[i]) * (l[i] - ql[i]);
+                tail += fabsf(ql[i]) + fabsf(qr[i]);
+            }
+        }
+        if (w == w_start || w == w_end) {
+            e_float[w == w_end] = ef;
+            e_q15[w == w_end] = eq;
+        }
+        if (w < 10 && ee > err_max) err_max = ee;
+        if (w > 1 && tail == 0.0f) silent = w;
+    }
+
+    const float span = 0.1f * (float)(w_end - w_start);
+    const float rt_float = rt60(e_float[0], e_float[1], span);
+    const float rt_q15 = rt60(e_q15[0], e_q15[1], span);
+    const float err_dB = 10.0f * log10f(err_max / (float)(window * N) + 1e-20f);
+    CHECK(fabsf(rt_float - RT60_S) < RT60_TOL * RT60_S, "%g Hz size %g: float rt60 %.3f s", rate, size, rt_float);
+    CHECK(fabsf(rt_q15 - rt_float) < RT60_TOL * rt_float, "%g Hz size %g: q15 rt60 %.3f s, float %.3f s",
+          rate, size, rt_q15, rt_float);
+    CHECK(err_dB < ERR_MAX_DB, "%g Hz size %g: q15 err %.1f dB FS", rate, size, err_dB);
+    CHECK(silent != 0, "%g Hz size %g: q15 tail not silent after %.1f s", rate, size, 0.1f * (float)windows);
+    printf("reverb %g Hz size %g: rt60 %.3f / %.3f s, err %.1f dB FS, q15 silent after %u ms\n",
+           rate, size, rt_float, rt_q15, err_dB, silent * 100u);
+
+    free(mem);
+    free(rq);
+    free(rv);
+}
+
+int main(void) {
+    test_q15((float)SAMPLE_RATE, 1.0f);
+    test_q15((float)SAMPLE_RATE, 2.0f);
+    test_q15(0.5f * (float)SAMPLE_RATE, 1.0f);
+    test_q15(0.5f * (float)SAMPLE_RATE, 2.0f);
+    printf("reverb: %d failures\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,34 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <time.h>
+#include "SEGGER_SYSVIEW.h"
+
+/*SystemView on the host: printf to stdout, events dropped, and a nanosecond clock in
+place of the DWT cycle counter*/
+
+void SEGGER_SYSVIEW_PrintfHost(const char* s, ...) {
+    va_list args;
+    va_start(args, s);
+    vprintf(s, args);
+    va_end(args);
+    putchar('\n');
+}
+
+void SEGGER_SYSVIEW_Print(const char* s) {
+    puts(s);
+}
+
+void SEGGER_SYSVIEW_RecordVoid(unsigned int EventId) {
+    (void)EventId;
+}
+
+void SEGGER_SYSVIEW_RecordEndCall(unsigned int EventID) {
+    (void)EventID;
+}
+
+U32 SEGGER_SYSVIEW_X_GetTimestamp(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (U32)((uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec);
+}